@@ -0,0 +1,111 @@
+#include "affinitydialog.h"
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QGridLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QScrollArea>
+#include <QVBoxLayout>
+
+AffinityDialog::AffinityDialog(const CpuTopology &topology, const QString &processName,
+                               const QVector<int> &currentCpus, QWidget *parent) : QDialog(parent),
+    presets(topology.presets()),
+    presetSelect(nullptr),
+    descendantsBox(nullptr)
+{
+    setWindowTitle("Set Affinity");
+    setMinimumWidth(420);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(10);
+
+    QLabel *headerLabel = new QLabel(QString("Which CPUs may '%1' run on?").arg(processName));
+    headerLabel->setStyleSheet("font-weight: bold; color: #fff;");
+    mainLayout->addWidget(headerLabel);
+
+    presetSelect = new QComboBox();
+    presetSelect->addItem("Custom");
+    for (const AffinityPreset &preset : presets) {
+        presetSelect->addItem(QString("%1 (%2)").arg(preset.name, CpuTopology::formatCpuList(preset.cpus)));
+    }
+    mainLayout->addWidget(presetSelect);
+
+    // One checkbox per logical CPU, one row per package
+    QWidget *gridContent = new QWidget();
+    QGridLayout *grid = new QGridLayout(gridContent);
+    grid->setSpacing(4);
+    QVector<int> columnOfPackage(qMax(1, topology.packageCount() + 1), 0);
+    for (const LogicalCpu &logical : topology.cpus()) {
+        QCheckBox *box = new QCheckBox(QString::number(logical.cpu));
+        box->setToolTip(topology.describe(logical.cpu));
+        box->setChecked(currentCpus.isEmpty() || currentCpus.contains(logical.cpu));
+        if (!logical.primaryThread) {
+            box->setStyleSheet("color: #b0b0b0;");
+        }
+        int package = qBound(0, logical.package, columnOfPackage.size() - 1);
+        int column = columnOfPackage[package]++;
+        grid->addWidget(box, package * 64 + column / 8, column % 8);
+        connect(box, &QCheckBox::toggled, this, [this]() {
+            presetSelect->blockSignals(true);
+            presetSelect->setCurrentIndex(0);
+            presetSelect->blockSignals(false);
+        });
+        cpuBoxes.append(box);
+        cpuIds.append(logical.cpu);
+    }
+    QScrollArea *scrollArea = new QScrollArea();
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setMaximumHeight(260);
+    scrollArea->setWidget(gridContent);
+    mainLayout->addWidget(scrollArea);
+
+    descendantsBox = new QCheckBox("Also apply to all child processes");
+    mainLayout->addWidget(descendantsBox);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    buttonBox->button(QDialogButtonBox::Ok)->setText("Apply");
+    mainLayout->addWidget(buttonBox);
+
+    connect(presetSelect, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &AffinityDialog::applyPreset);
+    connect(buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    setStyleSheet(R"(
+        QDialog {
+            background-color: #1e1e1e;
+        }
+        QLabel, QCheckBox {
+            color: #ffffff;
+        }
+    )");
+}
+
+void AffinityDialog::applyPreset(int index)
+{
+    if (index <= 0 || index > presets.size()) {
+        return;
+    }
+    const QVector<int> &cpus = presets[index - 1].cpus;
+    for (int i = 0; i < cpuBoxes.size(); ++i) {
+        cpuBoxes[i]->blockSignals(true);
+        cpuBoxes[i]->setChecked(cpus.contains(cpuIds[i]));
+        cpuBoxes[i]->blockSignals(false);
+    }
+}
+
+QVector<int> AffinityDialog::selectedCpus() const
+{
+    QVector<int> cpus;
+    for (int i = 0; i < cpuBoxes.size(); ++i) {
+        if (cpuBoxes[i]->isChecked()) {
+            cpus.append(cpuIds[i]);
+        }
+    }
+    return cpus;
+}
+
+bool AffinityDialog::includeDescendants() const
+{
+    return descendantsBox->isChecked();
+}
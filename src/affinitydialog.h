@@ -0,0 +1,35 @@
+#ifndef AFFINITYDIALOG_H
+#define AFFINITYDIALOG_H
+
+#include <QDialog>
+#include <QVector>
+#include "cputopology.h"
+
+QT_BEGIN_NAMESPACE
+class QCheckBox;
+class QComboBox;
+QT_END_NAMESPACE
+
+// Lets the user pick the CPUs a process (and optionally its descendants)
+// may run on, either one by one or from topology presets
+class AffinityDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    AffinityDialog(const CpuTopology &topology, const QString &processName,
+                   const QVector<int> &currentCpus, QWidget *parent = nullptr);
+
+    QVector<int> selectedCpus() const;
+    bool includeDescendants() const;
+
+private:
+    void applyPreset(int index);
+
+    QVector<AffinityPreset> presets;
+    QVector<QCheckBox*> cpuBoxes;
+    QVector<int> cpuIds;
+    QComboBox *presetSelect;
+    QCheckBox *descendantsBox;
+};
+
+#endif // AFFINITYDIALOG_H
@@ -0,0 +1,90 @@
+#include "alertpanel.h"
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QDateTime>
+
+namespace {
+
+QColor severityColor(const QString &severity)
+{
+    if (severity == "Critical") return QColor("#FF4444");
+    if (severity == "High") return QColor("#FFA500");
+    if (severity == "Medium") return QColor("#FFD700");
+    return QColor("#4CAF50");
+}
+
+} // namespace
+
+AlertPanel::AlertPanel(QWidget *parent) : QWidget(parent),
+    alertTable(nullptr),
+    summaryLabel(nullptr),
+    shownSequence(0)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    summaryLabel = new QLabel("No alerts");
+    summaryLabel->setStyleSheet("color:#b0b0b0;");
+
+    alertTable = new QTableWidget(0, 6);
+    alertTable->setHorizontalHeaderLabels({"Time", "Severity", "Process", "PID", "Alert", "Value"});
+    alertTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    alertTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    alertTable->verticalHeader()->setVisible(false);
+    alertTable->horizontalHeader()->setStretchLastSection(true);
+    alertTable->setMinimumHeight(240);
+    alertTable->setStyleSheet(R"(
+        QTableWidget {
+            background-color: #232323;
+            color: #ffffff;
+            border: 1px solid #3a3a3a;
+            border-radius: 4px;
+            gridline-color: #3a3a3a;
+        }
+        QHeaderView::section {
+            background-color: #2d2d2d;
+            color: #ffffff;
+            padding: 8px;
+            border: 1px solid #3a3a3a;
+            font-weight: bold;
+        }
+    )");
+
+    layout->addWidget(summaryLabel);
+    layout->addWidget(alertTable);
+}
+
+void AlertPanel::updateAlerts(const HealthRuleEngine &engine)
+{
+    quint64 sequence = engine.sequence();
+    summaryLabel->setText(QString("%1 active, %2 alerts since start").arg(engine.activeCount()).arg(sequence));
+    if (sequence == shownSequence) {
+        return;
+    }
+    shownSequence = sequence;
+    const QVector<HealthAlert> alerts = engine.alerts();
+
+    alertTable->setUpdatesEnabled(false);
+    alertTable->setRowCount(alerts.size());
+    for (int row = 0; row < alerts.size(); ++row) {
+        const HealthAlert &alert = alerts[row];
+        QString time = QDateTime::fromMSecsSinceEpoch(alert.timestamp).toString("hh:mm:ss");
+        QString severity = alert.cleared ? "Cleared" : alert.severity;
+        QString title = alert.cleared ? alert.rule + " (cleared)" : alert.rule;
+        QStringList cells = {time, severity, alert.processName,
+                             alert.pid > 0 ? QString::number(alert.pid) : "-", title, alert.detail};
+        for (int column = 0; column < cells.size(); ++column) {
+            QTableWidgetItem *item = alertTable->item(row, column);
+            if (!item) {
+                item = new QTableWidgetItem();
+                alertTable->setItem(row, column, item);
+            }
+            item->setText(cells[column]);
+            item->setToolTip(alert.recommendation);
+            item->setForeground(column == 1 ? severityColor(severity) : QColor("#ffffff"));
+        }
+    }
+    alertTable->setUpdatesEnabled(true);
+}
@@ -0,0 +1,28 @@
+#ifndef ALERTPANEL_H
+#define ALERTPANEL_H
+
+#include <QWidget>
+#include "healthruleengine.h"
+
+QT_BEGIN_NAMESPACE
+class QLabel;
+class QTableWidget;
+QT_END_NAMESPACE
+
+// Troubleshoot view section listing the alert stream, newest first
+class AlertPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit AlertPanel(QWidget *parent = nullptr);
+
+    // Rebuilds the table only when the stream has advanced
+    void updateAlerts(const HealthRuleEngine &engine);
+
+private:
+    QTableWidget *alertTable;
+    QLabel *summaryLabel;
+    quint64 shownSequence;
+};
+
+#endif // ALERTPANEL_H
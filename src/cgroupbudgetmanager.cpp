@@ -0,0 +1,341 @@
+#include "cgroupbudgetmanager.h"
+#include "pressurecollector.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char *const CGROUP2_ROOT = "/sys/fs/cgroup";
+const char *const MANAGED_GROUP_NAME = "procmanager-efficiency";
+const int CPU_PERIOD_US = 100000;
+
+QJsonObject schedulingToJson(const SchedulingInfo &scheduling)
+{
+    QJsonObject object;
+    object.insert("nice", scheduling.nice);
+    object.insert("policy", static_cast<int>(scheduling.policy));
+    object.insert("ioClass", static_cast<int>(scheduling.ioClass));
+    object.insert("ioLevel", scheduling.ioLevel);
+    return object;
+}
+
+SchedulingInfo schedulingFromJson(const QJsonObject &object)
+{
+    SchedulingInfo scheduling;
+    scheduling.valid = true;
+    scheduling.nice = object.value("nice").toInt();
+    scheduling.policy = static_cast<SchedPolicy>(object.value("policy").toInt());
+    scheduling.ioClass = static_cast<IoClass>(object.value("ioClass").toInt());
+    scheduling.ioLevel = object.value("ioLevel").toInt(4);
+    return scheduling;
+}
+
+} // namespace
+
+CgroupBudgetManager::CgroupBudgetManager() :
+    method(Method::None)
+{
+#ifdef Q_OS_LINUX
+    method = setupManagedGroup() ? Method::Cgroup : Method::Nice;
+    journalPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/efficiency-journal.json";
+    // Anything still in the journal was left confined by a previous run
+    loadJournal();
+    if (!journal.isEmpty()) {
+        qWarning() << "Restoring" << journal.size() << "processes left confined by a previous session";
+        releaseAll();
+    }
+    removeStaleGroups();
+#endif
+}
+
+bool CgroupBudgetManager::writeFile(const QString &path, const QByteArray &value)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        return false;
+    }
+    // cgroup files report errors from write(), not open()
+    return file.write(value) == value.size();
+}
+
+quint64 CgroupBudgetManager::readStartTicks(qint64 pid)
+{
+    QFile file(QString("/proc/%1/stat").arg(pid));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    QByteArray stat = file.readAll();
+    // The command name may contain spaces; fields resume after the last ')'
+    int end = stat.lastIndexOf(')');
+    if (end < 0) {
+        return 0;
+    }
+    QList<QByteArray> fields = stat.mid(end + 2).split(' ');
+    // starttime is field 22 overall, the 20th after the command name
+    return fields.size() > 19 ? fields[19].toULongLong() : 0;
+}
+
+bool CgroupBudgetManager::setupManagedGroup()
+{
+#ifdef Q_OS_LINUX
+    if (!QFile::exists(QString("%1/cgroup.controllers").arg(CGROUP2_ROOT))) {
+        return false;
+    }
+    // Create the managed group next to our own; with systemd delegation the
+    // parent of the application scope is usually writable by the user
+    QString ownGroup = PressureCollector::cgroupOfProcess(QCoreApplication::applicationPid());
+    if (ownGroup.isEmpty()) {
+        return false;
+    }
+    QString parent = QString(CGROUP2_ROOT) + ownGroup.left(ownGroup.lastIndexOf('/'));
+    if (::access(QFile::encodeName(parent + "/cgroup.procs").constData(), W_OK) != 0) {
+        return false;
+    }
+
+    QFile controllers(parent + "/cgroup.controllers");
+    if (!controllers.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QByteArray available = controllers.readAll();
+    if (!available.contains("cpu") || !available.contains("memory")) {
+        return false;
+    }
+    // Enabling controllers fails harmlessly if they are already enabled
+    writeFile(parent + "/cgroup.subtree_control", "+cpu +memory");
+
+    groupPath = parent + "/" + MANAGED_GROUP_NAME;
+    if (!QDir().mkpath(groupPath)) {
+        qWarning() << "Failed to create cgroup" << groupPath;
+        return false;
+    }
+    // The managed group holds no processes itself, only the per-process
+    // children the budgets apply to
+    if (!writeFile(groupPath + "/cgroup.subtree_control", "+cpu +memory")) {
+        qWarning() << "Failed to enable cpu and memory controllers in" << groupPath;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+QString CgroupBudgetManager::childGroup(qint64 pid, quint64 startTicks) const
+{
+    // The start time keeps a reused pid from landing in a stale group
+    return QString("%1/%2-%3").arg(groupPath).arg(pid).arg(startTicks);
+}
+
+bool CgroupBudgetManager::applyLimits(const QString &path)
+{
+    QByteArray quota = QByteArray::number(qint64(limits.cpuQuotaPercent) * CPU_PERIOD_US / 100)
+        + " " + QByteArray::number(CPU_PERIOD_US);
+    bool success = writeFile(path + "/cpu.max", quota);
+    success &= writeFile(path + "/cpu.weight", QByteArray::number(qBound(1, limits.cpuWeight, 10000)));
+    success &= writeFile(path + "/memory.high", QByteArray::number(limits.memoryHighMB * 1024 * 1024));
+    if (!success) {
+        qWarning() << "Failed to apply efficiency budget to" << path;
+    }
+    return success;
+}
+
+void CgroupBudgetManager::removeStaleGroups()
+{
+    if (method != Method::Cgroup) {
+        return;
+    }
+    // Children left by a crash; rmdir only succeeds once a group is empty
+    const QStringList children = QDir(groupPath).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &child : children) {
+        QDir(groupPath).rmdir(child);
+    }
+}
+
+void CgroupBudgetManager::setBudget(const EfficiencyBudget &newBudget)
+{
+    limits = newBudget;
+    if (method == Method::Cgroup) {
+        for (auto it = journal.cbegin(); it != journal.cend(); ++it) {
+            applyLimits(childGroup(it.key(), it.value().startTicks));
+        }
+    }
+}
+
+bool CgroupBudgetManager::confine(qint64 pid)
+{
+#ifdef Q_OS_LINUX
+    if (journal.contains(pid)) {
+        return true;
+    }
+    JournalEntry entry;
+    entry.startTicks = readStartTicks(pid);
+    entry.originalScheduling = ProcessScheduling::get(pid);
+    if (entry.startTicks == 0 || !entry.originalScheduling.valid) {
+        return false;
+    }
+    if (method == Method::Cgroup) {
+        entry.originalGroup = PressureCollector::cgroupOfProcess(pid);
+        if (entry.originalGroup.isEmpty()) {
+            return false;
+        }
+    }
+    entry.schedulingChanged = method == Method::Nice;
+    if (entry.schedulingChanged) {
+        // Threads may differ from the main thread, e.g. a nice'd worker pool
+        entry.originalThreads = ProcessScheduling::getThreads(pid);
+    }
+    // Journal first: a crash between the two steps must not lose the origin
+    journal.insert(pid, entry);
+    saveJournal();
+
+    bool success = false;
+    if (method == Method::Cgroup) {
+        const QString child = childGroup(pid, entry.startTicks);
+        success = QDir().mkpath(child) && applyLimits(child) &&
+            writeFile(child + "/cgroup.procs", QByteArray::number(pid));
+        if (!success) {
+            QDir().rmdir(child);
+        }
+    } else {
+        success = ProcessScheduling::setNice(pid, qMax(entry.originalScheduling.nice, limits.fallbackNice));
+    }
+    if (!success) {
+        journal.remove(pid);
+        saveJournal();
+    }
+    return success;
+#else
+    Q_UNUSED(pid);
+    return false;
+#endif
+}
+
+bool CgroupBudgetManager::restore(qint64 pid, const JournalEntry &entry)
+{
+#ifdef Q_OS_LINUX
+    // The child group is removed once empty, whether the process moved
+    // back or exited
+    const QString child = entry.originalGroup.isEmpty() ? QString() : childGroup(pid, entry.startTicks);
+    if (readStartTicks(pid) != entry.startTicks) {
+        // Exited, or the pid now belongs to another process
+        if (!child.isEmpty()) {
+            QDir().rmdir(child);
+        }
+        return true;
+    }
+    bool success = true;
+    if (!entry.originalGroup.isEmpty()) {
+        success = writeFile(QString(CGROUP2_ROOT) + entry.originalGroup + "/cgroup.procs", QByteArray::number(pid));
+        if (success) {
+            QDir().rmdir(child);
+        }
+    }
+    if (entry.schedulingChanged) {
+        // Journals from before per-thread saving only have the main thread
+        success &= entry.originalThreads.isEmpty() ?
+            ProcessScheduling::apply(pid, entry.originalScheduling) :
+            ProcessScheduling::applyThreads(pid, entry.originalThreads, entry.originalScheduling);
+    }
+    return success;
+#else
+    Q_UNUSED(pid);
+    Q_UNUSED(entry);
+    return false;
+#endif
+}
+
+bool CgroupBudgetManager::release(qint64 pid)
+{
+    auto it = journal.find(pid);
+    if (it == journal.end()) {
+        return false;
+    }
+    bool success = restore(pid, it.value());
+    if (!success) {
+        qWarning() << "Failed to restore process" << pid << "to" << it.value().originalGroup;
+    }
+    journal.erase(it);
+    saveJournal();
+    return success;
+}
+
+void CgroupBudgetManager::releaseAll()
+{
+    for (auto it = journal.cbegin(); it != journal.cend(); ++it) {
+        if (!restore(it.key(), it.value())) {
+            qWarning() << "Failed to restore process" << it.key() << "to" << it.value().originalGroup;
+        }
+    }
+    journal.clear();
+    saveJournal();
+}
+
+void CgroupBudgetManager::loadJournal()
+{
+    QFile file(journalPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonArray entries = QJsonDocument::fromJson(file.readAll()).array();
+    for (const QJsonValue &value : entries) {
+        QJsonObject object = value.toObject();
+        JournalEntry entry;
+        entry.startTicks = object.value("startTicks").toString().toULongLong();
+        entry.originalGroup = object.value("group").toString();
+        entry.originalScheduling = schedulingFromJson(object);
+        const QJsonArray threads = object.value("threads").toArray();
+        for (const QJsonValue &thread : threads) {
+            const QJsonObject threadObject = thread.toObject();
+            entry.originalThreads.insert(threadObject.value("tid").toInteger(), schedulingFromJson(threadObject));
+        }
+        // Restoring unchanged values is harmless, skipping changed ones is not
+        entry.schedulingChanged = object.value("schedulingChanged").toBool(true);
+        journal.insert(object.value("pid").toInteger(), entry);
+    }
+}
+
+void CgroupBudgetManager::saveJournal() const
+{
+    if (journalPath.isEmpty()) {
+        return;
+    }
+    if (journal.isEmpty()) {
+        QFile::remove(journalPath);
+        return;
+    }
+    QJsonArray entries;
+    for (auto it = journal.cbegin(); it != journal.cend(); ++it) {
+        QJsonObject object = schedulingToJson(it.value().originalScheduling);
+        object.insert("pid", it.key());
+        object.insert("startTicks", QString::number(it.value().startTicks));
+        object.insert("group", it.value().originalGroup);
+        object.insert("schedulingChanged", it.value().schedulingChanged);
+        QJsonArray threads;
+        for (auto thread = it.value().originalThreads.cbegin(); thread != it.value().originalThreads.cend(); ++thread) {
+            QJsonObject threadObject = schedulingToJson(thread.value());
+            threadObject.insert("tid", thread.key());
+            threads.append(threadObject);
+        }
+        if (!threads.isEmpty()) {
+            object.insert("threads", threads);
+        }
+        entries.append(object);
+    }
+    QDir().mkpath(QFileInfo(journalPath).absolutePath());
+    QFile file(journalPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to write efficiency journal" << journalPath;
+        return;
+    }
+    file.write(QJsonDocument(entries).toJson(QJsonDocument::Compact));
+}
@@ -0,0 +1,74 @@
+#ifndef CGROUPBUDGETMANAGER_H
+#define CGROUPBUDGETMANAGER_H
+
+#include <QHash>
+#include <QString>
+#include "processscheduling.h"
+
+// Limits applied to each process confined by Efficiency mode
+struct EfficiencyBudget {
+    int cpuQuotaPercent = 50;      // cpu.max, in percent of one CPU
+    int cpuWeight = 20;            // cpu.weight (default 100)
+    qint64 memoryHighMB = 512;     // memory.high, reclaim pressure above this
+    int fallbackNice = 10;         // Used when cgroups are not delegated to us
+};
+
+// Moves processes into managed cgroup v2 groups with CPU and memory budgets
+// and returns them exactly where they were on release. Each confined
+// process gets a child group of its own under the managed group, so the
+// budget bounds every noisy process separately; one shared group would
+// squeeze all of them into a single budget and starve the quiet ones.
+// Every change is recorded in a journal on disk first, so processes are
+// restored even if the application exits without disabling Efficiency mode.
+// Without a writable cgroup v2 hierarchy it falls back to nice.
+class CgroupBudgetManager {
+public:
+    enum class Method {
+        None,       // Not supported on this platform
+        Cgroup,
+        Nice
+    };
+
+    CgroupBudgetManager();
+
+    bool isSupported() const { return method != Method::None; }
+    Method activeMethod() const { return method; }
+    QString managedGroup() const { return groupPath; }
+
+    void setBudget(const EfficiencyBudget &newBudget);
+    const EfficiencyBudget& budget() const { return limits; }
+
+    bool confine(qint64 pid);
+    bool release(qint64 pid);
+    void releaseAll();
+    bool isConfined(qint64 pid) const { return journal.contains(pid); }
+    int confinedCount() const { return journal.size(); }
+
+private:
+    struct JournalEntry {
+        quint64 startTicks = 0;   // Guards against pid reuse
+        QString originalGroup;    // Empty when the nice fallback was used
+        SchedulingInfo originalScheduling;    // Of the main thread
+        QHash<qint64, SchedulingInfo> originalThreads;     // By tid, when scheduling changes
+        bool schedulingChanged = false;
+    };
+
+    bool setupManagedGroup();
+    // Child group of the managed group for one process
+    QString childGroup(qint64 pid, quint64 startTicks) const;
+    bool applyLimits(const QString &path);
+    void removeStaleGroups();
+    void loadJournal();
+    void saveJournal() const;
+    bool restore(qint64 pid, const JournalEntry &entry);
+    static quint64 readStartTicks(qint64 pid);
+    static bool writeFile(const QString &path, const QByteArray &value);
+
+    Method method;
+    QString groupPath;     // Absolute path of the managed group, the children's parent
+    QString journalPath;
+    EfficiencyBudget limits;
+    QHash<qint64, JournalEntry> journal;
+};
+
+#endif // CGROUPBUDGETMANAGER_H
@@ -0,0 +1,330 @@
+#include "columnkernels.h"
+#include "cpufeatures.h"
+#include <QVector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace columnkernels {
+
+namespace {
+
+const double INF = std::numeric_limits<double>::infinity();
+// One pass over the rows per group; past this, one scalar pass is cheaper
+const int VECTOR_GROUPS = 8;
+
+struct Candidate {
+    double value;
+    int row;
+};
+
+// Larger value first; of equal values, the earlier row
+bool better(const Candidate &a, const Candidate &b)
+{
+    return a.value != b.value ? a.value > b.value : a.row < b.row;
+}
+
+// Min-heap of the k best candidates so far: heap[0] is the worst kept
+void offer(QVector<Candidate> &heap, int k, double value, int row)
+{
+    if (heap.size() < k) {
+        heap.append(Candidate{value, row});
+        std::push_heap(heap.begin(), heap.end(), better);
+    } else if (value > heap[0].value) {
+        std::pop_heap(heap.begin(), heap.end(), better);
+        heap.last() = Candidate{value, row};
+        std::push_heap(heap.begin(), heap.end(), better);
+    }
+}
+
+int finishTopK(QVector<Candidate> &heap, int *rows)
+{
+    std::sort_heap(heap.begin(), heap.end(), better);
+    for (int index = 0; index < heap.size(); ++index) {
+        rows[index] = heap[index].row;
+    }
+    return heap.size();
+}
+
+inline void addToTotals(GroupTotals &totals, double value)
+{
+    totals.sum += value;
+    totals.min = value < totals.min ? value : totals.min;
+    totals.max = value > totals.max ? value : totals.max;
+    ++totals.count;
+}
+
+// Written as the vector min/max instructions behave, NaN included
+inline int binOf(double value, double low, double scale, double top)
+{
+    double position = (value - low) * scale;
+    position = position > 0.0 ? position : 0.0;
+    position = position < top ? position : top;
+    return int(position);
+}
+
+void groupTotalsScalar(const double *values, const qint32 *groups, const quint8 *mask, int count,
+                       int, GroupTotals *totals)
+{
+    for (int row = 0; row < count; ++row) {
+        if (!mask || mask[row]) {
+            addToTotals(totals[groups[row]], values[row]);
+        }
+    }
+}
+
+int topKScalar(const double *values, const quint8 *mask, int count, int k, int *rows)
+{
+    QVector<Candidate> heap;
+    heap.reserve(k);
+    for (int row = 0; row < count; ++row) {
+        if (!mask || mask[row]) {
+            offer(heap, k, values[row], row);
+        }
+    }
+    return finishTopK(heap, rows);
+}
+
+void histogramScalar(const double *values, const quint8 *mask, int count, double low, double scale,
+                     int bins, int *counts)
+{
+    const double top = bins - 1;
+    for (int row = 0; row < count; ++row) {
+        if (!mask || mask[row]) {
+            ++counts[binOf(values[row], low, scale, top)];
+        }
+    }
+}
+
+#if defined(CPU_HAVE_SSE2)
+// Bit per row for rows [row, row + 4) whose mask byte is set
+inline unsigned maskBits(const quint8 *mask, int row)
+{
+    if (!mask) {
+        return 15;
+    }
+    return (mask[row] ? 1u : 0u) | (mask[row + 1] ? 2u : 0u) | (mask[row + 2] ? 4u : 0u) | (mask[row + 3] ? 8u : 0u);
+}
+
+CPU_TARGET_AVX2 void groupTotalsAvx2(const double *values, const qint32 *groups, const quint8 *mask, int count,
+                                     int groupCount, GroupTotals *totals)
+{
+    if (groupCount > VECTOR_GROUPS) {
+        groupTotalsScalar(values, groups, mask, count, groupCount, totals);
+        return;
+    }
+    const int vectorRows = count & ~3;
+    const __m256i zero = _mm256_setzero_si256();
+    for (int group = 0; group < groupCount; ++group) {
+        const __m128i id = _mm_set1_epi32(group);
+        __m256d sum = _mm256_setzero_pd();
+        __m256d low = _mm256_set1_pd(INF);
+        __m256d high = _mm256_set1_pd(-INF);
+        __m256i selectedCount = zero;
+        for (int row = 0; row < vectorRows; row += 4) {
+            // All ones in the 64-bit lanes of rows in this group and selected
+            __m128i ids = _mm_loadu_si128(reinterpret_cast<const __m128i *>(groups + row));
+            __m256i lanes = _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(ids, id));
+            if (mask) {
+                qint32 bytes;
+                std::memcpy(&bytes, mask + row, sizeof(bytes));
+                __m256i selected = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(bytes));
+                lanes = _mm256_andnot_si256(_mm256_cmpeq_epi64(selected, zero), lanes);
+            }
+            const __m256d in = _mm256_castsi256_pd(lanes);
+            const __m256d value = _mm256_loadu_pd(values + row);
+            sum = _mm256_add_pd(sum, _mm256_and_pd(value, in));
+            low = _mm256_min_pd(low, _mm256_blendv_pd(_mm256_set1_pd(INF), value, in));
+            high = _mm256_max_pd(high, _mm256_blendv_pd(_mm256_set1_pd(-INF), value, in));
+            selectedCount = _mm256_sub_epi64(selectedCount, lanes);
+        }
+
+        alignas(32) double sums[4], lows[4], highs[4];
+        alignas(32) qint64 counts[4];
+        _mm256_store_pd(sums, sum);
+        _mm256_store_pd(lows, low);
+        _mm256_store_pd(highs, high);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(counts), selectedCount);
+        GroupTotals &out = totals[group];
+        for (int lane = 0; lane < 4; ++lane) {
+            out.sum += sums[lane];
+            out.min = std::min(out.min, lows[lane]);
+            out.max = std::max(out.max, highs[lane]);
+            out.count += int(counts[lane]);
+        }
+    }
+    for (int row = vectorRows; row < count; ++row) {
+        if (!mask || mask[row]) {
+            addToTotals(totals[groups[row]], values[row]);
+        }
+    }
+}
+
+CPU_TARGET_AVX2 int topKAvx2(const double *values, const quint8 *mask, int count, int k, int *rows)
+{
+    QVector<Candidate> heap;
+    heap.reserve(k);
+    int row = 0;
+    for (; row < count && heap.size() < k; ++row) {
+        if (!mask || mask[row]) {
+            offer(heap, k, values[row], row);
+        }
+    }
+    // Once the heap is full, only values above its worst can enter, and
+    // those are rare: compare four rows at a time against that threshold
+    for (; row + 4 <= count; row += 4) {
+        __m256d above = _mm256_cmp_pd(_mm256_loadu_pd(values + row), _mm256_set1_pd(heap[0].value), _CMP_GT_OQ);
+        unsigned bits = unsigned(_mm256_movemask_pd(above));
+        if (bits) {
+            bits &= maskBits(mask, row);
+        }
+        while (bits) {
+            int lane = cpufeatures::countTrailingZeros(bits);
+            offer(heap, k, values[row + lane], row + lane);
+            bits &= bits - 1;
+        }
+    }
+    for (; row < count; ++row) {
+        if (!mask || mask[row]) {
+            offer(heap, k, values[row], row);
+        }
+    }
+    return finishTopK(heap, rows);
+}
+
+CPU_TARGET_AVX2 void histogramAvx2(const double *values, const quint8 *mask, int count, double low, double scale,
+                                   int bins, int *counts)
+{
+    const double top = bins - 1;
+    const __m256d lowVector = _mm256_set1_pd(low);
+    const __m256d scaleVector = _mm256_set1_pd(scale);
+    const __m256d topVector = _mm256_set1_pd(top);
+    const __m256d zero = _mm256_setzero_pd();
+    alignas(16) qint32 bin[4];
+    int row = 0;
+    for (; row + 4 <= count; row += 4) {
+        __m256d position = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(values + row), lowVector), scaleVector);
+        position = _mm256_min_pd(_mm256_max_pd(position, zero), topVector);
+        _mm_store_si128(reinterpret_cast<__m128i *>(bin), _mm256_cvttpd_epi32(position));
+        for (unsigned bits = maskBits(mask, row); bits; bits &= bits - 1) {
+            ++counts[bin[cpufeatures::countTrailingZeros(bits)]];
+        }
+    }
+    for (; row < count; ++row) {
+        if (!mask || mask[row]) {
+            ++counts[binOf(values[row], low, scale, top)];
+        }
+    }
+}
+#endif
+
+typedef void (*GroupTotalsFunction)(const double *, const qint32 *, const quint8 *, int, int, GroupTotals *);
+typedef int (*TopKFunction)(const double *, const quint8 *, int, int, int *);
+typedef void (*HistogramFunction)(const double *, const quint8 *, int, double, double, int, int *);
+
+struct Kernels {
+    const char *name;
+    GroupTotalsFunction groupTotals;
+    TopKFunction topK;
+    HistogramFunction histogram;
+};
+
+const Kernels SCALAR_KERNELS = {"scalar", groupTotalsScalar, topKScalar, histogramScalar};
+
+Kernels chooseKernels()
+{
+#if defined(CPU_HAVE_SSE2)
+    if (cpufeatures::hasAvx2()) {
+        return Kernels{"avx2", groupTotalsAvx2, topKAvx2, histogramAvx2};
+    }
+#endif
+    return SCALAR_KERNELS;
+}
+
+const Kernels &activeKernels()
+{
+    static const Kernels kernels = chooseKernels();
+    return kernels;
+}
+
+// Argument handling shared by the dispatched and the scalar entry points
+void groupTotalsWith(const Kernels &kernels, const double *values, const qint32 *groups, const quint8 *mask,
+                     int count, int groupCount, GroupTotals *totals)
+{
+    for (int group = 0; group < groupCount; ++group) {
+        totals[group] = GroupTotals{0.0, INF, -INF, 0};
+    }
+    if (count > 0 && groupCount > 0) {
+        kernels.groupTotals(values, groups, mask, count, groupCount, totals);
+    }
+}
+
+int topKWith(const Kernels &kernels, const double *values, const quint8 *mask, int count, int k, int *rows)
+{
+    if (count <= 0 || k <= 0) {
+        return 0;
+    }
+    return kernels.topK(values, mask, count, k, rows);
+}
+
+void histogramWith(const Kernels &kernels, const double *values, const quint8 *mask, int count, double low,
+                   double high, int bins, int *counts)
+{
+    if (bins <= 0) {
+        return;
+    }
+    std::fill(counts, counts + bins, 0);
+    // An empty range puts everything in the first bin
+    const double scale = high > low ? bins / (high - low) : 0.0;
+    if (count > 0) {
+        kernels.histogram(values, mask, count, low, scale, bins, counts);
+    }
+}
+
+} // namespace
+
+void groupTotals(const double *values, const qint32 *groups, const quint8 *mask, int count,
+                 int groupCount, GroupTotals *totals)
+{
+    groupTotalsWith(activeKernels(), values, groups, mask, count, groupCount, totals);
+}
+
+int topK(const double *values, const quint8 *mask, int count, int k, int *rows)
+{
+    return topKWith(activeKernels(), values, mask, count, k, rows);
+}
+
+void histogram(const double *values, const quint8 *mask, int count, double low, double high,
+               int bins, int *counts)
+{
+    histogramWith(activeKernels(), values, mask, count, low, high, bins, counts);
+}
+
+const char *kernelName()
+{
+    return activeKernels().name;
+}
+
+namespace scalar {
+
+void groupTotals(const double *values, const qint32 *groups, const quint8 *mask, int count,
+                 int groupCount, GroupTotals *totals)
+{
+    groupTotalsWith(SCALAR_KERNELS, values, groups, mask, count, groupCount, totals);
+}
+
+int topK(const double *values, const quint8 *mask, int count, int k, int *rows)
+{
+    return topKWith(SCALAR_KERNELS, values, mask, count, k, rows);
+}
+
+void histogram(const double *values, const quint8 *mask, int count, double low, double high,
+               int bins, int *counts)
+{
+    histogramWith(SCALAR_KERNELS, values, mask, count, low, high, bins, counts);
+}
+
+} // namespace scalar
+
+} // namespace columnkernels
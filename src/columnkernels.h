@@ -0,0 +1,51 @@
+#ifndef COLUMNKERNELS_H
+#define COLUMNKERNELS_H
+
+#include <QtGlobal>
+
+// Aggregates over the metric arrays of ProcessColumns. Rows take part when
+// their mask byte is non-zero; a null mask selects every row.
+//
+// Each kernel has an AVX2 version and a scalar one, picked once by what the
+// CPU supports. Both give the same answers (sums up to rounding, since
+// vector lanes add in a different order); columnkernelstest checks that.
+namespace columnkernels {
+
+struct GroupTotals {
+    double sum;
+    double min;         // +inf for an empty group
+    double max;         // -inf for an empty group
+    int count;
+};
+
+// Totals of values per group; groups[row] must be in [0, groupCount) for
+// every selected row. Vectorized up to 8 groups, scalar beyond.
+void groupTotals(const double *values, const qint32 *groups, const quint8 *mask, int count,
+                 int groupCount, GroupTotals *totals);
+
+// Rows of the k largest selected values, largest first, ties in row order.
+// Returns the number of rows written, at most k.
+int topK(const double *values, const quint8 *mask, int count, int k, int *rows);
+
+// Selected values counted into bins of equal width over [low, high);
+// values outside the range count in the first or last bin
+void histogram(const double *values, const quint8 *mask, int count, double low, double high,
+               int bins, int *counts);
+
+// "avx2" or "scalar"
+const char *kernelName();
+
+// The scalar versions whatever the CPU, as the reference for tests
+namespace scalar {
+
+void groupTotals(const double *values, const qint32 *groups, const quint8 *mask, int count,
+                 int groupCount, GroupTotals *totals);
+int topK(const double *values, const quint8 *mask, int count, int k, int *rows);
+void histogram(const double *values, const quint8 *mask, int count, double low, double high,
+               int bins, int *counts);
+
+} // namespace scalar
+
+} // namespace columnkernels
+
+#endif // COLUMNKERNELS_H
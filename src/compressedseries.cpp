@@ -0,0 +1,329 @@
+#include "compressedseries.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const int BLOCK_BITS = CompressedSeries::BLOCK_WORDS * 64;
+
+inline quint64 lowBits(quint64 value, int count)
+{
+    return count >= 64 ? value : value & ((quint64(1) << count) - 1);
+}
+
+inline int leadingZeros(quint64 value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(value);
+#else
+    int count = 0;
+    for (quint64 bit = quint64(1) << 63; bit && !(value & bit); bit >>= 1) count++;
+    return count;
+#endif
+}
+
+inline int trailingZeros(quint64 value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(value);
+#else
+    int count = 0;
+    for (quint64 bit = 1; bit && !(value & bit); bit <<= 1) count++;
+    return count;
+#endif
+}
+
+// Appends bits MSB-first to zeroed words. A write that would not fit sets
+// overflow and is dropped, so callers can roll the whole sample back.
+struct BitWriter {
+    quint64 *data;
+    int bits;
+    bool overflow = false;
+
+    void write(quint64 value, int count)
+    {
+        if (count == 0 || overflow) {
+            return;
+        }
+        if (bits + count > BLOCK_BITS) {
+            overflow = true;
+            return;
+        }
+        value = lowBits(value, count);
+        int index = bits >> 6;
+        int free = 64 - (bits & 63);
+        if (count <= free) {
+            data[index] |= value << (free - count);
+        } else {
+            int over = count - free;
+            data[index] |= value >> over;
+            data[index + 1] |= value << (64 - over);
+        }
+        bits += count;
+    }
+};
+
+} // namespace
+
+CompressedSeries::CompressedSeries(int valueCount) :
+    width(qBound(1, valueCount, MAX_VALUES)),
+    samples(0),
+    lastTime(0)
+{
+}
+
+void CompressedSeries::clear()
+{
+    blocks.clear();
+    encoder = EncoderState();
+    samples = 0;
+    lastTime = 0;
+}
+
+qint64 CompressedSeries::firstTimestamp() const
+{
+    return blocks.isEmpty() ? 0 : blocks.first().firstTime;
+}
+
+qint64 CompressedSeries::memoryBytes() const
+{
+    return qint64(sizeof(*this)) + qint64(blocks.capacity()) * qint64(sizeof(Block));
+}
+
+bool CompressedSeries::append(qint64 timestamp, const double *values)
+{
+    if (samples > 0 && timestamp < lastTime) {
+        return false;
+    }
+    quint64 bits[MAX_VALUES];
+    std::memcpy(bits, values, sizeof(double) * width);
+
+    if (blocks.isEmpty() || !encode(blocks.last(), encoder, timestamp, bits)) {
+        startBlock(timestamp, bits);
+    }
+    samples++;
+    lastTime = timestamp;
+    return true;
+}
+
+void CompressedSeries::startBlock(qint64 timestamp, const quint64 *bits)
+{
+    blocks.append(Block());
+    Block &block = blocks.last();
+    std::memset(&block, 0, sizeof(Block));
+    block.firstTime = timestamp;
+    block.lastTime = timestamp;
+    block.count = 1;
+
+    // The first sample is stored raw so the block decodes on its own
+    BitWriter writer{block.data, 0};
+    writer.write(quint64(timestamp), 64);
+    for (int i = 0; i < width; ++i) {
+        writer.write(bits[i], 64);
+        encoder.value[i] = bits[i];
+        encoder.leading[i] = -1;
+        encoder.trailing[i] = 0;
+    }
+    block.bits = writer.bits;
+    encoder.time = timestamp;
+    encoder.delta = 0;
+}
+
+bool CompressedSeries::encode(Block &block, EncoderState &state, qint64 timestamp, const quint64 *bits) const
+{
+    EncoderState next = state;
+    BitWriter writer{block.data, block.bits};
+
+    // Timestamps: delta of delta, in buckets sized for jittery fixed intervals
+    qint64 delta = timestamp - state.time;
+    qint64 dod = delta - state.delta;
+    if (dod == 0) {
+        writer.write(0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        writer.write(0x2, 2);
+        writer.write(quint64(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+        writer.write(0x6, 3);
+        writer.write(quint64(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        writer.write(0xE, 4);
+        writer.write(quint64(dod + 2047), 12);
+    } else if (dod >= INT32_MIN && dod <= INT32_MAX) {
+        writer.write(0x1E, 5);
+        writer.write(quint64(dod), 32);
+    } else {
+        writer.write(0x1F, 5);
+        writer.write(quint64(dod), 64);
+    }
+    next.time = timestamp;
+    next.delta = delta;
+
+    // Values: XOR with the previous value, reusing the previous window of
+    // meaningful bits when the new one fits inside it
+    for (int i = 0; i < width; ++i) {
+        quint64 xored = bits[i] ^ state.value[i];
+        next.value[i] = bits[i];
+        if (xored == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+        int leading = qMin(leadingZeros(xored), 31);
+        int trailing = trailingZeros(xored);
+        if (state.leading[i] >= 0 && leading >= state.leading[i] && trailing >= state.trailing[i]) {
+            writer.write(0x2, 2);
+            writer.write(xored >> state.trailing[i], 64 - state.leading[i] - state.trailing[i]);
+        } else {
+            int length = 64 - leading - trailing;
+            writer.write(0x3, 2);
+            writer.write(quint64(leading), 5);
+            writer.write(quint64(length - 1), 6);
+            writer.write(xored >> trailing, length);
+            next.leading[i] = leading;
+            next.trailing[i] = trailing;
+        }
+    }
+
+    if (writer.overflow) {
+        // Clear whatever was written past the old end
+        int index = block.bits >> 6;
+        if (index < BLOCK_WORDS) {
+            block.data[index] &= ~lowBits(~quint64(0), 64 - (block.bits & 63));
+            std::fill(block.data + index + 1, block.data + BLOCK_WORDS, quint64(0));
+        }
+        return false;
+    }
+    block.bits = writer.bits;
+    block.count++;
+    block.lastTime = timestamp;
+    state = next;
+    return true;
+}
+
+void CompressedSeries::dropBefore(qint64 timestamp)
+{
+    int drop = 0;
+    while (drop < blocks.size() && blocks[drop].lastTime < timestamp) {
+        samples -= blocks[drop].count;
+        drop++;
+    }
+    if (drop > 0) {
+        blocks.remove(0, drop);
+    }
+}
+
+CompressedSeries::Cursor CompressedSeries::cursor(qint64 from) const
+{
+    Cursor cursor;
+    cursor.series = this;
+    cursor.from = from;
+    // Blocks are in time order, so the first one that can matter is found by bisection
+    auto it = std::lower_bound(blocks.begin(), blocks.end(), from, [](const Block &block, qint64 time) {
+        return block.lastTime < time;
+    });
+    cursor.block = int(it - blocks.begin());
+    return cursor;
+}
+
+quint64 CompressedSeries::Cursor::readBits(int count)
+{
+    if (count == 0) {
+        return 0;
+    }
+    const quint64 *data = series->blocks[block - 1].data;
+    int index = bitPosition >> 6;
+    int offset = bitPosition & 63;
+    int available = 64 - offset;
+    bitPosition += count;
+    if (count <= available) {
+        return (data[index] << offset) >> (64 - count);
+    }
+    int rest = count - available;
+    return (lowBits(data[index], available) << rest) | (data[index + 1] >> (64 - rest));
+}
+
+bool CompressedSeries::Cursor::startBlock()
+{
+    if (!series || block >= series->blocks.size()) {
+        return false;
+    }
+    remaining = series->blocks[block].count;
+    block++;
+    bitPosition = 0;
+    first = true;
+    return remaining > 0;
+}
+
+bool CompressedSeries::Cursor::next(qint64 &timestamp, double *values)
+{
+    const int width = series ? series->width : 0;
+    for (;;) {
+        if (remaining == 0 && !startBlock()) {
+            return false;
+        }
+        remaining--;
+
+        if (first) {
+            first = false;
+            time = qint64(readBits(64));
+            delta = 0;
+            for (int i = 0; i < width; ++i) {
+                value[i] = readBits(64);
+                leading[i] = -1;
+                trailing[i] = 0;
+            }
+        } else {
+            qint64 dod = 0;
+            if (readBits(1) == 0) {
+                dod = 0;
+            } else if (readBits(1) == 0) {
+                dod = qint64(readBits(7)) - 63;
+            } else if (readBits(1) == 0) {
+                dod = qint64(readBits(9)) - 255;
+            } else if (readBits(1) == 0) {
+                dod = qint64(readBits(12)) - 2047;
+            } else if (readBits(1) == 0) {
+                dod = qint64(qint32(quint32(readBits(32))));
+            } else {
+                dod = qint64(readBits(64));
+            }
+            delta += dod;
+            time += delta;
+
+            for (int i = 0; i < width; ++i) {
+                if (readBits(1) == 0) {
+                    continue;
+                }
+                if (readBits(1) == 1) {
+                    leading[i] = int(readBits(5));
+                    int length = int(readBits(6)) + 1;
+                    trailing[i] = 64 - leading[i] - length;
+                }
+                int length = 64 - leading[i] - trailing[i];
+                value[i] ^= readBits(length) << trailing[i];
+            }
+        }
+
+        if (time < from) {
+            continue;
+        }
+        timestamp = time;
+        std::memcpy(values, value, sizeof(double) * width);
+        return true;
+    }
+}
+
+void CompressedSeries::decode(qint64 from, qint64 to, QVector<qint64> &timestamps, QVector<double> &values, int column) const
+{
+    timestamps.clear();
+    values.clear();
+    if (column < 0 || column >= width) {
+        return;
+    }
+    Cursor reader = cursor(from);
+    qint64 timestamp = 0;
+    double sample[MAX_VALUES];
+    while (reader.next(timestamp, sample) && timestamp <= to) {
+        timestamps.append(timestamp);
+        values.append(sample[column]);
+    }
+}
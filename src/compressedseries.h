@@ -0,0 +1,91 @@
+#ifndef COMPRESSEDSERIES_H
+#define COMPRESSEDSERIES_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// Time series compressed Gorilla-style: delta-of-delta timestamps and
+// XOR-encoded doubles, packed MSB-first into fixed-size blocks. Each sample
+// has one timestamp and up to MAX_VALUES values that share it, so columns
+// recorded together (CPU and memory of a process) pay for time once.
+//
+// Every block starts with raw values and can be decoded on its own, which
+// lets windowed reads skip whole blocks and lets retention drop them.
+// Samples that repeat cost about one bit per value plus one for time.
+class CompressedSeries {
+public:
+    static constexpr int MAX_VALUES = 4;
+    static constexpr int BLOCK_WORDS = 32;  // 256 bytes of payload per block
+
+    explicit CompressedSeries(int valueCount = 1);
+
+    // Timestamps must not go backwards; such samples are rejected
+    bool append(qint64 timestamp, const double *values);
+    // Drops whole blocks that end before timestamp
+    void dropBefore(qint64 timestamp);
+    void clear();
+
+    int valueCount() const { return width; }
+    int sampleCount() const { return samples; }
+    bool isEmpty() const { return samples == 0; }
+    qint64 firstTimestamp() const;
+    qint64 lastTimestamp() const { return lastTime; }
+    qint64 memoryBytes() const;
+
+    // Sequential decoder over samples with timestamp >= from
+    class Cursor {
+    public:
+        bool next(qint64 &timestamp, double *values);
+
+    private:
+        friend class CompressedSeries;
+        bool startBlock();
+        quint64 readBits(int count);
+
+        const CompressedSeries *series = nullptr;
+        qint64 from = 0;
+        int block = 0;
+        int remaining = 0;      // Samples left in the current block
+        int bitPosition = 0;
+        bool first = true;
+        qint64 time = 0;
+        qint64 delta = 0;
+        quint64 value[MAX_VALUES] = {};
+        int leading[MAX_VALUES] = {};
+        int trailing[MAX_VALUES] = {};
+    };
+
+    Cursor cursor(qint64 from = 0) const;
+
+    // Decodes [from, to] into parallel arrays, for charting
+    void decode(qint64 from, qint64 to, QVector<qint64> &timestamps, QVector<double> &values, int column = 0) const;
+
+private:
+    struct Block {
+        qint64 firstTime;
+        qint64 lastTime;
+        int count;
+        int bits;
+        quint64 data[BLOCK_WORDS];
+    };
+
+    // Encoder state for the open block, so sealed blocks carry none
+    struct EncoderState {
+        qint64 time = 0;
+        qint64 delta = 0;
+        quint64 value[MAX_VALUES] = {};
+        int leading[MAX_VALUES] = {};
+        int trailing[MAX_VALUES] = {};
+    };
+
+    bool encode(Block &block, EncoderState &state, qint64 timestamp, const quint64 *bits) const;
+    void startBlock(qint64 timestamp, const quint64 *bits);
+
+    QVector<Block> blocks;
+    EncoderState encoder;
+    int width;
+    int samples;
+    qint64 lastTime;
+};
+
+#endif // COMPRESSEDSERIES_H
@@ -0,0 +1,60 @@
+#include "cpuanomalydetector.h"
+#include "processcolumns.h"
+#include "systeminfo.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Scores are zero until the baseline has seen this many samples
+const int WARMUP_SAMPLES = 30;
+// Standard deviation floor in percentage points, so a perfectly flat
+// process does not score a 0.5% blip as an anomaly
+const double MIN_STDDEV = 2.0;
+
+} // namespace
+
+CpuAnomalyDetector::CpuAnomalyDetector()
+{
+    setHalfLifeSamples(200.0);
+}
+
+void CpuAnomalyDetector::setHalfLifeSamples(double halfLife)
+{
+    alpha = 1.0 - std::exp(std::log(0.5) / qMax(1.0, halfLife));
+}
+
+void CpuAnomalyDetector::update(ProcessColumns &columns, QVector<ProcessInfo> &processes)
+{
+    remapColumn(mean, columns.previousRow, 0.0);
+    remapColumn(variance, columns.previousRow, 0.0);
+    remapColumn(samples, columns.previousRow, quint16(0));
+
+    const int rows = columns.rows;
+    const double *cpu = columns.column(ProcessColumns::Cpu);
+    double *score = columns.metrics[ProcessColumns::CpuZScore].data();
+    double *average = mean.data();
+    double *spread = variance.data();
+    quint16 *count = samples.data();
+    const double floorVariance = MIN_STDDEV * MIN_STDDEV;
+
+    // One pass over the CPU column; scores use the baseline before the new
+    // sample is folded in
+    for (int row = 0; row < rows; ++row) {
+        const double deviation = cpu[row] - average[row];
+        const double warm = count[row] >= WARMUP_SAMPLES ? 1.0 : 0.0;
+        score[row] = warm * deviation / std::sqrt(spread[row] + floorVariance);
+
+        // Early samples use a cumulative average so the baseline settles quickly
+        const double weight = std::max(alpha, 1.0 / (count[row] + 1.0));
+        const double increment = weight * deviation;
+        average[row] += increment;
+        spread[row] = (1.0 - weight) * (spread[row] + deviation * increment);
+        count[row] = quint16(std::min(count[row] + 1, 0xffff));
+    }
+
+    for (int row = 0; row < rows; ++row) {
+        processes[row].cpuZScore = score[row];
+        processes[row].cpuBaseline = average[row];
+    }
+}
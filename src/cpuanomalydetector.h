@@ -0,0 +1,30 @@
+#ifndef CPUANOMALYDETECTOR_H
+#define CPUANOMALYDETECTOR_H
+
+#include <QVector>
+
+struct ProcessInfo;
+struct ProcessColumns;
+
+// Tracks an exponentially weighted mean and variance of CPU usage for every
+// process and scores each new sample against that process' own baseline.
+// A process idling at 1% that jumps to 30% scores far higher than a
+// compiler that always runs at 90%.
+class CpuAnomalyDetector {
+public:
+    CpuAnomalyDetector();
+
+    void setHalfLifeSamples(double samples);
+
+    // Scores the CPU column, stores the result in the CpuZScore column and
+    // the cpuZScore/cpuBaseline fields of the matching processes
+    void update(ProcessColumns &columns, QVector<ProcessInfo> &processes);
+
+private:
+    QVector<double> mean;
+    QVector<double> variance;
+    QVector<quint16> samples;
+    double alpha;
+};
+
+#endif // CPUANOMALYDETECTOR_H
@@ -0,0 +1,36 @@
+#include "cpufeatures.h"
+
+namespace cpufeatures {
+
+namespace {
+
+bool detectAvx2()
+{
+#if defined(CPU_HAVE_SSE2)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osXsave = info[2] & (1 << 27);
+    const bool avx = info[2] & (1 << 28);
+    if (osXsave && avx && (_xgetbv(0) & 6) == 6) {
+        __cpuidex(info, 7, 0);
+        return info[1] & (1 << 5);
+    }
+    return false;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+#else
+    return false;
+#endif
+}
+
+} // namespace
+
+bool hasAvx2()
+{
+    static const bool avx2 = detectAvx2();
+    return avx2;
+}
+
+} // namespace cpufeatures
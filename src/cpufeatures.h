@@ -0,0 +1,40 @@
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+// Run-time SIMD selection for kernels that ship a vector and a scalar
+// version. SSE2 is part of every x86-64 target; AVX2 functions are compiled
+// with CPU_TARGET_AVX2 and only called when hasAvx2() says so.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CPU_HAVE_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CPU_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CPU_TARGET_AVX2
+#endif
+
+namespace cpufeatures {
+
+// CPU and OS both support AVX2 (the OS must save the YMM registers)
+bool hasAvx2();
+
+// Index of the lowest set bit; bits must not be zero
+inline int countTrailingZeros(unsigned bits)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return int(index);
+#else
+    return __builtin_ctz(bits);
+#endif
+}
+
+} // namespace cpufeatures
+
+#endif // CPUFEATURES_H
@@ -0,0 +1,136 @@
+#include "cpuheatmapwidget.h"
+#include <QPainter>
+#include <QHelpEvent>
+#include <QToolTip>
+#include <QtMath>
+
+namespace {
+
+const int CELL_SIZE = 22;
+const int CELL_SPACING = 3;
+
+// Same bands as the process table: green, yellow, orange, red
+QColor heatColor(double busy)
+{
+    static const QColor low("#4CAF50");
+    static const QColor moderate("#FFD700");
+    static const QColor medium("#FFA500");
+    static const QColor high("#FF4444");
+    static const QColor idle("#1f3a24");
+    auto mix = [](const QColor &a, const QColor &b, double t) {
+        return QColor::fromRgbF(a.redF() + (b.redF() - a.redF()) * t,
+                                a.greenF() + (b.greenF() - a.greenF()) * t,
+                                a.blueF() + (b.blueF() - a.blueF()) * t);
+    };
+    busy = qBound(0.0, busy, 100.0);
+    if (busy < 20.0) return mix(idle, low, busy / 20.0);
+    if (busy < 50.0) return mix(low, moderate, (busy - 20.0) / 30.0);
+    if (busy < 80.0) return mix(moderate, medium, (busy - 50.0) / 30.0);
+    return mix(medium, high, (busy - 80.0) / 20.0);
+}
+
+} // namespace
+
+CpuHeatmapWidget::CpuHeatmapWidget(QWidget *parent) : QWidget(parent)
+{
+    setMouseTracking(true);
+    QSizePolicy policy(QSizePolicy::Expanding, QSizePolicy::Preferred);
+    policy.setHeightForWidth(true);
+    setSizePolicy(policy);
+}
+
+void CpuHeatmapWidget::setCores(const QVector<CpuCoreStats> &cores)
+{
+    bool countChanged = cores.size() != coreStats.size();
+    coreStats = cores;
+    if (countChanged) {
+        updateGeometry();
+    }
+    update();
+}
+
+int CpuHeatmapWidget::columnCount() const
+{
+    int available = qMax(width(), CELL_SIZE);
+    return qMax(1, (available + CELL_SPACING) / (CELL_SIZE + CELL_SPACING));
+}
+
+QSize CpuHeatmapWidget::sizeHint() const
+{
+    int columns = qMin(32, qMax(1, static_cast<int>(coreStats.size())));
+    int rows = (coreStats.size() + columns - 1) / columns;
+    return QSize(columns * (CELL_SIZE + CELL_SPACING), qMax(1, rows) * (CELL_SIZE + CELL_SPACING));
+}
+
+int CpuHeatmapWidget::heightForWidth(int width) const
+{
+    // Wrap onto more rows when the widget is too narrow for all cores
+    int columns = qMax(1, (qMax(width, CELL_SIZE) + CELL_SPACING) / (CELL_SIZE + CELL_SPACING));
+    int rows = (coreStats.size() + columns - 1) / columns;
+    return qMax(1, rows) * (CELL_SIZE + CELL_SPACING);
+}
+
+QRect CpuHeatmapWidget::cellRect(int index) const
+{
+    int columns = columnCount();
+    int row = index / columns;
+    int column = index % columns;
+    return QRect(column * (CELL_SIZE + CELL_SPACING), row * (CELL_SIZE + CELL_SPACING), CELL_SIZE, CELL_SIZE);
+}
+
+int CpuHeatmapWidget::cellAt(const QPoint &pos) const
+{
+    int columns = columnCount();
+    int column = pos.x() / (CELL_SIZE + CELL_SPACING);
+    int row = pos.y() / (CELL_SIZE + CELL_SPACING);
+    if (column >= columns) return -1;
+    int index = row * columns + column;
+    if (index < 0 || index >= coreStats.size() || !cellRect(index).contains(pos)) return -1;
+    return index;
+}
+
+void CpuHeatmapWidget::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    for (int i = 0; i < coreStats.size(); ++i) {
+        const CpuCoreStats &core = coreStats[i];
+        QRect rect = cellRect(i);
+        painter.fillRect(rect, heatColor(core.busy));
+        if (core.steal > 0.5) {
+            int stealHeight = qMax(2, qCeil(rect.height() * core.steal / 100.0));
+            painter.fillRect(QRect(rect.left(), rect.top(), rect.width(), stealHeight), QColor("#B05CFF"));
+        }
+    }
+}
+
+bool CpuHeatmapWidget::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        QHelpEvent *helpEvent = static_cast<QHelpEvent *>(event);
+        int index = cellAt(helpEvent->pos());
+        if (index < 0) {
+            QToolTip::hideText();
+            event->ignore();
+            return true;
+        }
+        const CpuCoreStats &core = coreStats[index];
+        QString text = QString("CPU %1: %2% busy\n"
+                               "User: %3%  System: %4%\n"
+                               "I/O wait: %5%  IRQ: %6%  SoftIRQ: %7%\n"
+                               "Steal: %8%")
+            .arg(core.cpu)
+            .arg(core.busy, 0, 'f', 1)
+            .arg(core.user, 0, 'f', 1)
+            .arg(core.system, 0, 'f', 1)
+            .arg(core.iowait, 0, 'f', 1)
+            .arg(core.irq, 0, 'f', 1)
+            .arg(core.softirq, 0, 'f', 1)
+            .arg(core.steal, 0, 'f', 1);
+        if (core.frequencyMHz > 0.0) {
+            text += QString("\nFrequency: %1 MHz").arg(core.frequencyMHz, 0, 'f', 0);
+        }
+        QToolTip::showText(helpEvent->globalPos(), text, this);
+        return true;
+    }
+    return QWidget::event(event);
+}
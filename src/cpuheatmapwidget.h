@@ -0,0 +1,33 @@
+#ifndef CPUHEATMAPWIDGET_H
+#define CPUHEATMAPWIDGET_H
+
+#include <QWidget>
+#include <QVector>
+#include "cpustatscollector.h"
+
+// Compact grid with one cell per logical CPU, colored by utilization.
+// A purple bar along the top of a cell shows hypervisor steal time.
+class CpuHeatmapWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit CpuHeatmapWidget(QWidget *parent = nullptr);
+
+    void setCores(const QVector<CpuCoreStats> &cores);
+    QSize sizeHint() const override;
+    bool hasHeightForWidth() const override { return true; }
+    int heightForWidth(int width) const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    QVector<CpuCoreStats> coreStats;
+
+    int columnCount() const;
+    QRect cellRect(int index) const;
+    int cellAt(const QPoint &pos) const;
+};
+
+#endif // CPUHEATMAPWIDGET_H
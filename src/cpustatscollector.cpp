@@ -0,0 +1,220 @@
+#include "cpustatscollector.h"
+#include <QFile>
+#include <QString>
+#include <cstring>
+
+namespace {
+
+const char *const PROC_STAT_PATH = "/proc/stat";
+
+inline const char *parseNumber(const char *p, const char *end, quint64 &value)
+{
+    while (p < end && *p == ' ') ++p;
+    quint64 v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + static_cast<quint64>(*p - '0');
+        ++p;
+    }
+    value = v;
+    return p;
+}
+
+} // namespace
+
+CpuStatsCollector::CpuStatsCollector() :
+    available(QFile::exists(PROC_STAT_PATH)),
+    hasPrevious(false),
+    cpuCount(0),
+    aggregateBusy(0.0),
+    aggregateSteal(0.0)
+{
+    std::memset(previousAggregate, 0, sizeof(previousAggregate));
+    buffer.resize(16 * 1024);
+    freqBuffer.resize(64);
+}
+
+bool CpuStatsCollector::readFile(const char *path, QByteArray &into)
+{
+    QFile file(QString::fromLatin1(path));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        return false;
+    }
+    qint64 length = 0;
+    for (;;) {
+        if (length == into.size()) {
+            into.resize(into.size() * 2);
+        }
+        qint64 n = file.read(into.data() + length, into.size() - length);
+        if (n < 0) return false;
+        if (n == 0) break;
+        length += n;
+    }
+    // Keep the capacity, only shrink the logical size
+    into.truncate(length);
+    return true;
+}
+
+void CpuStatsCollector::resizeFor(int count)
+{
+    cpuCount = count;
+    current.fill(0, FieldCount * count);
+    previous.fill(0, FieldCount * count);
+    delta.fill(0.0, FieldCount * count);
+    total.fill(0.0, count);
+    online.fill(0, count);
+    frequencyMHz.fill(0.0, count);
+    frequencyPaths.resize(count);
+    for (int c = 0; c < count; ++c) {
+        frequencyPaths[c] = "/sys/devices/system/cpu/cpu" + QByteArray::number(c) + "/cpufreq/scaling_cur_freq";
+    }
+    hasPrevious = false;
+}
+
+bool CpuStatsCollector::update()
+{
+    if (!available) {
+        return false;
+    }
+    // Restore capacity that readFile() truncated on the previous tick
+    int capacity = qMax(buffer.capacity(), 16 * 1024);
+    buffer.resize(capacity);
+    if (!readFile(PROC_STAT_PATH, buffer)) {
+        return false;
+    }
+
+    const char *begin = buffer.constData();
+    const char *end = begin + buffer.size();
+
+    // Size the arrays for the highest CPU index present (CPUs can come online)
+    int maxCpu = -1;
+    for (const char *p = begin; p < end && end - p > 4 && std::memcmp(p, "cpu", 3) == 0;) {
+        quint64 cpu = 0;
+        if (p[3] != ' ') {
+            parseNumber(p + 3, end, cpu);
+            maxCpu = qMax(maxCpu, static_cast<int>(cpu));
+        }
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        p = lineEnd ? lineEnd + 1 : end;
+    }
+    if (maxCpu + 1 > cpuCount) {
+        resizeFor(maxCpu + 1);
+    }
+
+    std::swap(current, previous);
+    online.fill(0);
+
+    quint64 aggregate[FieldCount] = {};
+    const char *p = begin;
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        // Per-CPU lines come first; stop at the first non-"cpu" line
+        if (lineEnd - p < 4 || std::memcmp(p, "cpu", 3) != 0) {
+            break;
+        }
+
+        const char *q = p + 3;
+        bool isAggregate = (*q == ' ');
+        quint64 cpu = 0;
+        if (!isAggregate) {
+            q = parseNumber(q, lineEnd, cpu);
+        }
+
+        quint64 values[FieldCount];
+        for (int f = 0; f < FieldCount; ++f) {
+            q = parseNumber(q, lineEnd, values[f]);
+        }
+        if (isAggregate) {
+            std::memcpy(aggregate, values, sizeof(aggregate));
+        } else {
+            for (int f = 0; f < FieldCount; ++f) {
+                current[f * cpuCount + static_cast<int>(cpu)] = values[f];
+            }
+            online[static_cast<int>(cpu)] = 1;
+        }
+        p = lineEnd + 1;
+    }
+
+    if (!hasPrevious) {
+        std::memcpy(previousAggregate, aggregate, sizeof(aggregate));
+        previous = current;
+        hasPrevious = true;
+        return true;
+    }
+
+    // Field-major deltas over contiguous counters; counters that went
+    // backwards (CPU hotplug) count as zero
+    const int n = FieldCount * cpuCount;
+    const quint64 *cur = current.constData();
+    const quint64 *prev = previous.constData();
+    double *d = delta.data();
+    for (int i = 0; i < n; ++i) {
+        d[i] = cur[i] >= prev[i] ? static_cast<double>(cur[i] - prev[i]) : 0.0;
+    }
+
+    double *t = total.data();
+    std::memset(t, 0, sizeof(double) * cpuCount);
+    for (int f = 0; f < FieldCount; ++f) {
+        const double *row = d + f * cpuCount;
+        for (int c = 0; c < cpuCount; ++c) {
+            t[c] += row[c];
+        }
+    }
+    for (int c = 0; c < cpuCount; ++c) {
+        t[c] = t[c] > 0.0 ? 100.0 / t[c] : 0.0;
+    }
+    // delta now holds percentages
+    for (int f = 0; f < FieldCount; ++f) {
+        double *row = d + f * cpuCount;
+        for (int c = 0; c < cpuCount; ++c) {
+            row[c] *= t[c];
+        }
+    }
+
+    readFrequencies();
+
+    coreStats.resize(0);
+    for (int c = 0; c < cpuCount; ++c) {
+        if (!online[c]) continue;
+        CpuCoreStats core;
+        core.cpu = c;
+        core.user = d[User * cpuCount + c] + d[Nice * cpuCount + c];
+        core.system = d[System * cpuCount + c];
+        core.iowait = d[IoWait * cpuCount + c];
+        core.irq = d[Irq * cpuCount + c];
+        core.softirq = d[SoftIrq * cpuCount + c];
+        core.steal = d[Steal * cpuCount + c];
+        core.busy = core.user + core.system + core.irq + core.softirq + core.steal;
+        core.frequencyMHz = frequencyMHz[c];
+        coreStats.append(core);
+    }
+
+    double aggTotal = 0.0;
+    double aggDelta[FieldCount];
+    for (int f = 0; f < FieldCount; ++f) {
+        aggDelta[f] = aggregate[f] >= previousAggregate[f] ? static_cast<double>(aggregate[f] - previousAggregate[f]) : 0.0;
+        aggTotal += aggDelta[f];
+    }
+    if (aggTotal > 0.0) {
+        aggregateBusy = (aggTotal - aggDelta[Idle] - aggDelta[IoWait]) / aggTotal * 100.0;
+        aggregateSteal = aggDelta[Steal] / aggTotal * 100.0;
+    }
+    std::memcpy(previousAggregate, aggregate, sizeof(aggregate));
+    return true;
+}
+
+void CpuStatsCollector::readFrequencies()
+{
+    for (int c = 0; c < cpuCount; ++c) {
+        if (!online[c]) {
+            frequencyMHz[c] = 0.0;
+            continue;
+        }
+        freqBuffer.resize(qMax(freqBuffer.capacity(), 64));
+        if (readFile(frequencyPaths[c].constData(), freqBuffer)) {
+            frequencyMHz[c] = freqBuffer.trimmed().toDouble() / 1000.0;  // sysfs reports kHz
+        } else {
+            frequencyMHz[c] = 0.0;  // No cpufreq driver (common in VMs)
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef CPUSTATSCOLLECTOR_H
+#define CPUSTATSCOLLECTOR_H
+
+#include <QByteArray>
+#include <QVector>
+
+// Per-core utilization breakdown for one sampling interval, in percent
+struct CpuCoreStats {
+    int cpu = 0;
+    double user = 0.0;       // user + nice
+    double system = 0.0;
+    double iowait = 0.0;
+    double irq = 0.0;
+    double softirq = 0.0;
+    double steal = 0.0;      // Time the hypervisor ran another guest
+    double busy = 0.0;       // Everything except idle and iowait
+    double frequencyMHz = 0.0;
+};
+
+// Reads per-CPU counters from /proc/stat and current frequency from sysfs.
+// Counters are stored field-major (all cores' user ticks, then all cores'
+// system ticks, ...) so the per-tick delta and percentage passes are plain
+// loops over contiguous arrays that the compiler vectorizes.
+class CpuStatsCollector {
+public:
+    CpuStatsCollector();
+
+    bool isAvailable() const { return available; }
+    bool update();
+
+    const QVector<CpuCoreStats>& cores() const { return coreStats; }
+    double totalBusy() const { return aggregateBusy; }
+    double totalSteal() const { return aggregateSteal; }
+
+private:
+    enum Field {
+        User, Nice, System, Idle, IoWait, Irq, SoftIrq, Steal,
+        FieldCount
+    };
+
+    bool readFile(const char *path, QByteArray &into);
+    void resizeFor(int cpuCount);
+    void readFrequencies();
+
+    bool available;
+    bool hasPrevious;
+    int cpuCount;
+    QByteArray buffer;
+    QByteArray freqBuffer;
+    QVector<quint64> current;   // FieldCount * cpuCount, field-major
+    QVector<quint64> previous;
+    QVector<double> delta;
+    QVector<double> total;
+    QVector<quint8> online;
+    QVector<double> frequencyMHz;
+    QVector<QByteArray> frequencyPaths;
+    quint64 previousAggregate[FieldCount];
+    QVector<CpuCoreStats> coreStats;
+    double aggregateBusy;
+    double aggregateSteal;
+};
+
+#endif // CPUSTATSCOLLECTOR_H
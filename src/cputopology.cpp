@@ -0,0 +1,190 @@
+#include "cputopology.h"
+#include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QSet>
+#include <algorithm>
+
+namespace {
+
+const char *const CPU_ROOT = "/sys/devices/system/cpu";
+const char *const NODE_ROOT = "/sys/devices/system/node";
+
+QByteArray readSysfs(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll().trimmed();
+}
+
+} // namespace
+
+CpuTopology::CpuTopology() :
+    packages(0),
+    nodes(0),
+    smt(false)
+{
+    QVector<int> online = parseCpuList(readSysfs(QString("%1/online").arg(CPU_ROOT)));
+    if (online.isEmpty()) {
+        return;
+    }
+
+    QMap<int, int> nodeOfCpu;
+    const QStringList nodeDirs = QDir(NODE_ROOT).entryList({"node*"}, QDir::Dirs);
+    for (const QString &nodeDir : nodeDirs) {
+        bool ok = false;
+        int node = nodeDir.mid(4).toInt(&ok);
+        if (!ok) {
+            continue;
+        }
+        for (int cpu : parseCpuList(readSysfs(QString("%1/%2/cpulist").arg(NODE_ROOT, nodeDir)))) {
+            nodeOfCpu.insert(cpu, node);
+        }
+    }
+
+    QSet<int> packageIds;
+    QSet<int> nodeIds;
+    QMap<QString, int> l3Index;
+    for (int cpu : online) {
+        LogicalCpu logical;
+        logical.cpu = cpu;
+        QString topology = QString("%1/cpu%2/topology/").arg(CPU_ROOT).arg(cpu);
+        logical.package = readSysfs(topology + "physical_package_id").toInt();
+        logical.core = readSysfs(topology + "core_id").toInt();
+        logical.node = nodeOfCpu.value(cpu, 0);
+
+        QVector<int> siblings = parseCpuList(readSysfs(topology + "thread_siblings_list"));
+        if (siblings.size() > 1) {
+            smt = true;
+            logical.primaryThread = siblings.first() == cpu;
+        }
+
+        // The last-level cache shared between cores; look for level 3
+        QDir cacheDir(QString("%1/cpu%2/cache").arg(CPU_ROOT).arg(cpu));
+        for (const QString &index : cacheDir.entryList({"index*"}, QDir::Dirs)) {
+            if (readSysfs(cacheDir.filePath(index + "/level")) != "3") {
+                continue;
+            }
+            QString shared = QString::fromLatin1(readSysfs(cacheDir.filePath(index + "/shared_cpu_list")));
+            auto it = l3Index.find(shared);
+            if (it == l3Index.end()) {
+                it = l3Index.insert(shared, sharedL3.size());
+                sharedL3.append(parseCpuList(shared.toLatin1()));
+            }
+            logical.l3Group = it.value();
+            break;
+        }
+
+        packageIds.insert(logical.package);
+        nodeIds.insert(logical.node);
+        logicalCpus.append(logical);
+    }
+    packages = packageIds.size();
+    nodes = nodeIds.size();
+}
+
+QString CpuTopology::describe(int cpu) const
+{
+    for (const LogicalCpu &logical : logicalCpus) {
+        if (logical.cpu == cpu) {
+            return QString("CPU %1 - package %2, core %3, node %4%5")
+                .arg(cpu).arg(logical.package).arg(logical.core).arg(logical.node)
+                .arg(logical.primaryThread ? "" : ", SMT sibling");
+        }
+    }
+    return QString("CPU %1").arg(cpu);
+}
+
+QVector<AffinityPreset> CpuTopology::presets() const
+{
+    QVector<AffinityPreset> result;
+    AffinityPreset all{"All CPUs", {}};
+    for (const LogicalCpu &logical : logicalCpus) {
+        all.cpus.append(logical.cpu);
+    }
+    result.append(all);
+
+    auto collect = [this](auto predicate) {
+        QVector<int> cpus;
+        for (const LogicalCpu &logical : logicalCpus) {
+            if (predicate(logical)) {
+                cpus.append(logical.cpu);
+            }
+        }
+        return cpus;
+    };
+
+    if (nodes > 1) {
+        QSet<int> seen;
+        for (const LogicalCpu &logical : logicalCpus) {
+            if (!seen.contains(logical.node)) {
+                seen.insert(logical.node);
+                int node = logical.node;
+                result.append({QString("Isolate to node %1").arg(node),
+                               collect([node](const LogicalCpu &c) { return c.node == node; })});
+            }
+        }
+    }
+    if (packages > 1) {
+        QSet<int> seen;
+        for (const LogicalCpu &logical : logicalCpus) {
+            if (!seen.contains(logical.package)) {
+                seen.insert(logical.package);
+                int package = logical.package;
+                result.append({QString("Package %1 only").arg(package),
+                               collect([package](const LogicalCpu &c) { return c.package == package; })});
+            }
+        }
+    }
+    if (smt) {
+        result.append({"Keep off SMT siblings (one thread per core)",
+                       collect([](const LogicalCpu &c) { return c.primaryThread; })});
+    }
+    if (sharedL3.size() > 1) {
+        for (int group = 0; group < sharedL3.size(); ++group) {
+            result.append({QString("Shared L3 cache %1 (%2)").arg(group).arg(formatCpuList(sharedL3[group])),
+                           sharedL3[group]});
+        }
+    }
+    return result;
+}
+
+QVector<int> CpuTopology::parseCpuList(const QByteArray &list)
+{
+    QVector<int> cpus;
+    for (const QByteArray &range : list.trimmed().split(',')) {
+        if (range.isEmpty()) {
+            continue;
+        }
+        int dash = range.indexOf('-');
+        bool okFirst = false, okLast = false;
+        int first = range.left(dash < 0 ? range.size() : dash).toInt(&okFirst);
+        int last = dash < 0 ? first : range.mid(dash + 1).toInt(&okLast);
+        if (!okFirst || (dash >= 0 && !okLast)) {
+            continue;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.append(cpu);
+        }
+    }
+    return cpus;
+}
+
+QString CpuTopology::formatCpuList(const QVector<int> &cpus)
+{
+    QVector<int> sorted = cpus;
+    std::sort(sorted.begin(), sorted.end());
+    QStringList ranges;
+    for (int index = 0; index < sorted.size();) {
+        int first = sorted[index];
+        int last = first;
+        while (index + 1 < sorted.size() && sorted[index + 1] == last + 1) {
+            last = sorted[++index];
+        }
+        ++index;
+        ranges.append(first == last ? QString::number(first) : QString("%1-%2").arg(first).arg(last));
+    }
+    return ranges.join(',');
+}
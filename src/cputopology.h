@@ -0,0 +1,49 @@
+#ifndef CPUTOPOLOGY_H
+#define CPUTOPOLOGY_H
+
+#include <QString>
+#include <QVector>
+
+struct LogicalCpu {
+    int cpu = 0;
+    int package = 0;
+    int core = 0;          // core_id, unique within a package
+    int node = 0;          // NUMA node
+    int l3Group = -1;      // Index into CpuTopology::l3Groups(), -1 if unknown
+    bool primaryThread = true;  // Lowest-numbered thread of its core
+};
+
+struct AffinityPreset {
+    QString name;
+    QVector<int> cpus;
+};
+
+// Static CPU layout read from /sys/devices/system/cpu and
+// /sys/devices/system/node. Loaded once; hotplug is not tracked.
+class CpuTopology {
+public:
+    CpuTopology();
+
+    bool isAvailable() const { return !logicalCpus.isEmpty(); }
+    const QVector<LogicalCpu>& cpus() const { return logicalCpus; }
+    int packageCount() const { return packages; }
+    int nodeCount() const { return nodes; }
+    bool hasSmt() const { return smt; }
+    const QVector<QVector<int>>& l3Groups() const { return sharedL3; }
+    QString describe(int cpu) const;
+
+    QVector<AffinityPreset> presets() const;
+
+    // Kernel cpulist format, e.g. "0-3,8,10-11"
+    static QVector<int> parseCpuList(const QByteArray &list);
+    static QString formatCpuList(const QVector<int> &cpus);
+
+private:
+    QVector<LogicalCpu> logicalCpus;
+    QVector<QVector<int>> sharedL3;
+    int packages;
+    int nodes;
+    bool smt;
+};
+
+#endif // CPUTOPOLOGY_H
@@ -0,0 +1,216 @@
+#include "diskstatscollector.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <cstring>
+
+namespace {
+
+const char *const DISKSTATS_PATH = "/proc/diskstats";
+const double SECTOR_SIZE = 512.0;  // /proc/diskstats always counts 512-byte sectors
+
+inline const char *skipSpaces(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    return p;
+}
+
+inline const char *parseNumber(const char *p, const char *end, quint64 &value)
+{
+    p = skipSpaces(p, end);
+    quint64 v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + static_cast<quint64>(*p - '0');
+        ++p;
+    }
+    value = v;
+    return p;
+}
+
+inline quint64 counterDelta(quint64 current, quint64 previous)
+{
+    // Counters reset when a device is re-created; treat that as no activity
+    return current >= previous ? current - previous : 0;
+}
+
+} // namespace
+
+DiskStatsCollector::DiskStatsCollector() :
+    available(QFile::exists(DISKSTATS_PATH)),
+    bufferLength(0),
+    lastSampleMs(0)
+{
+    buffer.resize(64 * 1024);
+    clock.start();
+}
+
+bool DiskStatsCollector::readFile()
+{
+    QFile file(DISKSTATS_PATH);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        return false;
+    }
+
+    // procfs reports a size of 0, so read until EOF and grow the buffer if needed
+    bufferLength = 0;
+    for (;;) {
+        if (bufferLength == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        qint64 n = file.read(buffer.data() + bufferLength, buffer.size() - bufferLength);
+        if (n < 0) {
+            return false;
+        }
+        if (n == 0) {
+            break;
+        }
+        bufferLength += n;
+    }
+    return true;
+}
+
+int DiskStatsCollector::findSlot(const char *name, int length, int hint)
+{
+    // The kernel lists devices in a stable order, so the slot at the same
+    // position almost always matches and no lookup or allocation is needed
+    if (hint < deviceSlots.size()) {
+        const QByteArray &candidate = deviceSlots[hint].name;
+        if (candidate.size() == length && std::memcmp(candidate.constData(), name, length) == 0) {
+            return hint;
+        }
+    }
+
+    QByteArray key(name, length);
+    auto it = slotIndex.constFind(key);
+    if (it != slotIndex.constEnd()) {
+        return it.value();
+    }
+
+    DeviceSlot slot;
+    slot.name = key;
+    slot.displayName = QString::fromLatin1(key);
+    // Partitions are not listed directly under /sys/block
+    QByteArray sysName = key;
+    sysName.replace('/', '!');
+    slot.isWholeDevice = QFileInfo::exists(QStringLiteral("/sys/block/") + QString::fromLatin1(sysName));
+    deviceSlots.append(slot);
+    slotIndex.insert(key, deviceSlots.size() - 1);
+    return deviceSlots.size() - 1;
+}
+
+bool DiskStatsCollector::update()
+{
+    if (!available || !readFile()) {
+        stats.clear();
+        return false;
+    }
+
+    qint64 nowMs = clock.elapsed();
+    double elapsedMs = static_cast<double>(nowMs - lastSampleMs);
+    bool haveInterval = elapsedMs > 0.0;
+    double elapsedSec = elapsedMs / 1000.0;
+    lastSampleMs = nowMs;
+
+    for (DeviceSlot &slot : deviceSlots) {
+        slot.seen = false;
+    }
+    stats.resize(0);
+
+    const char *p = buffer.constData();
+    const char *end = p + bufferLength;
+    int lineIndex = 0;
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+
+        quint64 major, minor;
+        p = parseNumber(p, lineEnd, major);
+        p = parseNumber(p, lineEnd, minor);
+        p = skipSpaces(p, lineEnd);
+        const char *nameBegin = p;
+        while (p < lineEnd && *p != ' ' && *p != '\t') ++p;
+        int nameLength = static_cast<int>(p - nameBegin);
+
+        RawCounters raw;
+        quint64 unused;
+        p = parseNumber(p, lineEnd, raw.readsCompleted);
+        p = parseNumber(p, lineEnd, unused);              // reads merged
+        p = parseNumber(p, lineEnd, raw.sectorsRead);
+        p = parseNumber(p, lineEnd, raw.msReading);
+        p = parseNumber(p, lineEnd, raw.writesCompleted);
+        p = parseNumber(p, lineEnd, unused);              // writes merged
+        p = parseNumber(p, lineEnd, raw.sectorsWritten);
+        p = parseNumber(p, lineEnd, raw.msWriting);
+        p = parseNumber(p, lineEnd, raw.inFlight);
+        parseNumber(p, lineEnd, raw.msDoingIo);
+        p = lineEnd + 1;
+
+        if (nameLength == 0) {
+            continue;
+        }
+
+        int slotIdx = findSlot(nameBegin, nameLength, lineIndex++);
+        DeviceSlot &slot = deviceSlots[slotIdx];
+        slot.seen = true;
+
+        // Skip partitions and devices that have never done any I/O (idle loop/ram devices)
+        bool report = slot.isWholeDevice && (raw.readsCompleted + raw.writesCompleted) > 0;
+        if (report) {
+            BlockDeviceStats dev;
+            dev.name = slot.displayName;
+            dev.inFlight = raw.inFlight;
+            if (haveInterval && slot.hasPrevious) {
+                const RawCounters &prev = slot.previous;
+                quint64 reads = counterDelta(raw.readsCompleted, prev.readsCompleted);
+                quint64 writes = counterDelta(raw.writesCompleted, prev.writesCompleted);
+                quint64 ioMs = counterDelta(raw.msReading, prev.msReading) +
+                               counterDelta(raw.msWriting, prev.msWriting);
+                dev.readBytesPerSec = counterDelta(raw.sectorsRead, prev.sectorsRead) * SECTOR_SIZE / elapsedSec;
+                dev.writeBytesPerSec = counterDelta(raw.sectorsWritten, prev.sectorsWritten) * SECTOR_SIZE / elapsedSec;
+                dev.readIops = reads / elapsedSec;
+                dev.writeIops = writes / elapsedSec;
+                dev.avgServiceTimeMs = (reads + writes) > 0 ? static_cast<double>(ioMs) / (reads + writes) : 0.0;
+                dev.utilization = qMin(100.0, counterDelta(raw.msDoingIo, prev.msDoingIo) / elapsedMs * 100.0);
+            }
+            stats.append(dev);
+        }
+        slot.previous = raw;
+        slot.hasPrevious = true;
+    }
+
+    // Forget devices that disappeared (hot-unplugged disks, removed dm targets)
+    bool removed = false;
+    for (int i = deviceSlots.size() - 1; i >= 0; --i) {
+        if (!deviceSlots[i].seen) {
+            deviceSlots.removeAt(i);
+            removed = true;
+        }
+    }
+    if (removed) {
+        slotIndex.clear();
+        for (int i = 0; i < deviceSlots.size(); ++i) {
+            slotIndex.insert(deviceSlots[i].name, i);
+        }
+    }
+    return true;
+}
+
+int DiskStatsCollector::busiestDeviceIndex() const
+{
+    // Rank by utilization, break ties (e.g. several idle devices) by throughput
+    int busiest = -1;
+    for (int i = 0; i < stats.size(); ++i) {
+        if (busiest < 0) {
+            busiest = i;
+            continue;
+        }
+        const BlockDeviceStats &a = stats[i];
+        const BlockDeviceStats &b = stats[busiest];
+        if (a.utilization > b.utilization ||
+            (a.utilization == b.utilization &&
+             a.readBytesPerSec + a.writeBytesPerSec > b.readBytesPerSec + b.writeBytesPerSec)) {
+            busiest = i;
+        }
+    }
+    return busiest;
+}
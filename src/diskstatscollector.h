@@ -0,0 +1,69 @@
+#ifndef DISKSTATSCOLLECTOR_H
+#define DISKSTATSCOLLECTOR_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// Per-device I/O rates derived from two consecutive /proc/diskstats samples
+struct BlockDeviceStats {
+    QString name;
+    double readBytesPerSec = 0.0;
+    double writeBytesPerSec = 0.0;
+    double readIops = 0.0;
+    double writeIops = 0.0;
+    double avgServiceTimeMs = 0.0;  // Average time per completed request
+    quint64 inFlight = 0;           // Requests currently queued or in service
+    double utilization = 0.0;       // Percentage of wall time the device was busy
+};
+
+// Parses /proc/diskstats once per tick. The file is read into one reusable
+// buffer and parsed in place; device names are only copied when a device
+// is seen for the first time.
+class DiskStatsCollector {
+public:
+    DiskStatsCollector();
+
+    bool isAvailable() const { return available; }
+    bool update();
+
+    const QVector<BlockDeviceStats>& devices() const { return stats; }
+    int busiestDeviceIndex() const;
+
+private:
+    struct RawCounters {
+        quint64 readsCompleted = 0;
+        quint64 sectorsRead = 0;
+        quint64 msReading = 0;
+        quint64 writesCompleted = 0;
+        quint64 sectorsWritten = 0;
+        quint64 msWriting = 0;
+        quint64 inFlight = 0;
+        quint64 msDoingIo = 0;
+    };
+
+    struct DeviceSlot {
+        QByteArray name;
+        QString displayName;
+        bool isWholeDevice = true;
+        bool seen = false;       // Present in the current sample
+        bool hasPrevious = false;
+        RawCounters previous;
+    };
+
+    bool readFile();
+    int findSlot(const char *name, int length, int hint);
+
+    bool available;
+    QByteArray buffer;
+    qint64 bufferLength;
+    QVector<DeviceSlot> deviceSlots;
+    QHash<QByteArray, int> slotIndex;
+    QVector<BlockDeviceStats> stats;
+    QElapsedTimer clock;
+    qint64 lastSampleMs;
+};
+
+#endif // DISKSTATSCOLLECTOR_H
@@ -0,0 +1,131 @@
+#include "efficiencycontroller.h"
+#include "processcolumns.h"
+#include <QDateTime>
+#include <algorithm>
+
+EfficiencyController::EfficiencyController() :
+    enabled(false),
+    tick(0),
+    throttledRows(0)
+{
+}
+
+void EfficiencyController::setActuators(Actuator throttle, Actuator release)
+{
+    throttleProcess = std::move(throttle);
+    releaseProcess = std::move(release);
+}
+
+void EfficiencyController::releaseRow(int row)
+{
+    if (releaseProcess) {
+        releaseProcess(pids[row]);
+    }
+    throttled[row] = 0;
+    reasons[row].clear();
+    lastChange[row] = tick;
+}
+
+void EfficiencyController::setEnabled(bool enable)
+{
+    if (enabled == enable) {
+        return;
+    }
+    enabled = enable;
+    if (!enabled) {
+        for (int row = 0; row < throttled.size(); ++row) {
+            if (throttled[row]) {
+                releaseRow(row);
+            }
+        }
+        throttledRows = 0;
+    }
+}
+
+void EfficiencyController::update(const ProcessColumns &columns, const QVector<quint8> &eligible)
+{
+    ++tick;
+
+    // Processes that exited while throttled still need their journal entry dropped
+    QVector<quint8> carried(pids.size(), 0);
+    for (int from : columns.previousRow) {
+        if (from >= 0 && from < carried.size()) {
+            carried[from] = 1;
+        }
+    }
+    for (int row = 0; row < pids.size(); ++row) {
+        if (throttled[row] && !carried[row] && releaseProcess) {
+            releaseProcess(pids[row]);
+        }
+    }
+
+    remapColumn(hotStreak, columns.previousRow, quint16(0));
+    remapColumn(calmStreak, columns.previousRow, quint16(0));
+    remapColumn(throttled, columns.previousRow, quint8(0));
+    remapColumn(lastChange, columns.previousRow, qint32(-settings.minTicksBetweenChanges));
+    remapColumn(reasons, columns.previousRow, QString());
+    remapColumn(since, columns.previousRow, qint64(0));
+    pids = columns.pid;
+    names = columns.name;
+
+    const int rows = columns.rows;
+    const double *cpu = columns.column(ProcessColumns::Cpu);
+    const double hotCpu = settings.hotCpu;
+    const double calmCpu = settings.calmCpu;
+    quint16 *hot = hotStreak.data();
+    quint16 *calm = calmStreak.data();
+    for (int row = 0; row < rows; ++row) {
+        const int isHot = cpu[row] > hotCpu;
+        const int isCalm = cpu[row] < calmCpu;
+        hot[row] = quint16(std::min(hot[row] + 1, 0xffff) * isHot);
+        calm[row] = quint16(std::min(calm[row] + 1, 0xffff) * isCalm);
+    }
+
+    int count = 0;
+    for (int row = 0; row < rows; ++row) {
+        count += throttled[row];
+    }
+    throttledRows = count;
+    if (!enabled) {
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    int changes = 0;
+    for (int row = 0; row < rows && changes < settings.maxChangesPerTick; ++row) {
+        if (tick - lastChange[row] < settings.minTicksBetweenChanges) {
+            continue;
+        }
+        // Background services are judged like everything else: being one is
+        // no reason to confine it, and a calm one must be released
+        if (!throttled[row]) {
+            if (!eligible.value(row) || hot[row] < settings.hotTicks) {
+                continue;
+            }
+            lastChange[row] = tick;
+            ++changes;
+            if (throttleProcess && throttleProcess(pids[row])) {
+                throttled[row] = 1;
+                reasons[row] = QString("CPU above %1% for %2 samples").arg(hotCpu, 0, 'f', 0).arg(hot[row]);
+                since[row] = now;
+                ++throttledRows;
+            }
+        } else if (calm[row] >= settings.calmTicks) {
+            releaseRow(row);
+            ++changes;
+            --throttledRows;
+        }
+    }
+}
+
+QVector<EfficiencyController::Throttle> EfficiencyController::activeThrottles() const
+{
+    QVector<Throttle> active;
+    active.reserve(throttledRows);
+    for (int row = 0; row < throttled.size(); ++row) {
+        if (throttled[row]) {
+            active.append({pids[row], names[row], reasons[row], since[row]});
+        }
+    }
+    return active;
+}
@@ -0,0 +1,69 @@
+#ifndef EFFICIENCYCONTROLLER_H
+#define EFFICIENCYCONTROLLER_H
+
+#include <QString>
+#include <QVector>
+#include <functional>
+
+struct ProcessColumns;
+
+// Efficiency mode as a control loop. Every snapshot it throttles eligible
+// processes that have been busy for a sustained period, and releases them
+// again once they have been calm for a while. Each process can only change state once per minTicksBetweenChanges,
+// and at most maxChangesPerTick processes change per snapshot.
+class EfficiencyController {
+public:
+    struct Settings {
+        double hotCpu = 10.0;           // Percent of total CPU
+        int hotTicks = 10;
+        double calmCpu = 3.0;
+        int calmTicks = 30;
+        int minTicksBetweenChanges = 30;
+        int maxChangesPerTick = 16;
+    };
+
+    struct Throttle {
+        qint64 pid = 0;
+        QString name;
+        QString reason;
+        qint64 sinceMs = 0;
+    };
+
+    // Applies or removes the actual limit; returns false if it failed
+    using Actuator = std::function<bool(qint64 pid)>;
+
+    EfficiencyController();
+
+    void setActuators(Actuator throttle, Actuator release);
+    void setSettings(const Settings &newSettings) { settings = newSettings; }
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+
+    // eligible[row] is 0 for processes that must never be touched
+    void update(const ProcessColumns &columns, const QVector<quint8> &eligible);
+
+    QVector<Throttle> activeThrottles() const;
+    int throttledCount() const { return throttledRows; }
+
+private:
+    void releaseRow(int row);
+
+    Settings settings;
+    Actuator throttleProcess;
+    Actuator releaseProcess;
+    bool enabled;
+    qint32 tick;
+    int throttledRows;
+
+    // Per-row state, carried between snapshots with ProcessColumns::previousRow
+    QVector<qint64> pids;
+    QVector<QString> names;
+    QVector<quint16> hotStreak;
+    QVector<quint16> calmStreak;
+    QVector<quint8> throttled;
+    QVector<qint32> lastChange;
+    QVector<QString> reasons;
+    QVector<qint64> since;
+};
+
+#endif // EFFICIENCYCONTROLLER_H
@@ -0,0 +1,68 @@
+#include "efficiencypanel.h"
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QDateTime>
+
+EfficiencyPanel::EfficiencyPanel(QWidget *parent) : QWidget(parent),
+    throttleTable(nullptr),
+    summaryLabel(nullptr)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    summaryLabel = new QLabel("Efficiency mode is off");
+    summaryLabel->setStyleSheet("color:#b0b0b0;");
+
+    throttleTable = new QTableWidget(0, 4);
+    throttleTable->setHorizontalHeaderLabels({"Process", "PID", "Reason", "Throttled since"});
+    throttleTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    throttleTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    throttleTable->verticalHeader()->setVisible(false);
+    throttleTable->horizontalHeader()->setStretchLastSection(true);
+    throttleTable->setMinimumHeight(180);
+    throttleTable->setStyleSheet(R"(
+        QTableWidget {
+            background-color: #232323;
+            color: #ffffff;
+            border: 1px solid #3a3a3a;
+            border-radius: 4px;
+            gridline-color: #3a3a3a;
+        }
+        QHeaderView::section {
+            background-color: #2d2d2d;
+            color: #ffffff;
+            padding: 8px;
+            border: 1px solid #3a3a3a;
+            font-weight: bold;
+        }
+    )");
+
+    layout->addWidget(summaryLabel);
+    layout->addWidget(throttleTable);
+}
+
+void EfficiencyPanel::updateThrottles(bool enabled, const QVector<EfficiencyController::Throttle> &throttles)
+{
+    summaryLabel->setText(enabled
+        ? QString("Efficiency mode is on - %1 processes throttled").arg(throttles.size())
+        : "Efficiency mode is off");
+
+    throttleTable->setUpdatesEnabled(false);
+    throttleTable->setRowCount(throttles.size());
+    for (int row = 0; row < throttles.size(); ++row) {
+        const EfficiencyController::Throttle &throttle = throttles[row];
+        QStringList cells = {throttle.name, QString::number(throttle.pid), throttle.reason,
+                             QDateTime::fromMSecsSinceEpoch(throttle.sinceMs).toString("hh:mm:ss")};
+        for (int column = 0; column < cells.size(); ++column) {
+            QTableWidgetItem *item = throttleTable->item(row, column);
+            if (!item) {
+                item = new QTableWidgetItem();
+                throttleTable->setItem(row, column, item);
+            }
+            item->setText(cells[column]);
+        }
+    }
+    throttleTable->setUpdatesEnabled(true);
+}
@@ -0,0 +1,26 @@
+#ifndef EFFICIENCYPANEL_H
+#define EFFICIENCYPANEL_H
+
+#include <QWidget>
+#include "efficiencycontroller.h"
+
+QT_BEGIN_NAMESPACE
+class QLabel;
+class QTableWidget;
+QT_END_NAMESPACE
+
+// Live list of the processes Efficiency mode is currently throttling and why
+class EfficiencyPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit EfficiencyPanel(QWidget *parent = nullptr);
+
+    void updateThrottles(bool enabled, const QVector<EfficiencyController::Throttle> &throttles);
+
+private:
+    QTableWidget *throttleTable;
+    QLabel *summaryLabel;
+};
+
+#endif // EFFICIENCYPANEL_H
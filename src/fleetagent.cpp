@@ -0,0 +1,212 @@
+#include "fleetagent.h"
+#include <QAbstractSocket>
+#include <QDateTime>
+#include <QDebug>
+#include <QHostAddress>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <cmath>
+
+namespace {
+
+// Changes smaller than this are not worth a record on the wire
+const float CPU_EPSILON = 0.05f;
+const qint64 MEMORY_EPSILON_KB = 64;
+
+const char *const SYNTHETIC_NAMES[] = {
+    "postgres", "nginx", "java", "python3", "node", "redis-server", "envoy",
+    "kubelet", "containerd", "sshd", "systemd-journald", "chronyd"
+};
+
+} // namespace
+
+FleetAgent::FleetAgent(const QString &name, QObject *parent) : QObject(parent),
+    hostName(name),
+    tcpServer(nullptr),
+    localServer(nullptr),
+    maxBacklogBytes(512 * 1024),
+    currentCpu(0.0),
+    currentMemory(0.0),
+    sequence(0)
+{
+}
+
+FleetAgent::~FleetAgent()
+{
+    if (localServer) {
+        localServer->close();
+    }
+}
+
+bool FleetAgent::listen(const fleet::Endpoint &endpoint)
+{
+    if (endpoint.local) {
+        if (!localServer) {
+            localServer = new QLocalServer(this);
+            connect(localServer, &QLocalServer::newConnection, this, &FleetAgent::onNewLocalConnection);
+        }
+        // A previous agent that crashed leaves its socket file behind
+        QLocalServer::removeServer(endpoint.path);
+        if (!localServer->listen(endpoint.path)) {
+            qWarning() << "Failed to listen on" << endpoint.toString() << localServer->errorString();
+            return false;
+        }
+        return true;
+    }
+
+    if (!tcpServer) {
+        tcpServer = new QTcpServer(this);
+        connect(tcpServer, &QTcpServer::newConnection, this, &FleetAgent::onNewTcpConnection);
+    }
+    if (!tcpServer->listen(QHostAddress(endpoint.host), endpoint.port)) {
+        qWarning() << "Failed to listen on" << endpoint.toString() << tcpServer->errorString();
+        return false;
+    }
+    return true;
+}
+
+void FleetAgent::onNewTcpConnection()
+{
+    while (QTcpSocket *socket = tcpServer->nextPendingConnection()) {
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        addClient(socket);
+    }
+}
+
+void FleetAgent::onNewLocalConnection()
+{
+    while (QLocalSocket *socket = localServer->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        addClient(socket);
+    }
+}
+
+void FleetAgent::addClient(QIODevice *socket)
+{
+    connect(socket, &QObject::destroyed, this, [this, socket]() {
+        for (int i = 0; i < clients.size(); ++i) {
+            if (clients[i].socket == socket) {
+                clients.removeAt(i);
+                break;
+            }
+        }
+    });
+    // Aggregators never send anything; ignore whatever arrives
+    connect(socket, &QIODevice::readyRead, socket, [socket]() { socket->readAll(); });
+
+    socket->write(fleet::encodeHello(hostName));
+    Client client;
+    client.socket = socket;
+    clients.append(client);
+    if (sequence > 0) {
+        sendTo(clients.last());
+    }
+}
+
+void FleetAgent::publish(const QVector<fleet::Process> &processes, double hostCpu, double hostMemory)
+{
+    current = processes;
+    currentCpu = hostCpu;
+    currentMemory = hostMemory;
+    sequence++;
+    for (Client &client : clients) {
+        if (client.socket->bytesToWrite() > maxBacklogBytes) {
+            // Conflate: the baseline is untouched, so nothing is lost
+            continue;
+        }
+        sendTo(client);
+    }
+}
+
+void FleetAgent::sendTo(Client &client)
+{
+    fleet::SnapshotFrame frame;
+    frame.sequence = sequence;
+    frame.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    frame.hostCpu = float(currentCpu);
+    frame.hostMemory = float(currentMemory);
+
+    QHash<fleet::Key, Sent> next;
+    next.reserve(current.size());
+    for (const fleet::Process &process : current) {
+        fleet::Key key = fleet::keyOf(process);
+        auto previous = client.baseline.constFind(key);
+        if (previous == client.baseline.constEnd()) {
+            frame.upserts.append(process);
+            next.insert(key, Sent{process.cpuUsage, process.memoryKb});
+        } else if (std::fabs(previous->cpuUsage - process.cpuUsage) >= CPU_EPSILON
+                   || qAbs(previous->memoryKb - process.memoryKb) >= MEMORY_EPSILON_KB) {
+            fleet::Process changed = process;
+            changed.name.clear();
+            frame.upserts.append(changed);
+            next.insert(key, Sent{process.cpuUsage, process.memoryKb});
+        } else {
+            next.insert(key, *previous);
+        }
+    }
+    for (auto it = client.baseline.constBegin(); it != client.baseline.constEnd(); ++it) {
+        if (!next.contains(it.key())) {
+            frame.removed.append(it.key());
+        }
+    }
+    client.baseline.swap(next);
+    client.socket->write(fleet::encodeSnapshot(frame));
+}
+
+SyntheticProcessSource::SyntheticProcessSource(int processCount, quint32 seed, QObject *parent) : QObject(parent),
+    state(seed ? seed : 1),
+    nextPid(1000 + seed % 1000),
+    targetCount(qMax(1, processCount))
+{
+    for (int i = 0; i < targetCount; ++i) {
+        processes.append(spawn());
+    }
+    connect(&timer, &QTimer::timeout, this, &SyntheticProcessSource::tick);
+}
+
+void SyntheticProcessSource::start(int intervalMs)
+{
+    timer.start(intervalMs);
+    tick();
+}
+
+fleet::Process SyntheticProcessSource::spawn()
+{
+    // xorshift32, deterministic per seed so runs are reproducible
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    fleet::Process process;
+    process.pid = nextPid++;
+    process.startTime = QDateTime::currentMSecsSinceEpoch();
+    process.name = SYNTHETIC_NAMES[state % (sizeof(SYNTHETIC_NAMES) / sizeof(SYNTHETIC_NAMES[0]))];
+    process.cpuUsage = float(state % 1000) / 400.0f;
+    process.memoryKb = 4096 + qint64(state % 2000000);
+    return process;
+}
+
+void SyntheticProcessSource::tick()
+{
+    double totalCpu = 0.0;
+    qint64 totalMemory = 0;
+    for (int i = 0; i < processes.size(); ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        fleet::Process &process = processes[i];
+        // About one process in 200 exits each tick and is replaced
+        if (state % 200 == 0) {
+            process = spawn();
+        } else {
+            float step = float(int(state % 201) - 100) / 100.0f;
+            process.cpuUsage = qBound(0.0f, process.cpuUsage + step, 100.0f);
+            process.memoryKb = qMax<qint64>(1024, process.memoryKb + qint64(state % 257) - 128);
+        }
+        totalCpu += process.cpuUsage;
+        totalMemory += process.memoryKb;
+    }
+    emit snapshot(processes, qMin(100.0, totalCpu), qMin(100.0, totalMemory / 163840.0));
+}
@@ -0,0 +1,89 @@
+#ifndef FLEETAGENT_H
+#define FLEETAGENT_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+#include "fleetprotocol.h"
+
+class QIODevice;
+class QLocalServer;
+class QTcpServer;
+
+// Streams local snapshots to any number of aggregators. Each connection
+// keeps the values it was last sent and receives only what changed since.
+// When a connection cannot keep up (too much unsent data queued), its
+// snapshots are skipped; the next delta then covers every change since the
+// last one it accepted, so slow readers get fewer, larger updates instead of
+// an unbounded queue.
+class FleetAgent : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FleetAgent(const QString &hostName, QObject *parent = nullptr);
+    ~FleetAgent();
+
+    bool listen(const fleet::Endpoint &endpoint);
+    void setMaxBacklogBytes(qint64 bytes) { maxBacklogBytes = bytes; }
+
+public slots:
+    void publish(const QVector<fleet::Process> &processes, double hostCpu, double hostMemory);
+
+private slots:
+    void onNewTcpConnection();
+    void onNewLocalConnection();
+
+private:
+    struct Sent {
+        float cpuUsage;
+        qint64 memoryKb;
+    };
+
+    struct Client {
+        QIODevice *socket = nullptr;
+        QHash<fleet::Key, Sent> baseline;
+    };
+
+    void addClient(QIODevice *socket);
+    void sendTo(Client &client);
+
+    QString hostName;
+    QTcpServer *tcpServer;
+    QLocalServer *localServer;
+    QList<Client> clients;
+    qint64 maxBacklogBytes;
+
+    // Latest snapshot, also sent to connections that arrive between ticks
+    QVector<fleet::Process> current;
+    double currentCpu;
+    double currentMemory;
+    quint64 sequence;
+};
+
+// Generates a plausible, slowly changing process list so the agent and
+// aggregator can be exercised on one machine without real hosts.
+class SyntheticProcessSource : public QObject {
+    Q_OBJECT
+
+public:
+    SyntheticProcessSource(int processCount, quint32 seed, QObject *parent = nullptr);
+    void start(int intervalMs);
+
+signals:
+    void snapshot(const QVector<fleet::Process> &processes, double hostCpu, double hostMemory);
+
+private slots:
+    void tick();
+
+private:
+    fleet::Process spawn();
+
+    QVector<fleet::Process> processes;
+    QTimer timer;
+    quint32 state;
+    qint64 nextPid;
+    int targetCount;
+};
+
+#endif // FLEETAGENT_H
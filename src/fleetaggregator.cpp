@@ -0,0 +1,225 @@
+#include "fleetaggregator.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QLocalSocket>
+#include <QTcpSocket>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+// Twice the largest frame, so a complete frame always fits
+const qint64 READ_BUFFER_BYTES = 2 * fleet::MAX_FRAME_BYTES;
+const int RECONNECT_INTERVAL_MS = 5000;
+// Views are refreshed at most this often, however many hosts report
+const int FLUSH_INTERVAL_MS = 500;
+
+} // namespace
+
+FleetAggregator::FleetAggregator(QObject *parent) : QObject(parent),
+    maxProcessesPerHost(5000),
+    dirty(false)
+{
+    connect(&reconnectTimer, &QTimer::timeout, this, &FleetAggregator::reconnect);
+    connect(&flushTimer, &QTimer::timeout, this, &FleetAggregator::flush);
+    reconnectTimer.start(RECONNECT_INTERVAL_MS);
+    flushTimer.start(FLUSH_INTERVAL_MS);
+}
+
+FleetAggregator::~FleetAggregator()
+{
+    for (Host &host : hostList) {
+        if (host.socket) {
+            host.socket->disconnect(this);
+        }
+    }
+}
+
+void FleetAggregator::addEndpoint(const fleet::Endpoint &endpoint)
+{
+    Host host;
+    host.endpoint = endpoint;
+    host.name = endpoint.toString();
+    host.state = "Connecting";
+    hostList.append(host);
+    connectHost(hostList.size() - 1);
+}
+
+void FleetAggregator::connectHost(int index)
+{
+    Host &host = hostList[index];
+    host.helloReceived = false;
+    host.state = "Connecting";
+
+    if (host.endpoint.local) {
+        QLocalSocket *socket = new QLocalSocket(this);
+        socket->setReadBufferSize(READ_BUFFER_BYTES);
+        connect(socket, &QLocalSocket::errorOccurred, this, [this, index, socket]() {
+            dropHost(index, socket->errorString());
+        });
+        host.socket = socket;
+        connect(socket, &QIODevice::readyRead, this, [this, index]() { onReadyRead(index); });
+        socket->connectToServer(host.endpoint.path, QIODevice::ReadWrite);
+    } else {
+        QTcpSocket *socket = new QTcpSocket(this);
+        socket->setReadBufferSize(READ_BUFFER_BYTES);
+        connect(socket, &QTcpSocket::errorOccurred, this, [this, index, socket]() {
+            dropHost(index, socket->errorString());
+        });
+        host.socket = socket;
+        connect(socket, &QIODevice::readyRead, this, [this, index]() { onReadyRead(index); });
+        socket->connectToHost(host.endpoint.host, host.endpoint.port);
+    }
+    dirty = true;
+}
+
+void FleetAggregator::reconnect()
+{
+    for (int i = 0; i < hostList.size(); ++i) {
+        if (!hostList[i].socket) {
+            connectHost(i);
+        }
+    }
+}
+
+void FleetAggregator::dropHost(int index, const QString &reason)
+{
+    Host &host = hostList[index];
+    if (!host.socket) {
+        return;
+    }
+    host.socket->disconnect(this);
+    host.socket->deleteLater();
+    host.socket = nullptr;
+    // Processes are kept so the last known state stays visible, marked stale
+    host.state = "Disconnected: " + reason;
+    dirty = true;
+}
+
+void FleetAggregator::onReadyRead(int index)
+{
+    Host &host = hostList[index];
+    QByteArray payload;
+    fleet::SnapshotFrame frame;
+    bool error = false;
+    while (host.socket && fleet::readFrame(host.socket, payload, error)) {
+        if (!host.helloReceived) {
+            QString name;
+            if (!fleet::decodeHello(payload, name)) {
+                dropHost(index, "Not a fleet agent");
+                return;
+            }
+            host.name = name.isEmpty() ? host.endpoint.toString() : name;
+            host.helloReceived = true;
+            host.processes.clear();
+            host.sequence = 0;
+            host.truncated = false;
+            host.state = "Connected";
+            dirty = true;
+            continue;
+        }
+        if (!fleet::decodeSnapshot(payload, frame)) {
+            dropHost(index, "Malformed snapshot");
+            return;
+        }
+        if (!applySnapshot(host, frame)) {
+            // Start over from a full snapshot on the next connection
+            host.processes.clear();
+            dropHost(index, "Snapshot out of sync");
+            return;
+        }
+    }
+    if (error) {
+        dropHost(index, "Oversized frame");
+    }
+}
+
+bool FleetAggregator::applySnapshot(Host &host, const fleet::SnapshotFrame &frame)
+{
+    for (const fleet::Key &key : frame.removed) {
+        host.processes.remove(key);
+    }
+    for (const fleet::Process &update : frame.upserts) {
+        auto it = host.processes.find(fleet::keyOf(update));
+        if (it != host.processes.end()) {
+            it->cpuUsage = update.cpuUsage;
+            it->memoryKb = update.memoryKb;
+        } else if (!update.name.isEmpty()) {
+            host.processes.insert(fleet::keyOf(update), update);
+        } else if (!host.truncated) {
+            // A change for a process we never saw: the stream is out of sync
+            return false;
+        }
+    }
+    if (host.processes.size() > maxProcessesPerHost) {
+        truncate(host);
+    }
+    if (host.sequence > 0 && frame.sequence > host.sequence + 1) {
+        host.missedSnapshots += frame.sequence - host.sequence - 1;
+    }
+    host.sequence = frame.sequence;
+    host.lastUpdateMs = QDateTime::currentMSecsSinceEpoch();
+    host.cpuUsage = frame.hostCpu;
+    host.memoryUsage = frame.hostMemory;
+    dirty = true;
+    return true;
+}
+
+void FleetAggregator::truncate(Host &host) const
+{
+    // Only runs while over the cap; nth_element keeps it linear
+    QVector<float> cpu;
+    cpu.reserve(host.processes.size());
+    for (const fleet::Process &process : host.processes) {
+        cpu.append(process.cpuUsage);
+    }
+    auto threshold = cpu.begin() + maxProcessesPerHost - 1;
+    std::nth_element(cpu.begin(), threshold, cpu.end(), std::greater<float>());
+    const float lowestKept = *threshold;
+    // Everything below the threshold goes, then ties until the cap is met
+    int excess = host.processes.size() - maxProcessesPerHost;
+    for (auto it = host.processes.begin(); it != host.processes.end() && excess > 0;) {
+        if (it->cpuUsage < lowestKept) {
+            it = host.processes.erase(it);
+            --excess;
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = host.processes.begin(); it != host.processes.end() && excess > 0;) {
+        if (it->cpuUsage == lowestKept) {
+            it = host.processes.erase(it);
+            --excess;
+        } else {
+            ++it;
+        }
+    }
+    if (!host.truncated) {
+        host.truncated = true;
+        host.state = QString("Connected, top %1 processes by CPU").arg(maxProcessesPerHost);
+    }
+}
+
+void FleetAggregator::flush()
+{
+    if (dirty) {
+        dirty = false;
+        emit updated();
+    }
+}
+
+QVector<FleetAggregator::Row> FleetAggregator::topProcesses(int count) const
+{
+    QVector<Row> rows;
+    for (int i = 0; i < hostList.size(); ++i) {
+        for (const fleet::Process &process : hostList[i].processes) {
+            rows.append(Row{i, &process});
+        }
+    }
+    count = qMin(count, int(rows.size()));
+    std::partial_sort(rows.begin(), rows.begin() + count, rows.end(), [](const Row &a, const Row &b) {
+        return a.process->cpuUsage > b.process->cpuUsage;
+    });
+    rows.resize(count);
+    return rows;
+}
@@ -0,0 +1,79 @@
+#ifndef FLEETAGGREGATOR_H
+#define FLEETAGGREGATOR_H
+
+#include <QHash>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include "fleetprotocol.h"
+
+class QIODevice;
+
+// Connects to FleetAgents and merges their streams into one process view.
+//
+// Memory is bounded per host (processes and buffered input), so one host
+// cannot crowd out the others. A host with more processes than the cap
+// keeps its top consumers by CPU and is flagged as truncated. Input from
+// each host is buffered only up to a fixed size; once full, the socket stops
+// reading, the transport pushes back and that agent conflates its snapshots
+// while the rest keep flowing.
+class FleetAggregator : public QObject {
+    Q_OBJECT
+
+public:
+    struct Host {
+        fleet::Endpoint endpoint;
+        QString name;           // As reported by the agent, endpoint until then
+        QString state;
+        QIODevice *socket = nullptr;
+        bool helloReceived = false;
+        QHash<fleet::Key, fleet::Process> processes;
+        quint64 sequence = 0;
+        quint64 missedSnapshots = 0;    // Conflated by the agent
+        // Processes beyond the cap were dropped. Updates for unknown
+        // processes are then ignored, since they may be dropped ones; a
+        // dropped process only reappears after it restarts or the host
+        // reconnects.
+        bool truncated = false;
+        qint64 lastUpdateMs = 0;
+        float cpuUsage = 0.0f;
+        float memoryUsage = 0.0f;
+    };
+
+    struct Row {
+        int host;
+        const fleet::Process *process;
+    };
+
+    explicit FleetAggregator(QObject *parent = nullptr);
+    ~FleetAggregator();
+
+    void addEndpoint(const fleet::Endpoint &endpoint);
+    void setMaxProcessesPerHost(int count) { maxProcessesPerHost = qMax(1, count); }
+
+    const QVector<Host>& hosts() const { return hostList; }
+    // Highest CPU consumers across all hosts; pointers stay valid until the next update
+    QVector<Row> topProcesses(int count) const;
+
+signals:
+    void updated();
+
+private slots:
+    void reconnect();
+    void flush();
+
+private:
+    void connectHost(int index);
+    void onReadyRead(int index);
+    void dropHost(int index, const QString &reason);
+    bool applySnapshot(Host &host, const fleet::SnapshotFrame &frame);
+    void truncate(Host &host) const;
+
+    QVector<Host> hostList;
+    QTimer reconnectTimer;
+    QTimer flushTimer;
+    int maxProcessesPerHost;
+    bool dirty;
+};
+
+#endif // FLEETAGGREGATOR_H
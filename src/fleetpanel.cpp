@@ -0,0 +1,153 @@
+#include "fleetpanel.h"
+#include "fleetaggregator.h"
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QDateTime>
+
+namespace {
+
+// Rows shown in the merged table; the aggregator holds the rest
+const int MAX_FLEET_ROWS = 200;
+// A host that has not reported for this long is shown as stale
+const qint64 STALE_AFTER_MS = 10000;
+
+QColor usageColor(double percent)
+{
+    if (percent >= 80.0) return QColor("#FF4444");
+    if (percent >= 50.0) return QColor("#FFA500");
+    if (percent >= 20.0) return QColor("#FFD700");
+    return QColor("#4CAF50");
+}
+
+QString formatMemoryKb(qint64 kb)
+{
+    if (kb >= 1024 * 1024) {
+        return QString("%1 GB").arg(kb / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+    return QString("%1 MB").arg(kb / 1024.0, 0, 'f', 1);
+}
+
+} // namespace
+
+FleetPanel::FleetPanel(FleetAggregator *source, QWidget *parent) : QWidget(parent),
+    aggregator(source),
+    summaryLabel(nullptr),
+    hostTable(nullptr),
+    processTable(nullptr)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(20, 20, 20, 20);
+    layout->setSpacing(10);
+
+    QLabel *title = new QLabel("Fleet");
+    title->setStyleSheet("font-size: 18px; font-weight: bold; color: #ffffff;");
+    summaryLabel = new QLabel("Waiting for agents");
+    summaryLabel->setStyleSheet("color:#b0b0b0;");
+
+    hostTable = createTable({"Host", "State", "Processes", "CPU", "Memory", "Last Update", "Missed"});
+    hostTable->setMaximumHeight(200);
+    processTable = createTable({"Host", "Name", "PID", "CPU", "Memory"});
+
+    layout->addWidget(title);
+    layout->addWidget(summaryLabel);
+    layout->addWidget(hostTable);
+    layout->addWidget(new QLabel(QString("Top %1 processes by CPU").arg(MAX_FLEET_ROWS)));
+    layout->addWidget(processTable, 1);
+
+    connect(aggregator, &FleetAggregator::updated, this, &FleetPanel::refresh);
+}
+
+QTableWidget *FleetPanel::createTable(const QStringList &headers)
+{
+    QTableWidget *table = new QTableWidget(0, headers.size());
+    table->setHorizontalHeaderLabels(headers);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setStretchLastSection(true);
+    table->setStyleSheet(R"(
+        QTableWidget {
+            background-color: #232323;
+            color: #ffffff;
+            border: 1px solid #3a3a3a;
+            border-radius: 4px;
+            gridline-color: #3a3a3a;
+        }
+        QHeaderView::section {
+            background-color: #2d2d2d;
+            color: #ffffff;
+            padding: 8px;
+            border: 1px solid #3a3a3a;
+            font-weight: bold;
+        }
+    )");
+    return table;
+}
+
+void FleetPanel::setCell(QTableWidget *table, int row, int column, const QString &text, const QColor &color)
+{
+    QTableWidgetItem *item = table->item(row, column);
+    if (!item) {
+        item = new QTableWidgetItem();
+        table->setItem(row, column, item);
+    }
+    item->setText(text);
+    item->setForeground(color);
+}
+
+void FleetPanel::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    refresh();
+}
+
+void FleetPanel::refresh()
+{
+    // Only the visible view pays for rebuilding its tables
+    if (!isVisible()) {
+        return;
+    }
+    const QVector<FleetAggregator::Host> &hosts = aggregator->hosts();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    int connected = 0;
+    int processes = 0;
+
+    hostTable->setUpdatesEnabled(false);
+    hostTable->setRowCount(hosts.size());
+    for (int row = 0; row < hosts.size(); ++row) {
+        const FleetAggregator::Host &host = hosts[row];
+        bool stale = host.lastUpdateMs == 0 || now - host.lastUpdateMs > STALE_AFTER_MS;
+        connected += host.socket ? 1 : 0;
+        processes += host.processes.size();
+        QColor stateColor = !host.socket ? QColor("#FF4444") : stale ? QColor("#FFA500") : QColor("#4CAF50");
+        setCell(hostTable, row, 0, host.name, QColor("#ffffff"));
+        setCell(hostTable, row, 1, host.state, stateColor);
+        setCell(hostTable, row, 2, QString::number(host.processes.size()) + (host.truncated ? "+" : ""),
+                host.truncated ? QColor("#FFD700") : QColor("#ffffff"));
+        setCell(hostTable, row, 3, QString("%1%").arg(host.cpuUsage, 0, 'f', 1), usageColor(host.cpuUsage));
+        setCell(hostTable, row, 4, QString("%1%").arg(host.memoryUsage, 0, 'f', 1), usageColor(host.memoryUsage));
+        setCell(hostTable, row, 5, host.lastUpdateMs > 0
+            ? QDateTime::fromMSecsSinceEpoch(host.lastUpdateMs).toString("hh:mm:ss") : QString("-"), QColor("#b0b0b0"));
+        setCell(hostTable, row, 6, QString::number(host.missedSnapshots),
+                host.missedSnapshots > 0 ? QColor("#FFD700") : QColor("#b0b0b0"));
+    }
+    hostTable->setUpdatesEnabled(true);
+
+    const QVector<FleetAggregator::Row> rows = aggregator->topProcesses(MAX_FLEET_ROWS);
+    processTable->setUpdatesEnabled(false);
+    processTable->setRowCount(rows.size());
+    for (int row = 0; row < rows.size(); ++row) {
+        const fleet::Process &process = *rows[row].process;
+        setCell(processTable, row, 0, hosts[rows[row].host].name, QColor("#80bfff"));
+        setCell(processTable, row, 1, process.name, QColor("#ffffff"));
+        setCell(processTable, row, 2, QString::number(process.pid), QColor("#b0b0b0"));
+        setCell(processTable, row, 3, QString("%1%").arg(process.cpuUsage, 0, 'f', 1), usageColor(process.cpuUsage));
+        setCell(processTable, row, 4, formatMemoryKb(process.memoryKb), QColor("#ffffff"));
+    }
+    processTable->setUpdatesEnabled(true);
+
+    summaryLabel->setText(QString("%1 of %2 hosts connected, %3 processes")
+        .arg(connected).arg(hosts.size()).arg(processes));
+}
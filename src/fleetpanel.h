@@ -0,0 +1,37 @@
+#ifndef FLEETPANEL_H
+#define FLEETPANEL_H
+
+#include <QWidget>
+
+class FleetAggregator;
+
+QT_BEGIN_NAMESPACE
+class QLabel;
+class QTableWidget;
+QT_END_NAMESPACE
+
+// Fleet view: connection state per host and the top CPU consumers across
+// every host the aggregator is connected to
+class FleetPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit FleetPanel(FleetAggregator *aggregator, QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private slots:
+    void refresh();
+
+private:
+    static QTableWidget *createTable(const QStringList &headers);
+    static void setCell(QTableWidget *table, int row, int column, const QString &text, const QColor &color);
+
+    FleetAggregator *aggregator;
+    QLabel *summaryLabel;
+    QTableWidget *hostTable;
+    QTableWidget *processTable;
+};
+
+#endif // FLEETPANEL_H
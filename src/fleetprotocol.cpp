@@ -0,0 +1,171 @@
+#include "fleetprotocol.h"
+#include "processcolumns.h"
+#include <QDataStream>
+#include <QIODevice>
+#include <QtEndian>
+#include <algorithm>
+#include <numeric>
+
+namespace fleet {
+
+namespace {
+
+const QDataStream::Version STREAM_VERSION = QDataStream::Qt_6_0;
+
+QByteArray frame(const QByteArray &payload)
+{
+    QByteArray out(4, Qt::Uninitialized);
+    qToBigEndian<quint32>(quint32(payload.size()), out.data());
+    out += payload;
+    return out;
+}
+
+} // namespace
+
+bool Endpoint::parse(const QString &text, Endpoint &endpoint)
+{
+    endpoint = Endpoint();
+    if (text.startsWith("unix:")) {
+        endpoint.local = true;
+        endpoint.path = text.mid(5);
+        return !endpoint.path.isEmpty();
+    }
+    int colon = text.lastIndexOf(':');
+    endpoint.host = colon >= 0 ? text.left(colon) : QString("127.0.0.1");
+    bool ok = false;
+    uint port = text.mid(colon + 1).toUInt(&ok);
+    endpoint.port = quint16(port);
+    return ok && port > 0 && port <= 65535 && !endpoint.host.isEmpty();
+}
+
+QString Endpoint::toString() const
+{
+    return local ? "unix:" + path : QString("%1:%2").arg(host).arg(port);
+}
+
+QByteArray encodeHello(const QString &hostName)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(STREAM_VERSION);
+    stream << quint8(Hello) << MAGIC << hostName;
+    return frame(payload);
+}
+
+QByteArray encodeSnapshot(const SnapshotFrame &snapshot)
+{
+    QByteArray payload;
+    payload.reserve(32 + snapshot.upserts.size() * 40 + snapshot.removed.size() * 16);
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream.setVersion(STREAM_VERSION);
+    stream << quint8(Snapshot) << snapshot.sequence << snapshot.timestampMs
+           << snapshot.hostCpu << snapshot.hostMemory;
+    stream << quint32(snapshot.upserts.size());
+    for (const Process &process : snapshot.upserts) {
+        stream << process.pid << process.startTime << quint8(process.name.isEmpty() ? 0 : 1);
+        if (!process.name.isEmpty()) {
+            stream << process.name;
+        }
+        stream << process.cpuUsage << process.memoryKb;
+    }
+    stream << quint32(snapshot.removed.size());
+    for (const Key &key : snapshot.removed) {
+        stream << key.pid << key.startTime;
+    }
+    return frame(payload);
+}
+
+bool readFrame(QIODevice *device, QByteArray &payload, bool &error)
+{
+    error = false;
+    char header[4];
+    if (device->peek(header, 4) < 4) {
+        return false;
+    }
+    quint32 length = qFromBigEndian<quint32>(header);
+    if (length == 0 || length > quint32(MAX_FRAME_BYTES)) {
+        error = true;
+        return false;
+    }
+    if (device->bytesAvailable() < qint64(length) + 4) {
+        return false;
+    }
+    device->skip(4);
+    payload = device->read(length);
+    return payload.size() == int(length);
+}
+
+bool decodeHello(const QByteArray &payload, QString &hostName)
+{
+    QDataStream stream(payload);
+    stream.setVersion(STREAM_VERSION);
+    quint8 type = 0;
+    quint32 magic = 0;
+    stream >> type >> magic >> hostName;
+    return stream.status() == QDataStream::Ok && type == Hello && magic == MAGIC;
+}
+
+bool decodeSnapshot(const QByteArray &payload, SnapshotFrame &snapshot)
+{
+    QDataStream stream(payload);
+    stream.setVersion(STREAM_VERSION);
+    quint8 type = 0;
+    stream >> type;
+    if (type != Snapshot) {
+        return false;
+    }
+    stream >> snapshot.sequence >> snapshot.timestampMs >> snapshot.hostCpu >> snapshot.hostMemory;
+
+    // Counts are checked against the payload size so a bad frame cannot
+    // make us allocate more than it could possibly contain
+    quint32 count = 0;
+    stream >> count;
+    if (stream.status() != QDataStream::Ok || count > quint32(payload.size() / 29)) {
+        return false;
+    }
+    snapshot.upserts.resize(int(count));
+    for (Process &process : snapshot.upserts) {
+        quint8 hasName = 0;
+        stream >> process.pid >> process.startTime >> hasName;
+        process.name.clear();
+        if (hasName) {
+            stream >> process.name;
+        }
+        stream >> process.cpuUsage >> process.memoryKb;
+    }
+    stream >> count;
+    if (stream.status() != QDataStream::Ok || count > quint32(payload.size() / 16)) {
+        return false;
+    }
+    snapshot.removed.resize(int(count));
+    for (Key &key : snapshot.removed) {
+        stream >> key.pid >> key.startTime;
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+QVector<Process> fromColumns(const ProcessColumns &columns, int maxProcesses)
+{
+    QVector<int> order(columns.rows);
+    std::iota(order.begin(), order.end(), 0);
+    const double *cpu = columns.column(ProcessColumns::Cpu);
+    int count = qMin(columns.rows, qMax(0, maxProcesses));
+    std::partial_sort(order.begin(), order.begin() + count, order.end(), [cpu](int a, int b) {
+        return cpu[a] > cpu[b];
+    });
+
+    const double *memory = columns.column(ProcessColumns::MemoryKb);
+    QVector<Process> processes(count);
+    for (int i = 0; i < count; ++i) {
+        int row = order[i];
+        Process &process = processes[i];
+        process.pid = columns.pid[row];
+        process.startTime = columns.startTime[row];
+        process.name = columns.name[row];
+        process.cpuUsage = float(cpu[row]);
+        process.memoryKb = qint64(memory[row]);
+    }
+    return processes;
+}
+
+} // namespace fleet
@@ -0,0 +1,82 @@
+#ifndef FLEETPROTOCOL_H
+#define FLEETPROTOCOL_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class QIODevice;
+struct ProcessColumns;
+
+// Wire format shared by FleetAgent and FleetAggregator. Every frame is a
+// big-endian quint32 payload length followed by a QDataStream payload:
+//
+//   Hello     magic, host name
+//   Snapshot  sequence, timestamp, host CPU and memory, changed or new
+//             processes (name only when new), then removed processes
+//
+// Each snapshot is a delta against what that connection last received, so
+// a skipped send is simply folded into the next one.
+namespace fleet {
+
+constexpr quint32 MAGIC = 0x464c5431;   // "FLT1"
+constexpr int MAX_FRAME_BYTES = 4 * 1024 * 1024;
+
+enum FrameType : quint8 {
+    Hello = 1,
+    Snapshot = 2
+};
+
+struct Process {
+    qint64 pid = 0;
+    qint64 startTime = 0;
+    QString name;
+    float cpuUsage = 0.0f;      // Percent of the host's total CPU
+    qint64 memoryKb = 0;
+};
+
+struct Key {
+    qint64 pid;
+    qint64 startTime;
+    bool operator==(const Key &other) const { return pid == other.pid && startTime == other.startTime; }
+    friend size_t qHash(const Key &key, size_t seed) { return qHashMulti(seed, key.pid, key.startTime); }
+};
+
+inline Key keyOf(const Process &process) { return Key{process.pid, process.startTime}; }
+
+struct SnapshotFrame {
+    quint64 sequence = 0;
+    qint64 timestampMs = 0;
+    float hostCpu = 0.0f;
+    float hostMemory = 0.0f;
+    QVector<Process> upserts;   // Name is empty for processes the receiver already knows
+    QVector<Key> removed;
+};
+
+// "unix:/path/to/socket", "host:port" or just "port" (loopback)
+struct Endpoint {
+    bool local = false;
+    QString path;
+    QString host;
+    quint16 port = 0;
+
+    static bool parse(const QString &text, Endpoint &endpoint);
+    QString toString() const;
+};
+
+QByteArray encodeHello(const QString &hostName);
+QByteArray encodeSnapshot(const SnapshotFrame &frame);
+
+// Takes one complete frame from the device, if available. Returns false and
+// sets error when the stream is malformed and the connection should be dropped.
+bool readFrame(QIODevice *device, QByteArray &payload, bool &error);
+bool decodeHello(const QByteArray &payload, QString &hostName);
+bool decodeSnapshot(const QByteArray &payload, SnapshotFrame &frame);
+
+// Top processes by CPU from the local snapshot
+QVector<Process> fromColumns(const ProcessColumns &columns, int maxProcesses);
+
+} // namespace fleet
+
+#endif // FLEETPROTOCOL_H
@@ -0,0 +1,88 @@
+#include "framescheduler.h"
+#include <QDateTime>
+#include <QEvent>
+#include <QTimer>
+#include <QWidget>
+
+namespace {
+
+const int DEFAULT_MAX_FRAME_RATE = 30;
+
+} // namespace
+
+FrameScheduler::FrameScheduler(QObject *parent) : QObject(parent),
+    frameTimer(new QTimer(this)),
+    snapshotVersion(0),
+    lastFrameMs(0),
+    minFrameIntervalMs(1000 / DEFAULT_MAX_FRAME_RATE)
+{
+    frameTimer->setSingleShot(true);
+    connect(frameTimer, &QTimer::timeout, this, &FrameScheduler::renderFrame);
+}
+
+void FrameScheduler::addView(QWidget *widget, std::function<void()> render)
+{
+    views.append(View{widget, std::move(render), true});
+    widget->installEventFilter(this);
+    scheduleFrame();
+}
+
+void FrameScheduler::setMaxFrameRate(int framesPerSecond)
+{
+    minFrameIntervalMs = 1000 / qBound(1, framesPerSecond, 1000);
+}
+
+void FrameScheduler::snapshotArrived(quint64 version)
+{
+    if (version <= snapshotVersion) {
+        return;
+    }
+    snapshotVersion = version;
+    for (View &view : views) {
+        view.dirty = true;
+    }
+    scheduleFrame();
+}
+
+void FrameScheduler::markDirty(QWidget *widget)
+{
+    for (View &view : views) {
+        if (view.widget == widget) {
+            view.dirty = true;
+            scheduleFrame();
+        }
+    }
+}
+
+bool FrameScheduler::eventFilter(QObject *watched, QEvent *event)
+{
+    // A view that went stale while hidden catches up when it is shown
+    if (event->type() == QEvent::Show) {
+        for (const View &view : views) {
+            if (view.widget == watched && view.dirty) {
+                scheduleFrame();
+            }
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void FrameScheduler::scheduleFrame()
+{
+    if (frameTimer->isActive()) {
+        return;
+    }
+    qint64 sinceLastFrame = QDateTime::currentMSecsSinceEpoch() - lastFrameMs;
+    frameTimer->start(int(qBound<qint64>(0, minFrameIntervalMs - sinceLastFrame, minFrameIntervalMs)));
+}
+
+void FrameScheduler::renderFrame()
+{
+    lastFrameMs = QDateTime::currentMSecsSinceEpoch();
+    for (View &view : views) {
+        if (view.dirty && view.widget && view.widget->isVisible()) {
+            view.dirty = false;
+            view.render();
+        }
+    }
+}
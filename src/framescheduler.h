@@ -0,0 +1,53 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <functional>
+
+class QTimer;
+class QWidget;
+
+// Single place that decides when the UI redraws. Each view registers the
+// widget that shows it and a render function; a new snapshot marks every
+// view dirty, and user actions (sorting, filtering) mark one. Frames are
+// coalesced to at most one per minimum frame interval, and a frame only
+// renders views that are both dirty and visible. Hidden views stay dirty
+// and render once when they are shown.
+class FrameScheduler : public QObject {
+    Q_OBJECT
+
+public:
+    explicit FrameScheduler(QObject *parent = nullptr);
+
+    void addView(QWidget *widget, std::function<void()> render);
+    void setMaxFrameRate(int framesPerSecond);
+
+    // Marks all views dirty if version is newer than the last one seen
+    void snapshotArrived(quint64 version);
+    void markDirty(QWidget *widget);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void renderFrame();
+
+private:
+    struct View {
+        QPointer<QWidget> widget;
+        std::function<void()> render;
+        bool dirty;
+    };
+
+    void scheduleFrame();
+
+    QVector<View> views;
+    QTimer *frameTimer;
+    quint64 snapshotVersion;
+    qint64 lastFrameMs;
+    int minFrameIntervalMs;
+};
+
+#endif // FRAMESCHEDULER_H
@@ -0,0 +1,347 @@
+#include "fuzzymatcher.h"
+#include "cpufeatures.h"
+#include <algorithm>
+
+namespace {
+
+// Scoring after fzf: every matched character earns SCORE_MATCH plus a
+// bonus for where it lands; gaps inside the match window cost points
+const int SCORE_MATCH = 16;
+const int SCORE_GAP_START = -3;
+const int SCORE_GAP_EXTENSION = -1;
+const int BONUS_BOUNDARY = 8;           // Start of text or after a separator
+const int BONUS_CONSECUTIVE = 4;
+const int BONUS_FIRST_CHAR_MULTIPLIER = 2;
+const int BONUS_BASENAME = 6;           // Hit in the name or the path's last component
+const int NO_MATCH = -1 << 30;
+// Zero bytes after the last field, so vector loads that start inside a
+// field never read past the buffer
+const int SIMD_PADDING = 32;
+
+enum class Kernel {
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+typedef const char *(*FindFunction)(const char *text, char c);
+typedef int (*PrefilterFunction)(const quint64 *masks, int count, quint64 need, int *out);
+
+Kernel activeKernel()
+{
+#if defined(CPU_HAVE_SSE2)
+    return cpufeatures::hasAvx2() ? Kernel::Avx2 : Kernel::Sse2;
+#else
+    return Kernel::Scalar;
+#endif
+}
+
+// First byte equal to c, or the field's terminating '\0'
+const char *findScalar(const char *text, char c)
+{
+    while (*text && *text != c) {
+        ++text;
+    }
+    return text;
+}
+
+int prefilterScalar(const quint64 *masks, int count, quint64 need, int *out)
+{
+    int found = 0;
+    for (int index = 0; index < count; ++index) {
+        if ((masks[index] & need) == need) {
+            out[found++] = index;
+        }
+    }
+    return found;
+}
+
+#if defined(CPU_HAVE_SSE2)
+const char *findSse2(const char *text, char c)
+{
+    const __m128i needle = _mm_set1_epi8(c);
+    const __m128i zero = _mm_setzero_si128();
+    for (;; text += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+        unsigned bits = unsigned(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, needle), _mm_cmpeq_epi8(bytes, zero))));
+        if (bits) {
+            return text + cpufeatures::countTrailingZeros(bits);
+        }
+    }
+}
+
+int prefilterSse2(const quint64 *masks, int count, quint64 need, int *out)
+{
+    // No 64-bit compare in SSE2: a mask passes when both 32-bit halves do
+    const __m128i required = _mm_set1_epi64x(qint64(need));
+    int found = 0;
+    int index = 0;
+    for (; index + 2 <= count; index += 2) {
+        __m128i pair = _mm_loadu_si128(reinterpret_cast<const __m128i *>(masks + index));
+        int bits = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(pair, required), required)));
+        if ((bits & 3) == 3) out[found++] = index;
+        if ((bits & 12) == 12) out[found++] = index + 1;
+    }
+    for (; index < count; ++index) {
+        if ((masks[index] & need) == need) {
+            out[found++] = index;
+        }
+    }
+    return found;
+}
+
+CPU_TARGET_AVX2 const char *findAvx2(const char *text, char c)
+{
+    const __m256i needle = _mm256_set1_epi8(c);
+    const __m256i zero = _mm256_setzero_si256();
+    for (;; text += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text));
+        unsigned bits = unsigned(_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, needle), _mm256_cmpeq_epi8(bytes, zero))));
+        if (bits) {
+            return text + cpufeatures::countTrailingZeros(bits);
+        }
+    }
+}
+
+CPU_TARGET_AVX2 int prefilterAvx2(const quint64 *masks, int count, quint64 need, int *out)
+{
+    const __m256i required = _mm256_set1_epi64x(qint64(need));
+    int found = 0;
+    int index = 0;
+    for (; index + 4 <= count; index += 4) {
+        __m256i quad = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(masks + index));
+        unsigned bits = unsigned(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(quad, required), required))));
+        while (bits) {
+            out[found++] = index + cpufeatures::countTrailingZeros(bits);
+            bits &= bits - 1;
+        }
+    }
+    for (; index < count; ++index) {
+        if ((masks[index] & need) == need) {
+            out[found++] = index;
+        }
+    }
+    return found;
+}
+#endif
+
+int characterBit(quint8 c)
+{
+    if (c >= 'a' && c <= 'z') return c - 'a';
+    if (c >= '0' && c <= '9') return 26 + (c - '0');
+    return 36 + c % 28;
+}
+
+bool isSeparator(char c)
+{
+    return c == '/' || c == '\\' || c == '_' || c == '-' || c == '.' || c == ' ' || c == ':';
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+int boundaryBonus(const char *field, const char *at)
+{
+    if (at == field || isSeparator(at[-1])) {
+        return BONUS_BOUNDARY;
+    }
+    // "python3", "x11": a digit run starting after letters is a word of its own
+    if (isDigit(*at) && !isDigit(at[-1])) {
+        return BONUS_BOUNDARY / 2;
+    }
+    return 0;
+}
+
+// fzf v1: find the pattern left to right, then walk back from the last hit
+// to the latest possible start, and score that (shortest) window
+int scoreField(const char *field, const char *basename, const char *pattern, int patternLength, FindFunction find)
+{
+    const char *at = field;
+    const char *last = nullptr;
+    for (int index = 0; index < patternLength; ++index) {
+        at = find(at, pattern[index]);
+        if (!*at) {
+            return NO_MATCH;
+        }
+        last = at++;
+    }
+    const char *start = last;
+    for (int index = patternLength - 1; index >= 0; --start) {
+        if (*start == pattern[index] && --index < 0) {
+            break;
+        }
+    }
+
+    int score = 0;
+    int consecutive = 0;
+    bool inGap = false;
+    int index = 0;
+    for (const char *c = start; c <= last; ++c) {
+        if (*c == pattern[index]) {
+            int bonus = boundaryBonus(field, c);
+            if (index == 0) {
+                bonus *= BONUS_FIRST_CHAR_MULTIPLIER;
+            }
+            if (consecutive > 0) {
+                bonus = std::max(bonus, BONUS_CONSECUTIVE);
+            }
+            if (c >= basename) {
+                bonus += BONUS_BASENAME;
+            }
+            score += SCORE_MATCH + bonus;
+            ++consecutive;
+            inGap = false;
+            ++index;
+        } else {
+            score += inGap ? SCORE_GAP_EXTENSION : SCORE_GAP_START;
+            inGap = true;
+            consecutive = 0;
+        }
+    }
+    return score;
+}
+
+// Stored for candidate characters outside Latin-1 (and NUL, which ends a
+// field); a pattern with such a character matches nothing, so they never
+// match each other
+const quint8 OTHER_CHARACTER = 1;
+
+// Case-insensitive Latin-1 byte, or -1 for characters outside it
+int foldCharacter(QChar c)
+{
+    ushort code = c.unicode();
+    if (code < 128) {
+        if (code >= 'A' && code <= 'Z') return code + ('a' - 'A');
+        return code ? code : -1;
+    }
+    ushort folded = c.toCaseFolded().unicode();
+    return folded < 256 ? folded : -1;
+}
+
+} // namespace
+
+void FuzzyMatcher::clear()
+{
+    text.clear();
+    nameStart.clear();
+    pathStart.clear();
+    basenameStart.clear();
+    masks.clear();
+    nameMasks.clear();
+    pathMasks.clear();
+}
+
+void FuzzyMatcher::reserve(int candidates, int bytes)
+{
+    text.reserve(bytes + 2 * candidates + SIMD_PADDING);
+    nameStart.reserve(candidates);
+    pathStart.reserve(candidates);
+    basenameStart.reserve(candidates);
+    masks.reserve(candidates);
+    nameMasks.reserve(candidates);
+    pathMasks.reserve(candidates);
+}
+
+void FuzzyMatcher::add(const QString &name, const QString &path)
+{
+    if (!text.isEmpty()) {
+        text.chop(SIMD_PADDING);
+    }
+    auto append = [this](const QString &field) {
+        quint64 mask = 0;
+        for (QChar c : field) {
+            const int byte = foldCharacter(c);
+            const quint8 folded = byte < 0 ? OTHER_CHARACTER : quint8(byte);
+            text.append(char(folded));
+            mask |= quint64(1) << characterBit(folded);
+        }
+        text.append('\0');
+        return mask;
+    };
+
+    nameStart.append(quint32(text.size()));
+    nameMasks.append(append(name));
+    pathStart.append(quint32(text.size()));
+    int separator = std::max(path.lastIndexOf('/'), path.lastIndexOf('\\'));
+    basenameStart.append(quint32(text.size() + separator + 1));
+    pathMasks.append(append(path));
+    masks.append(nameMasks.last() | pathMasks.last());
+    text.append(SIMD_PADDING, '\0');
+}
+
+QVector<FuzzyMatcher::Match> FuzzyMatcher::rank(const QString &pattern, int limit) const
+{
+    QVector<Match> matches;
+    QByteArray folded;
+    folded.reserve(pattern.size());
+    quint64 need = 0;
+    for (QChar c : pattern) {
+        const int byte = foldCharacter(c);
+        if (byte < 0 || byte == OTHER_CHARACTER) {
+            return matches;
+        }
+        folded.append(char(byte));
+        need |= quint64(1) << characterBit(quint8(byte));
+    }
+    if (folded.isEmpty() || masks.isEmpty()) {
+        return matches;
+    }
+
+    FindFunction find = findScalar;
+    PrefilterFunction prefilter = prefilterScalar;
+#if defined(CPU_HAVE_SSE2)
+    switch (activeKernel()) {
+    case Kernel::Avx2: find = findAvx2; prefilter = prefilterAvx2; break;
+    case Kernel::Sse2: find = findSse2; prefilter = prefilterSse2; break;
+    case Kernel::Scalar: break;
+    }
+#endif
+
+    QVector<int> survivors(masks.size());
+    survivors.resize(prefilter(masks.constData(), masks.size(), need, survivors.data()));
+
+    const char *base = text.constData();
+    matches.reserve(survivors.size());
+    for (int index : survivors) {
+        int score = NO_MATCH;
+        if ((nameMasks[index] & need) == need) {
+            // The whole name counts as a basename
+            const char *name = base + nameStart[index];
+            score = scoreField(name, name, folded.constData(), folded.size(), find);
+        }
+        if ((pathMasks[index] & need) == need) {
+            score = std::max(score, scoreField(base + pathStart[index], base + basenameStart[index],
+                                               folded.constData(), folded.size(), find));
+        }
+        if (score != NO_MATCH) {
+            matches.append(Match{index, score});
+        }
+    }
+
+    // Higher score first, then the shorter name, then insertion order
+    auto better = [this](const Match &a, const Match &b) {
+        if (a.score != b.score) return a.score > b.score;
+        quint32 lengthA = pathStart[a.index] - nameStart[a.index];
+        quint32 lengthB = pathStart[b.index] - nameStart[b.index];
+        return lengthA != lengthB ? lengthA < lengthB : a.index < b.index;
+    };
+    if (limit >= 0 && limit < matches.size()) {
+        std::partial_sort(matches.begin(), matches.begin() + limit, matches.end(), better);
+        matches.resize(limit);
+    } else {
+        std::sort(matches.begin(), matches.end(), better);
+    }
+    return matches;
+}
+
+const char *FuzzyMatcher::kernelName()
+{
+    switch (activeKernel()) {
+    case Kernel::Avx2: return "avx2";
+    case Kernel::Sse2: return "sse2";
+    case Kernel::Scalar: break;
+    }
+    return "scalar";
+}
@@ -0,0 +1,47 @@
+#ifndef FUZZYMATCHER_H
+#define FUZZYMATCHER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+// fzf-style fuzzy matching over process names and paths: the pattern's
+// characters must appear in order, and matches are scored by how tight,
+// consecutive and word-aligned they are, with a bonus for hits in the name
+// or the path's basename.
+//
+// Candidates are folded (case-insensitive, Latin-1) into one packed
+// buffer; a pattern character outside Latin-1 matches nothing. Each also gets a 64-bit mask of the characters it contains, so a
+// keystroke first discards candidates missing any pattern character with a
+// SIMD scan of the masks, then scores the survivors, finding each pattern
+// character with a SIMD byte scan. AVX2 is used when the CPU has it, SSE2
+// otherwise, and plain C++ elsewhere.
+class FuzzyMatcher {
+public:
+    struct Match {
+        int index;      // Order in which the candidate was added
+        int score;
+    };
+
+    void clear();
+    void reserve(int candidates, int bytes);
+    void add(const QString &name, const QString &path = QString());
+    int size() const { return masks.size(); }
+
+    // Matching candidates, best first; all of them when limit < 0
+    QVector<Match> rank(const QString &pattern, int limit = -1) const;
+
+    // "avx2", "sse2" or "scalar"
+    static const char *kernelName();
+
+private:
+    QByteArray text;                // Folded fields, each ending with '\0'
+    QVector<quint32> nameStart;
+    QVector<quint32> pathStart;
+    QVector<quint32> basenameStart; // Within the path
+    QVector<quint64> masks;         // Characters in name or path, for the prefilter
+    QVector<quint64> nameMasks;     // Skip scoring a field that cannot match
+    QVector<quint64> pathMasks;
+};
+
+#endif // FUZZYMATCHER_H
@@ -0,0 +1,262 @@
+#include "healthruleengine.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+
+const int DEFAULT_ALERT_CAPACITY = 500;
+
+QString formatMetric(ProcessColumns::Metric metric, double value)
+{
+    switch (metric) {
+    case ProcessColumns::Cpu: return QString("CPU %1%").arg(value, 0, 'f', 1);
+    case ProcessColumns::MemoryKb: return QString("Memory %1 MB").arg(value / 1024.0, 0, 'f', 0);
+    case ProcessColumns::PssKb: return QString("PSS %1 MB").arg(value / 1024.0, 0, 'f', 0);
+    case ProcessColumns::SwapKb: return QString("Swap %1 MB").arg(value / 1024.0, 0, 'f', 0);
+    case ProcessColumns::DiskMBps: return QString("Disk %1 MB/s").arg(value, 0, 'f', 1);
+    case ProcessColumns::NetworkMBps: return QString("Network %1 MB/s").arg(value, 0, 'f', 1);
+    case ProcessColumns::CpuZScore: return QString("CPU %1 sigma above usual").arg(value, 0, 'f', 1);
+    case ProcessColumns::MetricCount: break;
+    }
+    return QString::number(value);
+}
+
+} // namespace
+
+HealthRuleEngine::HealthRuleEngine() :
+    ruleList(defaultRules()),
+    ringCapacity(DEFAULT_ALERT_CAPACITY),
+    ringHead(0),
+    alertSequence(0),
+    tick(0),
+    activeAlerts(0)
+{
+    states.resize(ruleList.size());
+}
+
+QVector<HealthRule> HealthRuleEngine::defaultRules()
+{
+    QVector<HealthRule> defaults;
+
+    HealthRule cpu;
+    cpu.name = "Sustained High CPU Usage";
+    cpu.metric = ProcessColumns::Cpu;
+    cpu.raiseAbove = 80.0;
+    cpu.clearBelow = 60.0;
+    cpu.sustainTicks = 5;
+    cpu.cooldownTicks = 60;
+    cpu.severity = "High";
+    cpu.recommendation = "Consider closing unnecessary applications or restarting the process.";
+    defaults.append(cpu);
+
+    HealthRule memory;
+    memory.name = "High Memory Usage";
+    memory.metric = ProcessColumns::MemoryKb;
+    memory.raiseAbove = 1024.0 * 1024.0;    // 1 GB
+    memory.clearBelow = 900.0 * 1024.0;
+    memory.sustainTicks = 3;
+    memory.cooldownTicks = 300;
+    memory.severity = "Medium";
+    memory.recommendation = "Check for memory leaks or consider increasing system memory.";
+    defaults.append(memory);
+
+    HealthRule swap;
+    swap.name = "Heavily Swapped Out";
+    swap.metric = ProcessColumns::SwapKb;
+    swap.raiseAbove = 512.0 * 1024.0;
+    swap.clearBelow = 256.0 * 1024.0;
+    swap.sustainTicks = 5;
+    swap.cooldownTicks = 300;
+    swap.severity = "Medium";
+    swap.recommendation = "The process will stall when touching swapped pages. Free memory or restart it.";
+    defaults.append(swap);
+
+    HealthRule disk;
+    disk.name = "High Disk Usage";
+    disk.metric = ProcessColumns::DiskMBps;
+    disk.raiseAbove = 10.0;
+    disk.clearBelow = 5.0;
+    disk.sustainTicks = 5;
+    disk.cooldownTicks = 60;
+    disk.severity = "Medium";
+    disk.recommendation = "Check for disk-intensive operations.";
+    defaults.append(disk);
+
+    HealthRule anomaly;
+    anomaly.name = "Unusual CPU Activity";
+    anomaly.metric = ProcessColumns::CpuZScore;
+    anomaly.raiseAbove = 6.0;
+    anomaly.clearBelow = 3.0;
+    anomaly.sustainTicks = 3;
+    anomaly.cooldownTicks = 120;
+    anomaly.severity = "Medium";
+    anomaly.recommendation = "CPU usage is far above what this process normally uses.";
+    defaults.append(anomaly);
+
+    return defaults;
+}
+
+void HealthRuleEngine::setRules(const QVector<HealthRule> &newRules)
+{
+    ruleList = newRules;
+    states.clear();
+    states.resize(ruleList.size());
+    activeAlerts = 0;
+}
+
+bool HealthRuleEngine::loadRules(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QJsonParseError error;
+    QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (document.isNull()) {
+        qWarning() << "Failed to parse health rules" << path << error.errorString();
+        return false;
+    }
+
+    QVector<HealthRule> loaded;
+    const QJsonArray array = document.object().value("rules").toArray();
+    for (const QJsonValue &value : array) {
+        QJsonObject object = value.toObject();
+        HealthRule rule;
+        bool ok = false;
+        rule.name = object.value("name").toString();
+        rule.metric = ProcessColumns::metricFromName(object.value("metric").toString(), &ok);
+        if (!ok || rule.name.isEmpty()) {
+            qWarning() << "Skipping invalid health rule" << rule.name;
+            continue;
+        }
+        rule.raiseAbove = object.value("raiseAbove").toDouble();
+        rule.clearBelow = object.value("clearBelow").toDouble(rule.raiseAbove);
+        rule.sustainTicks = qBound(1, object.value("sustainTicks").toInt(1), 65535);
+        rule.cooldownTicks = qMax(0, object.value("cooldownTicks").toInt(0));
+        rule.severity = object.value("severity").toString("Medium");
+        rule.recommendation = object.value("recommendation").toString();
+        rule.includeSystem = object.value("includeSystem").toBool(false);
+        loaded.append(rule);
+    }
+    if (loaded.isEmpty()) {
+        qWarning() << "No usable health rules in" << path;
+        return false;
+    }
+    setRules(loaded);
+    return true;
+}
+
+void HealthRuleEngine::evaluate(const ProcessColumns &columns)
+{
+    ++tick;
+    const int rows = columns.rows;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    systemRow.resize(rows);
+    const ProcessType *types = columns.type.constData();
+    quint8 *isSystem = systemRow.data();
+    for (int row = 0; row < rows; ++row) {
+        isSystem[row] = types[row] == ProcessType::System;
+    }
+
+    int active = 0;
+    for (int index = 0; index < ruleList.size(); ++index) {
+        const HealthRule &rule = ruleList[index];
+        RuleState &state = states[index];
+        remapColumn(state.sustained, columns.previousRow, quint16(0));
+        remapColumn(state.active, columns.previousRow, quint8(0));
+        remapColumn(state.quietUntil, columns.previousRow, qint32(0));
+
+        const double *values = columns.column(rule.metric);
+        const double raiseAbove = rule.raiseAbove;
+        const double clearBelow = rule.clearBelow;
+        const quint8 excludeSystem = rule.includeSystem ? 0 : 1;
+        const quint16 sustainTicks = quint16(rule.sustainTicks);
+        quint16 *sustained = state.sustained.data();
+        quint8 *isActive = state.active.data();
+        qint32 *quietUntil = state.quietUntil.data();
+
+        // Branch-free pass: count consecutive snapshots above the threshold
+        // and flag rows whose alert state has to change
+        int pending = 0;
+        for (int row = 0; row < rows; ++row) {
+            const int excluded = isSystem[row] & excludeSystem;
+            const int above = (values[row] > raiseAbove) & (excluded ^ 1);
+            const int next = sustained[row] + 1;
+            sustained[row] = quint16((next < 0xffff ? next : 0xffff) * above);
+            const int raise = (isActive[row] ^ 1) & (sustained[row] >= sustainTicks) & (quietUntil[row] <= tick);
+            const int clear = isActive[row] & ((values[row] < clearBelow) | excluded);
+            pending += raise | clear;
+        }
+        if (pending == 0) {
+            for (int row = 0; row < rows; ++row) {
+                active += isActive[row];
+            }
+            continue;
+        }
+
+        for (int row = 0; row < rows; ++row) {
+            const bool excluded = isSystem[row] && excludeSystem;
+            HealthAlert alert;
+            if (!isActive[row] && sustained[row] >= sustainTicks && quietUntil[row] <= tick) {
+                isActive[row] = 1;
+                alert.cleared = false;
+            } else if (isActive[row] && (values[row] < clearBelow || excluded)) {
+                isActive[row] = 0;
+                quietUntil[row] = tick + rule.cooldownTicks;
+                alert.cleared = true;
+            } else {
+                active += isActive[row];
+                continue;
+            }
+            active += isActive[row];
+            alert.timestamp = now;
+            alert.rule = rule.name;
+            alert.severity = rule.severity;
+            alert.pid = columns.pid[row];
+            alert.processName = columns.name[row];
+            alert.value = values[row];
+            alert.detail = formatMetric(rule.metric, values[row]);
+            alert.recommendation = rule.recommendation;
+            addAlert(alert);
+        }
+    }
+    activeAlerts = active;
+}
+
+void HealthRuleEngine::addAlert(const HealthAlert &alert)
+{
+    if (ring.size() < ringCapacity) {
+        ring.append(alert);
+    } else {
+        ring[ringHead] = alert;
+        ringHead = (ringHead + 1) % ringCapacity;
+    }
+    ++alertSequence;
+}
+
+QVector<HealthAlert> HealthRuleEngine::alerts() const
+{
+    QVector<HealthAlert> ordered;
+    ordered.reserve(ring.size());
+    // ringHead is the oldest entry once the ring has wrapped
+    for (int offset = ring.size() - 1; offset >= 0; --offset) {
+        ordered.append(ring[(ringHead + offset) % ring.size()]);
+    }
+    return ordered;
+}
+
+void HealthRuleEngine::setCapacity(int capacity)
+{
+    QVector<HealthAlert> ordered = alerts();
+    ringCapacity = qMax(1, capacity);
+    ring.clear();
+    ringHead = 0;
+    for (int index = qMin(int(ordered.size()), ringCapacity) - 1; index >= 0; --index) {
+        ring.append(ordered[index]);
+    }
+}
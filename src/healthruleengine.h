@@ -0,0 +1,75 @@
+#ifndef HEALTHRULEENGINE_H
+#define HEALTHRULEENGINE_H
+
+#include <QString>
+#include <QVector>
+#include "processcolumns.h"
+
+// Raised when a metric stays above raiseAbove for sustainTicks snapshots and
+// cleared once it drops below clearBelow. The gap between the two is the
+// hysteresis band; cooldownTicks suppresses re-raising a cleared alert for
+// the same process so a flapping value cannot flood the stream.
+struct HealthRule {
+    QString name;
+    ProcessColumns::Metric metric = ProcessColumns::Cpu;
+    double raiseAbove = 0.0;
+    double clearBelow = 0.0;
+    int sustainTicks = 1;
+    int cooldownTicks = 0;
+    QString severity;        // "High" or "Medium", as in the health check
+    QString recommendation;
+    bool includeSystem = false;  // Also watch ProcessType::System
+};
+
+struct HealthAlert {
+    qint64 timestamp = 0;    // ms since epoch
+    QString rule;
+    QString severity;
+    qint64 pid = 0;          // 0 for system-wide alerts
+    QString processName;
+    double value = 0.0;
+    QString detail;          // Formatted value, e.g. "CPU 93.1%"
+    bool cleared = false;
+    QString recommendation;
+};
+
+// Evaluates every rule against every process on each snapshot and keeps
+// the most recent alerts in a fixed-size ring.
+class HealthRuleEngine {
+public:
+    HealthRuleEngine();
+
+    void setRules(const QVector<HealthRule> &newRules);
+    const QVector<HealthRule>& rules() const { return ruleList; }
+    bool loadRules(const QString &path);
+    static QVector<HealthRule> defaultRules();
+
+    void evaluate(const ProcessColumns &columns);
+    void addAlert(const HealthAlert &alert);
+
+    // Newest first
+    QVector<HealthAlert> alerts() const;
+    // Increments whenever an alert is added
+    quint64 sequence() const { return alertSequence; }
+    int activeCount() const { return activeAlerts; }
+    void setCapacity(int capacity);
+
+private:
+    struct RuleState {
+        QVector<quint16> sustained;   // Consecutive snapshots above raiseAbove
+        QVector<quint8> active;
+        QVector<qint32> quietUntil;   // Tick before which the rule may not re-raise
+    };
+
+    QVector<HealthRule> ruleList;
+    QVector<RuleState> states;
+    QVector<quint8> systemRow;        // 1 for ProcessType::System rows
+    QVector<HealthAlert> ring;
+    int ringCapacity;
+    int ringHead;
+    quint64 alertSequence;
+    qint32 tick;
+    int activeAlerts;
+};
+
+#endif // HEALTHRULEENGINE_H
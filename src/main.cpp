@@ -1,10 +1,133 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QScopedPointer>
+#include <QSysInfo>
+#include <cstring>
 #include "mainwindow.h"
+#include "metricsexporter.h"
+#include "snapshotpublisher.h"
+#include "fleetagent.h"
+#include "fleetaggregator.h"
+
+namespace {
+
+// Agents run headless, so they must not create a GUI application
+bool isAgentMode(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--agent") == 0 || std::strncmp(argv[i], "--agent=", 8) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
 
 int main(int argc, char *argv[])
 {
-    QApplication app(argc, argv);
+    bool agentMode = isAgentMode(argc, argv);
+    QScopedPointer<QCoreApplication> app(agentMode ? new QCoreApplication(argc, argv) : new QApplication(argc, argv));
+    QCoreApplication::setApplicationName("ProcManager");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption metricsPortOption("metrics-port",
+        "Serve OpenMetrics on http://127.0.0.1:<port>/metrics (disabled by default).", "port", "0");
+    QCommandLineOption metricsMaxProcessesOption("metrics-max-processes",
+        "Maximum number of processes exported as separate series.", "count", "100");
+    QCommandLineOption publishShmOption("publish-shm",
+        "Publish each snapshot into a POSIX shared-memory segment for SnapshotReader clients.", "name");
+    QCommandLineOption shmCapacityOption("shm-capacity",
+        "Maximum number of processes per shared-memory snapshot.", "count", "8192");
+    QCommandLineOption agentOption("agent",
+        "Run headless and stream snapshots to aggregators on <endpoint> (host:port, port or unix:path).", "endpoint");
+    QCommandLineOption agentNameOption("agent-name",
+        "Host name reported by the agent (defaults to the machine host name).", "name");
+    QCommandLineOption agentMaxProcessesOption("agent-max-processes",
+        "Number of top CPU processes the agent streams.", "count", "2000");
+    QCommandLineOption syntheticOption("synthetic",
+        "Stream <count> generated processes instead of real ones (agent mode).", "count");
+    QCommandLineOption syntheticSeedOption("synthetic-seed",
+        "Seed for generated processes.", "seed", "1");
+    QCommandLineOption aggregateOption("aggregate",
+        "Show a Fleet view merging the agents at these comma-separated endpoints.", "endpoints");
+    QCommandLineOption fleetMaxProcessesOption("fleet-max-processes",
+        "Maximum processes kept per aggregated host.", "count", "5000");
+    QCommandLineOption maxFpsOption("max-fps",
+        "Maximum number of UI redraws per second.", "rate", "30");
+    parser.addOption(metricsPortOption);
+    parser.addOption(metricsMaxProcessesOption);
+    parser.addOption(publishShmOption);
+    parser.addOption(shmCapacityOption);
+    parser.addOption(agentOption);
+    parser.addOption(agentNameOption);
+    parser.addOption(agentMaxProcessesOption);
+    parser.addOption(syntheticOption);
+    parser.addOption(syntheticSeedOption);
+    parser.addOption(aggregateOption);
+    parser.addOption(fleetMaxProcessesOption);
+    parser.addOption(maxFpsOption);
+    parser.process(*app);
+
+    if (agentMode) {
+        fleet::Endpoint endpoint;
+        if (!fleet::Endpoint::parse(parser.value(agentOption), endpoint)) {
+            qCritical() << "Invalid agent endpoint" << parser.value(agentOption);
+            return 1;
+        }
+        QString hostName = parser.isSet(agentNameOption) ? parser.value(agentNameOption) : QSysInfo::machineHostName();
+        FleetAgent *agent = new FleetAgent(hostName, app.data());
+        if (!agent->listen(endpoint)) {
+            return 1;
+        }
+        if (parser.isSet(syntheticOption)) {
+            SyntheticProcessSource *source = new SyntheticProcessSource(parser.value(syntheticOption).toInt(),
+                parser.value(syntheticSeedOption).toUInt(), app.data());
+            QObject::connect(source, &SyntheticProcessSource::snapshot, agent, &FleetAgent::publish);
+            source->start(1000);
+        } else {
+            SystemInfo *systemInfo = new SystemInfo(app.data());
+            int maxProcesses = parser.value(agentMaxProcessesOption).toInt();
+            QObject::connect(systemInfo, &SystemInfo::dataUpdated, agent, [=]() {
+                agent->publish(fleet::fromColumns(systemInfo->getProcessColumns(), maxProcesses),
+                               systemInfo->getCpuUsage(), systemInfo->getMemoryUsage());
+            });
+        }
+        return app->exec();
+    }
+
     MainWindow window;
+    window.setMaxFrameRate(parser.value(maxFpsOption).toInt());
+
+    quint16 metricsPort = parser.value(metricsPortOption).toUShort();
+    if (metricsPort > 0) {
+        MetricsExporter *exporter = new MetricsExporter(window.getSystemInfo(), &window);
+        exporter->setMaxProcesses(parser.value(metricsMaxProcessesOption).toInt());
+        exporter->listen(metricsPort);
+    }
+
+    if (parser.isSet(publishShmOption)) {
+        SnapshotPublisher *publisher = new SnapshotPublisher(window.getSystemInfo(), &window);
+        publisher->open(parser.value(publishShmOption), parser.value(shmCapacityOption).toInt());
+    }
+
+    if (parser.isSet(aggregateOption)) {
+        FleetAggregator *aggregator = new FleetAggregator(&window);
+        aggregator->setMaxProcessesPerHost(parser.value(fleetMaxProcessesOption).toInt());
+        for (const QString &text : parser.value(aggregateOption).split(',', Qt::SkipEmptyParts)) {
+            fleet::Endpoint endpoint;
+            if (fleet::Endpoint::parse(text.trimmed(), endpoint)) {
+                aggregator->addEndpoint(endpoint);
+            } else {
+                qWarning() << "Ignoring invalid fleet endpoint" << text;
+            }
+        }
+        window.addFleetView(aggregator);
+    }
+
     window.show();
-    return app.exec();
-} 
\ No newline at end of file
+    return app->exec();
+}
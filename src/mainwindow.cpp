@@ -1,4 +1,21 @@
 #include "mainwindow.h"
+#include "storagepanel.h"
+#include "cpuheatmapwidget.h"
+#include "threadpanel.h"
+#include "pressurepanel.h"
+#include "alertpanel.h"
+#include "efficiencypanel.h"
+#include "affinitydialog.h"
+#include "processaffinity.h"
+#include "schedulingdialog.h"
+#include "fleetpanel.h"
+#include "processtablemodel.h"
+#include "processitemdelegate.h"
+#include "framescheduler.h"
+#include "processpickermodel.h"
+#include "columnkernels.h"
+#include "processownership.h"
+#include <QSplitter>
 #include <QMainWindow>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -15,6 +32,7 @@
 #include <QIcon>
 #include <QLineEdit>
 #include <QComboBox>
+#include <QCompleter>
 #include <QColor>
 #include <QTimer>
 #include <QDateTime>
@@ -25,43 +43,66 @@
 #include <QFileDialog>
 #include <QDialogButtonBox>
 #include <QThread>
+#include <algorithm>
+#include <climits>
+#include <iterator>
+#include <numeric>
+#ifdef Q_OS_WIN
 #include <windows.h>
 #include <tlhelp32.h>
+#else
+#include <QFile>
+#include <unistd.h>
+#endif
 #include <QScrollArea>
 #include <QTextEdit>
 
 // Performance optimization constants
-const int UPDATE_INTERVAL_MS = 1000;  // Update UI every 1 second
+const int UPDATE_INTERVAL_MS = 1000;  // Sample the system every 1 second
 const int MAX_PROCESS_ROWS = 1000;    // Maximum number of processes to display
-const int CACHE_DURATION_MS = 5000;   // Cache process data for 5 seconds
-
-// Helper: Group names for process types
-static QMap<ProcessType, QString> groupNames = {
-    {ProcessType::Application, "Apps"},
-    {ProcessType::Background, "Background processes"},
-    {ProcessType::System, "System processes"},
-    {ProcessType::Unknown, "Other"}
-};
-
-// Helper: Group order
-static QList<ProcessType> groupOrder = {
-    ProcessType::Application,
-    ProcessType::Background,
-    ProcessType::System,
-    ProcessType::Unknown
-};
-
-// Helper: Store group expanded/collapsed state
-QMap<ProcessType, bool> groupExpanded = {
-    {ProcessType::Application, true},
-    {ProcessType::Background, true},
-    {ProcessType::System, true},
-    {ProcessType::Unknown, true}
-};
-
-// Global (static) variable to hold the sorted process list (if sorting is active)
-static QVector<ProcessInfo> sortedProcesses;
 
+// Values of currentSortColumn besides the table's columns
+const int NO_SORT = -1;
+const int PID_SORT = -2;    // There is no PID column
+
+namespace {
+
+// Search text that is all digits as a number, with power = 10^length so
+// leading zeros count
+bool parsePidText(const QString &text, qint64 &digits, qint64 &power)
+{
+    if (text.size() > 18) {
+        return false;
+    }
+    digits = 0;
+    power = 1;
+    for (QChar c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        digits = digits * 10 + (c.unicode() - '0');
+        power *= 10;
+    }
+    return true;
+}
+
+// The decimal pid contains the digits, without formatting it
+bool pidContains(qint64 pid, qint64 digits, qint64 power)
+{
+    qint64 rest = pid;
+    do {
+        // The low digits of rest must be as many as were typed
+        if (rest % power == digits && (rest >= power / 10 || power == 10)) {
+            return true;
+        }
+        rest /= 10;
+    } while (rest > 0);
+    return false;
+}
+
+} // namespace
+
+#ifdef Q_OS_WIN
 // Helper: Enable SeDebugPrivilege for the current process
 bool enableDebugPrivilege() {
     HANDLE hToken;
@@ -75,10 +116,12 @@ bool enableDebugPrivilege() {
     CloseHandle(hToken);
     return (result && GetLastError() == ERROR_SUCCESS);
 }
+#endif
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
     tabWidget(nullptr),
     processTable(nullptr),
+    processModel(nullptr),
     cpuBar(nullptr),
     memoryBar(nullptr),
     diskBar(nullptr),
@@ -89,18 +132,31 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
     memSumLabel(nullptr),
     diskSumLabel(nullptr),
     netSumLabel(nullptr),
+    storagePanel(nullptr),
+    cpuHeatmap(nullptr),
+    cpuCoresLabel(nullptr),
+    threadPanel(nullptr),
+    pressurePanel(nullptr),
+    alertPanel(nullptr),
+    efficiencyPanel(nullptr),
     sortMemoryButton(nullptr),
     sortCPUButton(nullptr),
     sortPIDButton(nullptr),
     endTaskButton(nullptr),
+    affinityButton(nullptr),
+    schedulingButton(nullptr),
     searchBox(nullptr),
+    searchMatcherVersion(0),
     processTypeFilter(nullptr),
+    groupBySelect(nullptr),
     processSelect(nullptr),
+    pickerModel(nullptr),
+    pickerMatches(nullptr),
     systemInfo(nullptr),
-    updateTimer(nullptr),
-    processCache{QVector<ProcessInfo>(), 0, 0},
-    lastUpdateTime(0),
-    currentSortColumn(-1),
+    frameScheduler(nullptr),
+    viewStack(nullptr),
+    sidebarLayout(nullptr),
+    currentSortColumn(NO_SORT),
     currentSortOrder(Qt::AscendingOrder),
     isSortingEnabled(true),
     currentProcessTypeFilter(ProcessType::Unknown),
@@ -111,6 +167,7 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
         // Initialize system info with update interval
         systemInfo = new SystemInfo(this);
         systemInfo->setUpdateInterval(UPDATE_INTERVAL_MS);
+        frameScheduler = new FrameScheduler(this);
 
         // Set application-wide style
         setApplicationStyle();
@@ -129,11 +186,15 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent),
         setWindowTitle("ProcManager");
         resize(1000, 700);
 
-        // Now connect signals and start timers (after UI is ready)
-        connect(systemInfo, &SystemInfo::dataUpdated, this, &MainWindow::onDataUpdated);
-        updateTimer = new QTimer(this);
-        connect(updateTimer, &QTimer::timeout, this, &MainWindow::updateUI);
-        updateTimer->start(UPDATE_INTERVAL_MS);
+        // Every view redraws through the frame scheduler, once per snapshot
+        // and only while it is on screen (after UI is ready)
+        frameScheduler->addView(processTable, [this]() { updateProcessTable(); });
+        frameScheduler->addView(cpuSumLabel->parentWidget(), [this]() { updateResourceSummary(); });
+        frameScheduler->addView(cpuBar->parentWidget(), [this]() { updatePerformanceView(); });
+        frameScheduler->addView(alertPanel, [this]() { updateTroubleshootView(); });
+        connect(systemInfo, &SystemInfo::dataUpdated, this, [this]() {
+            frameScheduler->snapshotArrived(systemInfo->getSnapshotVersion());
+        });
     } catch (const std::exception& e) {
         QMessageBox::critical(this, "Error", QString("Failed to initialize: %1").arg(e.what()));
     }
@@ -144,6 +205,50 @@ MainWindow::~MainWindow()
     // Qt's parent-child relationship will handle memory cleanup
 }
 
+QPushButton* MainWindow::addSidebarButton(const QString &title)
+{
+    QPushButton *btn = new QPushButton(title);
+    btn->setCheckable(true);
+    btn->setStyleSheet(R"(
+        QPushButton {
+            background: transparent;
+            color: #fff;
+            text-align: left;
+            padding: 10px 20px;
+            border: none;
+            font-size: 15px;
+        }
+        QPushButton:checked {
+            background: #252525;
+            border-left: 4px solid #0078d4;
+            color: #0078d4;
+        }
+        QPushButton:hover {
+            background: #232323;
+        }
+    )");
+    // Buttons sit above the trailing stretch, in view order
+    int index = sidebarButtons.size();
+    sidebarLayout->insertWidget(index, btn);
+    sidebarButtons.append(btn);
+    connect(btn, &QPushButton::clicked, this, [this, index]() { showView(index); });
+    return btn;
+}
+
+void MainWindow::showView(int index)
+{
+    for (int i = 0; i < sidebarButtons.size(); ++i) {
+        sidebarButtons[i]->setChecked(i == index);
+    }
+    viewStack->setCurrentIndex(index);
+}
+
+void MainWindow::addFleetView(FleetAggregator *aggregator)
+{
+    viewStack->addWidget(new FleetPanel(aggregator));
+    addSidebarButton("Fleet");
+}
+
 void MainWindow::setApplicationStyle()
 {
     try {
@@ -279,38 +384,16 @@ void MainWindow::setupUI()
         // --- Sidebar ---
         QWidget *sidebar = new QWidget();
         sidebar->setFixedWidth(160);
-        QVBoxLayout *sidebarLayout = new QVBoxLayout(sidebar);
+        sidebarLayout = new QVBoxLayout(sidebar);
         sidebarLayout->setSpacing(10);
         sidebarLayout->setContentsMargins(0, 20, 0, 0);
 
-        // Sidebar buttons: Only Processes and Performance
-        QStringList sidebarItems = {"Processes", "Performance", "Troubleshoot"};
-        QList<QPushButton*> sidebarButtons;
+        // Sidebar buttons, one per view in the stacked widget
+        const QStringList sidebarItems = {"Processes", "Performance", "Troubleshoot"};
         for (const QString &item : sidebarItems) {
-            QPushButton *btn = new QPushButton(item);
-            btn->setCheckable(true);
-            btn->setStyleSheet(R"(
-                QPushButton {
-                    background: transparent;
-                    color: #fff;
-                    text-align: left;
-                    padding: 10px 20px;
-                    border: none;
-                    font-size: 15px;
-                }
-                QPushButton:checked {
-                    background: #252525;
-                    border-left: 4px solid #0078d4;
-                    color: #0078d4;
-                }
-                QPushButton:hover {
-                    background: #232323;
-                }
-            )");
-            if (item == "Processes") btn->setChecked(true); // Default selection
-            sidebarLayout->addWidget(btn);
-            sidebarButtons.append(btn);
+            addSidebarButton(item);
         }
+        sidebarButtons[0]->setChecked(true); // Default selection
         sidebarLayout->addStretch();
 
         // --- Main Content (Stacked) ---
@@ -320,7 +403,7 @@ void MainWindow::setupUI()
         mainVLayout->setContentsMargins(0, 0, 0, 0);
 
         // Stacked widget for switching views
-        QStackedWidget *stackedWidget = new QStackedWidget(mainContent);
+        viewStack = new QStackedWidget(mainContent);
 
         // --- Processes View ---
         QWidget *processesView = new QWidget();
@@ -352,6 +435,26 @@ void MainWindow::setupUI()
         searchBox = searchBar; // assign to member for filtering
         connect(searchBar, &QLineEdit::textChanged, this, &MainWindow::onSearchTextChanged);
         topBarLayout->addWidget(searchBar);
+        groupBySelect = new QComboBox();
+        for (int key = 0; key < ProcessGrouping::KeyCount; ++key) {
+            // Containers are read from cgroups, which only Linux has
+            if ((key == ProcessGrouping::ByUser && !ProcessOwnership::hasUsers())
+                || (key == ProcessGrouping::ByContainer && !ProcessOwnership::hasContainers())) {
+                continue;
+            }
+            groupBySelect->addItem("Group by " + ProcessGrouping::keyName(ProcessGrouping::Key(key)).toLower(), key);
+        }
+        groupBySelect->setStyleSheet(R"(
+            QComboBox {
+                background: #232323;
+                color: #fff;
+                border-radius: 6px;
+                border: 1px solid #333;
+                padding: 6px 12px;
+            }
+        )");
+        connect(groupBySelect, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onGroupByChanged);
+        topBarLayout->addWidget(groupBySelect);
         topBarLayout->addStretch();
         QPushButton *runTaskBtn = new QPushButton("Run new task");
         endTaskButton = new QPushButton("End task");
@@ -378,8 +481,24 @@ void MainWindow::setupUI()
         )");
         connect(efficiencyBtn, &QPushButton::clicked, this, &MainWindow::toggleEfficiencyMode);
         connect(systemInfo, &SystemInfo::efficiencyModeChanged, this, &MainWindow::onEfficiencyModeChanged);
+        affinityButton = new QPushButton("Set affinity");
+        affinityButton->setVisible(ProcessAffinity::isSupported() && systemInfo->getCpuTopology().isAvailable());
+        connect(affinityButton, &QPushButton::clicked, this, &MainWindow::setAffinityForSelected);
+        schedulingButton = new QPushButton("Set scheduling");
+        schedulingButton->setVisible(ProcessScheduling::isSupported());
+        connect(schedulingButton, &QPushButton::clicked, this, &MainWindow::setSchedulingForSelected);
+        QPushButton *threadsBtn = new QPushButton("Threads");
+        threadsBtn->setCheckable(true);
+        threadsBtn->setStyleSheet(efficiencyBtn->styleSheet());
+        QPushButton *trendsBtn = new QPushButton("Trends");
+        trendsBtn->setCheckable(true);
+        trendsBtn->setStyleSheet(efficiencyBtn->styleSheet());
         topBarLayout->addWidget(runTaskBtn);
         topBarLayout->addWidget(endTaskButton);
+        topBarLayout->addWidget(affinityButton);
+        topBarLayout->addWidget(schedulingButton);
+        topBarLayout->addWidget(threadsBtn);
+        topBarLayout->addWidget(trendsBtn);
         topBarLayout->addWidget(efficiencyBtn);
 
         // Resource Summary Row
@@ -402,34 +521,66 @@ void MainWindow::setupUI()
         }
         resourceLayout->addStretch();
 
-        // Process Table
-        processTable = new QTableWidget(this);
-        processTable->setColumnCount(6);
-        processTable->setHorizontalHeaderLabels({"Name", "Status", "CPU", "Memory (auto)", "Disk", "Network"});
-        processTable->horizontalHeader()->setStyleSheet("QHeaderView::section{background:#232323;color:#fff;font-weight:bold;border:none;}");
-        processTable->setStyleSheet(R"(
-            QTableWidget {
-                background: #181818;
-                color: #fff;
-                border: none;
-                font-size: 14px;
-                alternate-background-color: #232323;
-            }
-            QTableWidget::item:selected {
-                background: #0078d4;
-                color: #fff;
+        // Process Table: cells come from the model and are painted by the delegate
+        processModel = new ProcessTableModel(this);
+        processModel->setSparklines(&systemInfo->getProcessColumns(), &systemInfo->getProcessSparklines());
+        processModel->setHistory(&systemInfo->getProcessHistory());
+        processTable = new QTableView(this);
+        processTable->setModel(processModel);
+        connect(processModel, &QAbstractItemModel::modelReset, this, &MainWindow::respanGroupHeaders);
+        connect(processModel, &QAbstractItemModel::layoutChanged, this, &MainWindow::respanGroupHeaders);
+        connect(processTable, &QTableView::clicked, this, [this](const QModelIndex &index) {
+            if (const ProcessTableModel::Group *group = processModel->groupAt(index.row())) {
+                if (!toggledGroups.remove(group->key)) {
+                    toggledGroups.insert(group->key);
+                }
+                frameScheduler->markDirty(processTable);
             }
-        )");
+        });
+        processTable->setItemDelegate(new ProcessItemDelegate(&systemInfo->getProcessSparklines(), processTable));
+        processTable->horizontalHeader()->setStyleSheet("QHeaderView::section{background:#232323;color:#fff;font-weight:bold;border:none;}");
+        // A palette instead of a stylesheet keeps the view on the plain style's fast paths
+        QPalette tablePalette = processTable->palette();
+        tablePalette.setColor(QPalette::Base, QColor("#181818"));
+        tablePalette.setColor(QPalette::Text, QColor("#fff"));
+        processTable->setPalette(tablePalette);
+        QFont tableFont = processTable->font();
+        tableFont.setPixelSize(14);
+        processTable->setFont(tableFont);
+        processTable->setFrameShape(QFrame::NoFrame);
         processTable->setSelectionBehavior(QAbstractItemView::SelectRows);
         processTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
-        processTable->setAlternatingRowColors(true);
+        processTable->setShowGrid(false);
         processTable->setSortingEnabled(false);
+        processTable->setWordWrap(false);
         processTable->verticalHeader()->setVisible(false);
+        // Uniform rows let the view place any row without measuring the ones above it
+        processTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        processTable->verticalHeader()->setDefaultSectionSize(24);
         processTable->horizontalHeader()->setStretchLastSection(true);
+        // Sparkline columns are optional; hidden columns are never painted
+        for (int column : {ProcessTableModel::CpuTrendColumn, ProcessTableModel::MemoryTrendColumn}) {
+            processTable->setColumnHidden(column, true);
+            processTable->setColumnWidth(column, 120);
+        }
+        connect(trendsBtn, &QPushButton::toggled, this, [this](bool shown) {
+            processTable->setColumnHidden(ProcessTableModel::CpuTrendColumn, !shown);
+            processTable->setColumnHidden(ProcessTableModel::MemoryTrendColumn, !shown);
+        });
+
+        // Thread drilldown for the selected process; it only samples while visible
+        threadPanel = new ThreadPanel();
+        threadPanel->setVisible(false);
+        connect(threadsBtn, &QPushButton::toggled, threadPanel, &QWidget::setVisible);
+        QSplitter *processSplitter = new QSplitter(Qt::Vertical);
+        processSplitter->addWidget(processTable);
+        processSplitter->addWidget(threadPanel);
+        processSplitter->setStretchFactor(0, 3);
+        processSplitter->setStretchFactor(1, 2);
 
         processesLayout->addWidget(topBar);
         processesLayout->addWidget(resourceSummary);
-        processesLayout->addWidget(processTable);
+        processesLayout->addWidget(processSplitter);
 
         // --- Performance View ---
         QWidget *performanceView = new QWidget();
@@ -461,15 +612,38 @@ void MainWindow::setupUI()
         // Add to layout
         perfLayout->addWidget(cpuPerfLabel);
         perfLayout->addWidget(cpuPerfBarDetailed);
+        // Per-core heatmap (imbalance, single-thread saturation, steal)
+        cpuCoresLabel = new QLabel();
+        cpuCoresLabel->setStyleSheet("color:#b0b0b0;");
+        cpuHeatmap = new CpuHeatmapWidget();
+        cpuCoresLabel->setVisible(systemInfo->hasPerCoreStats());
+        cpuHeatmap->setVisible(systemInfo->hasPerCoreStats());
+        perfLayout->addWidget(cpuCoresLabel);
+        perfLayout->addWidget(cpuHeatmap);
         perfLayout->addWidget(memPerfLabel);
         perfLayout->addWidget(memPerfBarDetailed);
         perfLayout->addWidget(diskPerfLabel);
         perfLayout->addWidget(diskPerfBarDetailed);
+        // Pressure stall information: whether work is actually stalled
+        pressurePanel = new PressurePanel();
+        pressurePanel->setVisible(systemInfo->hasPressureStats());
+        connect(systemInfo, &SystemInfo::pressureStallDetected, pressurePanel, &PressurePanel::onStallDetected);
+        perfLayout->addWidget(pressurePanel);
+        // Per-device I/O statistics (throughput, IOPS, latency, queue depth)
+        storagePanel = new StoragePanel();
+        storagePanel->setVisible(systemInfo->hasBlockDeviceStats());
+        perfLayout->addWidget(storagePanel);
         perfLayout->addStretch();
 
+        // Wrap the performance view in a scroll area, the device list can be long
+        QScrollArea *performanceScrollArea = new QScrollArea();
+        performanceScrollArea->setWidget(performanceView);
+        performanceScrollArea->setWidgetResizable(true);
+        performanceScrollArea->setStyleSheet("QScrollArea { border: none; }");
+
         // Add views to stacked widget
-        stackedWidget->addWidget(processesView);    // index 0
-        stackedWidget->addWidget(performanceView);  // index 1
+        viewStack->addWidget(processesView);    // index 0
+        viewStack->addWidget(performanceScrollArea);  // index 1
 
         // --- Troubleshoot View ---
         QWidget *troubleshootView = new QWidget();
@@ -483,9 +657,41 @@ void MainWindow::setupUI()
         
         // Process Selection
         QHBoxLayout *processSelectLayout = new QHBoxLayout();
+        // Picker over every live process; type-ahead goes through a completer
+        // that searches the sorted model instead of filtering item by item
+        pickerModel = new ProcessPickerModel(this);
+        pickerMatches = new ProcessMatchModel(pickerModel, this);
         processSelect = new QComboBox();
+        processSelect->setModel(pickerModel);
+        processSelect->setEditable(true);
+        processSelect->setInsertPolicy(QComboBox::NoInsert);
         processSelect->setMinimumWidth(300);
         processSelect->setMaxVisibleItems(15);  // Show 15 items at a time
+        QCompleter *pickerCompleter = new QCompleter(pickerMatches, processSelect);
+        pickerCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+        pickerCompleter->setMaxVisibleItems(15);
+        processSelect->lineEdit()->setCompleter(pickerCompleter);
+        connect(processSelect->lineEdit(), &QLineEdit::textEdited, pickerMatches, &ProcessMatchModel::setPattern);
+        // Matching once per snapshot, not once per inserted or removed row.
+        // Matching again resets the model, which would cost an open popup
+        // its keyboard row and scroll position, so that keeps its rows.
+        connect(pickerModel, &ProcessPickerModel::entriesChanged, pickerMatches, [this, pickerCompleter]() {
+            if (pickerCompleter->popup()->isVisible()) {
+                pickerMatches->relocate();
+            } else {
+                pickerMatches->refresh();
+            }
+        });
+        connect(pickerCompleter, QOverload<const QModelIndex &>::of(&QCompleter::activated), this, [this](const QModelIndex &index) {
+            int row = pickerMatches->sourceRow(index.row());
+            if (row >= 0) {
+                processSelect->setCurrentIndex(row);
+            }
+        });
+        connect(systemInfo, &SystemInfo::dataUpdated, pickerModel, [this]() {
+            pickerModel->update(systemInfo->getProcessColumns());
+        });
+        pickerModel->update(systemInfo->getProcessColumns());
         processSelect->setStyleSheet(R"(
             QComboBox {
                 background-color: #232323;
@@ -579,7 +785,21 @@ void MainWindow::setupUI()
         )");
         diagnosticLayout->addWidget(diagnosticTable);
 
+        // Continuous alerts from the health rules, across all processes
+        QGroupBox *alertGroup = new QGroupBox("Alerts");
+        QVBoxLayout *alertLayout = new QVBoxLayout(alertGroup);
+        alertPanel = new AlertPanel();
+        alertLayout->addWidget(alertPanel);
+
+        // What Efficiency mode is currently doing
+        QGroupBox *efficiencyGroup = new QGroupBox("Efficiency Mode Activity");
+        QVBoxLayout *efficiencyLayout = new QVBoxLayout(efficiencyGroup);
+        efficiencyPanel = new EfficiencyPanel();
+        efficiencyLayout->addWidget(efficiencyPanel);
+
         // Add groups to troubleshoot layout
+        troubleshootLayout->addWidget(alertGroup);
+        troubleshootLayout->addWidget(efficiencyGroup);
         troubleshootLayout->addWidget(healthCheckGroup);
         troubleshootLayout->addWidget(diagnosticGroup);
         troubleshootLayout->addStretch();
@@ -608,74 +828,37 @@ void MainWindow::setupUI()
         )");
         
         // Add scroll area to stacked widget
-        stackedWidget->addWidget(troubleshootScrollArea);  // index 2
+        viewStack->addWidget(troubleshootScrollArea);  // index 2
 
-        mainVLayout->addWidget(stackedWidget);
+        mainVLayout->addWidget(viewStack);
 
         // Add sidebar and main content to main horizontal layout
         mainHLayout->addWidget(sidebar);
         mainHLayout->addWidget(mainContent);
 
-        // --- Sidebar Navigation Logic ---
-        // Connect all three buttons
-        connect(sidebarButtons[0], &QPushButton::clicked, this, [=]() {
-            sidebarButtons[0]->setChecked(true);
-            sidebarButtons[1]->setChecked(false);
-            sidebarButtons[2]->setChecked(false);
-            stackedWidget->setCurrentIndex(0);
-        });
-        connect(sidebarButtons[1], &QPushButton::clicked, this, [=]() {
-            sidebarButtons[0]->setChecked(false);
-            sidebarButtons[1]->setChecked(true);
-            sidebarButtons[2]->setChecked(false);
-            stackedWidget->setCurrentIndex(1);
-        });
-        connect(sidebarButtons[2], &QPushButton::clicked, this, [=]() {
-            sidebarButtons[0]->setChecked(false);
-            sidebarButtons[1]->setChecked(false);
-            sidebarButtons[2]->setChecked(true);
-            stackedWidget->setCurrentIndex(2);
-        });
-
         // Connect health check button
         connect(checkHealthBtn, &QPushButton::clicked, this, [=]() {
-            QString selectedProcess = processSelect->currentText();
-            if (selectedProcess.isEmpty()) {
+            int row = processSelect->currentIndex();
+            if (row < 0) {
                 QMessageBox::warning(this, "Warning", "Please select a process to check.");
                 return;
             }
-            checkProcessHealth(selectedProcess, healthStatus, diagnosticTable);
+            checkProcessHealth(pickerModel->pidAt(row), pickerModel->startTimeAt(row), healthStatus, diagnosticTable);
         });
 
         // Connect end task button
         connect(endTaskBtn, &QPushButton::clicked, this, [=]() {
-            QString selectedProcess = processSelect->currentText();
-            if (selectedProcess.isEmpty()) {
+            int row = processSelect->currentIndex();
+            if (row < 0) {
                 QMessageBox::warning(this, "Warning", "Please select a process to end.");
                 return;
             }
             // Find the process in the process table
-            for (int row = 0; row < processTable->rowCount(); ++row) {
-                QTableWidgetItem* nameItem = processTable->item(row, 0);
-                if (nameItem && nameItem->text() == selectedProcess) {
-                    processTable->selectRow(row);
-                    forceEndTask();
-                    break;
-                }
-            }
-        });
-
-        // Update process list in combo box with scroll position preservation
-        connect(systemInfo, &SystemInfo::dataUpdated, this, [this]() {
-            // Get current selected index
-            int currentIndex = processSelect->currentIndex();
-            
-            // Update combo box
-            updateProcessComboBox(processSelect);
-            
-            // Try to restore the selected index
-            if (currentIndex >= 0 && currentIndex < processSelect->count()) {
-                processSelect->setCurrentIndex(currentIndex);
+            if (selectProcessByPid(pickerModel->pidAt(row), pickerModel->startTimeAt(row))) {
+                forceEndTask();
+            } else {
+                QMessageBox::warning(this, "Warning", QString("PID %1 is not in the process list. "
+                    "It may have exited, or the search may hide it.").arg(pickerModel->pidAt(row)));
             }
         });
 
@@ -685,20 +868,23 @@ void MainWindow::setupUI()
         connect(efficiencyBtn, &QPushButton::clicked, this, &MainWindow::toggleEfficiencyMode);
         connect(systemInfo, &SystemInfo::efficiencyModeChanged, this, &MainWindow::onEfficiencyModeChanged);
         // Enable/disable End Task button based on selection - modified to allow all processes
-        connect(processTable, &QTableWidget::itemSelectionChanged, this, [=]() {
-            QList<QTableWidgetItem*> selected = processTable->selectedItems();
-            bool enable = false;
-            if (!selected.isEmpty()) {
-                int row = selected.first()->row();
-                QTableWidgetItem* nameItem = processTable->item(row, 0);
-                if (nameItem && !nameItem->text().isEmpty()) {
-                    // Allow all processes, but we'll show different warnings for system processes
-                    enable = true;
-                }
-            }
+        connect(processTable->selectionModel(), &QItemSelectionModel::selectionChanged, this, [=]() {
+            const ProcessInfo *process = selectedProcess();
+            // Allow all processes, but we'll show different warnings for system processes
+            bool enable = process && !process->name.isEmpty();
             endTaskButton->setEnabled(enable);
+            affinityButton->setEnabled(enable);
+            schedulingButton->setEnabled(enable);
+            // The selected process always gets an exact memory breakdown
+            // and fresh affinity
+            if (enable) {
+                systemInfo->setSelectedPid(process->pid);
+                threadPanel->setProcess(process->pid, process->name);
+            }
         });
         endTaskButton->setEnabled(false);
+        affinityButton->setEnabled(false);
+        schedulingButton->setEnabled(false);
 
         // Connect header click to custom sort
         connect(processTable->horizontalHeader(), &QHeaderView::sectionClicked, this, &MainWindow::onTableHeaderClicked);
@@ -750,258 +936,332 @@ QGroupBox* MainWindow::createResourceGroup()
     return groupBox;
 }
 
-void MainWindow::onDataUpdated()
+void MainWindow::setMaxFrameRate(int framesPerSecond)
 {
-    // Throttle updates to prevent UI lag
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    if (currentTime - lastUpdateTime < UPDATE_INTERVAL_MS) {
-        return;
-    }
-    lastUpdateTime = currentTime;
-    
-    // Update UI in the main thread
-    QMetaObject::invokeMethod(this, &MainWindow::updateUI, Qt::QueuedConnection);
+    frameScheduler->setMaxFrameRate(framesPerSecond);
 }
 
-void MainWindow::updateUI()
+void MainWindow::updateResourceSummary()
 {
-    try {
-        // Update resource usage with cached values
-        updateResourceUsage();
-        
-        // Update process table with throttling
-        if (shouldUpdateProcessTable()) {
-            updateProcessTable();
-        }
-    } catch (const std::exception& e) {
-        qWarning() << "Failed to update UI:" << e.what();
-    }
+    cpuSumLabel->setText(QString("CPU: %1%").arg(systemInfo->getCpuUsage(), 0, 'f', 1));
+    memSumLabel->setText(QString("Memory: %1%").arg(systemInfo->getMemoryUsage(), 0, 'f', 1));
+    diskSumLabel->setText(QString("Disk: %1%").arg(systemInfo->getDiskUsage(), 0, 'f', 1));
+    netSumLabel->setText(QString("Network: %1 KB/s").arg(systemInfo->getNetworkUsage(), 0, 'f', 1));
 }
 
-void MainWindow::updateResourceUsage()
+void MainWindow::updatePerformanceView()
 {
-    // Prevent crash if UI not yet initialized
-    if (!cpuBar || !memoryBar || !diskBar || !cpuLabel || !memoryLabel || !diskLabel ||
-        !cpuSumLabel || !memSumLabel || !diskSumLabel || !netSumLabel)
-        return;
-    // Update resource bars with current values
     double cpuUsage = systemInfo->getCpuUsage();
     double memoryUsage = systemInfo->getMemoryUsage();
     double diskUsage = systemInfo->getDiskUsage();
-    double networkUsage = systemInfo->getNetworkUsage();  // Get network usage in KB/s
-    
+
     // Update progress bars
     cpuBar->setValue(static_cast<int>(cpuUsage));
     memoryBar->setValue(static_cast<int>(memoryUsage));
     diskBar->setValue(static_cast<int>(diskUsage));
-    
+
     // Update detailed labels
     cpuLabel->setText(QString("CPU Usage: %1%").arg(cpuUsage, 0, 'f', 1));
+    if (cpuHeatmap && systemInfo->hasPerCoreStats()) {
+        QVector<CpuCoreStats> cores = systemInfo->getCpuCores();
+        double maxBusy = 0.0;
+        double maxSteal = 0.0;
+        for (const CpuCoreStats &core : cores) {
+            maxBusy = std::max(maxBusy, core.busy);
+            maxSteal = std::max(maxSteal, core.steal);
+        }
+        cpuCoresLabel->setText(QString("%1 cores - busiest core: %2%, steal: %3% (max %4% on one core)")
+            .arg(cores.size())
+            .arg(maxBusy, 0, 'f', 1)
+            .arg(systemInfo->getCpuStealTime(), 0, 'f', 1)
+            .arg(maxSteal, 0, 'f', 1));
+        cpuHeatmap->setCores(cores);
+    }
     memoryLabel->setText(QString("Memory Usage: %1%").arg(memoryUsage, 0, 'f', 1));
-    diskLabel->setText(QString("Disk Usage: %1%").arg(diskUsage, 0, 'f', 1));
-
-    // Update summary labels
-    cpuSumLabel->setText(QString("CPU: %1%").arg(cpuUsage, 0, 'f', 1));
-    memSumLabel->setText(QString("Memory: %1%").arg(memoryUsage, 0, 'f', 1));
-    diskSumLabel->setText(QString("Disk: %1%").arg(diskUsage, 0, 'f', 1));
-    netSumLabel->setText(QString("Network: %1 KB/s").arg(networkUsage, 0, 'f', 1));  // Changed to KB/s
-
-    qDebug() << "Resource values:" << cpuUsage << memoryUsage << diskUsage << networkUsage;
+    if (pressurePanel && systemInfo->hasPressureStats()) {
+        pressurePanel->updatePressure(systemInfo->getPressure(PressureResource::Cpu),
+                                      systemInfo->getPressure(PressureResource::Memory),
+                                      systemInfo->getPressure(PressureResource::Io));
+    }
+    if (systemInfo->hasBlockDeviceStats()) {
+        diskLabel->setText(QString("Disk Active Time (busiest device): %1%").arg(diskUsage, 0, 'f', 1));
+        if (storagePanel) {
+            storagePanel->updateDevices(systemInfo->getBlockDevices(), systemInfo->getBusiestBlockDevice());
+        }
+    } else {
+        diskLabel->setText(QString("Disk Usage: %1%").arg(diskUsage, 0, 'f', 1));
+    }
 }
 
-bool MainWindow::shouldUpdateProcessTable()
+void MainWindow::updateTroubleshootView()
 {
-    qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    return (currentTime - processCache.timestamp) >= CACHE_DURATION_MS;
+    alertPanel->updateAlerts(systemInfo->getHealthRules());
+    efficiencyPanel->updateThrottles(systemInfo->isEfficiencyModeEnabled(), systemInfo->getEfficiencyThrottles());
 }
 
 void MainWindow::updateProcessTable()
 {
     try {
-        // Use sortedProcesses (if available) or get a fresh list from systemInfo
-        QVector<ProcessInfo> processes = sortedProcesses.isEmpty() ? systemInfo->getProcessList() : sortedProcesses;
-        QString searchText = (searchBox) ? searchBox->text().toLower() : "";
-        QMap<ProcessType, QVector<ProcessInfo>> grouped;
-        for (const ProcessInfo &proc : processes) {
-            if (shouldDisplayProcess(proc, searchText)) {
-                grouped[proc.type].append(proc);
+        const QVector<ProcessInfo> processes = systemInfo->getProcessList();
+        QString searchText = (searchBox) ? searchBox->text().trimmed() : "";
+
+        // Fuzzy search over names and paths, best matches first, then the
+        // processes whose pid contains the text
+        QVector<int> order;
+        if (searchText.isEmpty()) {
+            order.resize(processes.size());
+            std::iota(order.begin(), order.end(), 0);
+        } else {
+            // Names only change with the snapshot, not with each keystroke
+            const quint64 version = systemInfo->getSnapshotVersion();
+            if (searchMatcherVersion != version || searchMatcher.size() != processes.size()) {
+                searchMatcher.clear();
+                searchMatcher.reserve(processes.size(), processes.size() * 64);
+                for (const ProcessInfo &proc : processes) {
+                    searchMatcher.add(proc.name, proc.path);
+                }
+                searchMatcherVersion = version;
+            }
+            QVector<quint8> found(processes.size(), 0);
+            for (const FuzzyMatcher::Match &match : searchMatcher.rank(searchText, MAX_PROCESS_ROWS)) {
+                order.append(match.index);
+                found[match.index] = 1;
+            }
+            qint64 digits = 0;
+            qint64 power = 0;
+            if (parsePidText(searchText, digits, power)) {
+                for (int index = 0; index < processes.size(); ++index) {
+                    if (!found[index] && pidContains(processes[index].pid, digits, power)) {
+                        order.append(index);
+                    }
+                }
             }
         }
-        int rowCount = 0;
-        for (ProcessType type : groupOrder) {
-            if (!grouped[type].isEmpty()) {
-                rowCount += 1 + grouped[type].size();
+        if (currentSortColumn != NO_SORT) {
+            sortProcesses(order, processes);
+        }
+
+        // Groups and their totals come from the grouping SystemInfo keeps up
+        // to date; processes are placed by their row in the same snapshot
+        const ProcessColumns &columns = systemInfo->getProcessColumns();
+        const ProcessGrouping &grouping = systemInfo->getProcessGrouping();
+        QVector<ProcessTableModel::Group> groups;
+        QVector<int> groupOfSlot(grouping.slotCount(), -1);
+        for (int slot : grouping.orderedSlots()) {
+            const ProcessGrouping::Group &source = grouping.group(slot);
+            // Searching opens every group that has a match
+            ProcessTableModel::Group group{source.key, source.title, source.count,
+                                           searchText.isEmpty() && isGroupCollapsed(source.key), {}, {}};
+            std::copy(std::begin(source.totals), std::end(source.totals), std::begin(group.totals));
+            groupOfSlot[slot] = groups.size();
+            groups.append(group);
+        }
+
+        QVector<qint32> groupOfRow(columns.rows, 0);
+        QVector<quint8> listed(columns.rows, 0);
+        for (int index : order) {
+            const ProcessInfo &proc = processes[index];
+            if (!shouldDisplayProcess(proc)) {
+                continue;
+            }
+            // The list and the columns are the same snapshot
+            const int row = columns.rowOf(proc.pid, proc.startTime);
+            const int group = groupOfSlot[grouping.slotOfRow(row)];
+            groupOfRow[row] = group;
+            listed[row] = 1;
+            if (!groups[group].collapsed) {
+                groups[group].processes.append(proc);
             }
         }
-        processTable->setRowCount(rowCount);
-        int row = 0;
-        for (ProcessType type : groupOrder) {
-            if (grouped[type].isEmpty()) continue;
-            // Group header (with process count)
-            QString headerText = QString("%1 (%2)").arg(groupNames[type]).arg(grouped[type].size());
-            QTableWidgetItem *headerItem = new QTableWidgetItem(headerText);
-            headerItem->setFlags(Qt::NoItemFlags);
-            headerItem->setBackground(QColor("#232323"));
-            headerItem->setForeground(QColor("#80bfff"));
-            QFont f = headerItem->font(); f.setBold(true); headerItem->setFont(f);
-            processTable->setItem(row, 0, headerItem);
-            processTable->setSpan(row, 0, 1, processTable->columnCount());
-            processTable->setRowHeight(row, 28);
-            row++;
-            // Add processes for this group (using the sorted data)
-            for (const ProcessInfo &proc : grouped[type]) {
-                QTableWidgetItem *nameItem = new QTableWidgetItem(proc.name);
-                QTableWidgetItem *statusItem = new QTableWidgetItem(proc.status);
-                
-                // CPU usage with color coding
-                double cpuUsage = proc.cpuUsage;
-                QString cpuText = QString::number(cpuUsage, 'f', 1) + "%";
-                QTableWidgetItem *cpuItem = new QTableWidgetItem(cpuText);
-                
-                // Color coding based on CPU usage
-                if (cpuUsage >= 80.0) {
-                    cpuItem->setForeground(QColor("#FF4444")); // Red for high usage
-                } else if (cpuUsage >= 50.0) {
-                    cpuItem->setForeground(QColor("#FFA500")); // Orange for medium usage
-                } else if (cpuUsage >= 20.0) {
-                    cpuItem->setForeground(QColor("#FFD700")); // Yellow for moderate usage
-                } else {
-                    cpuItem->setForeground(QColor("#4CAF50")); // Green for low usage
-                }
-                
-                QTableWidgetItem *memItem = new QTableWidgetItem(formatMemorySize(proc.memoryUsage));
-                QTableWidgetItem *diskItem = new QTableWidgetItem(QString("%1 MB/s").arg(std::max(0.0, proc.diskUsage), 0, 'f', 2));
-                QTableWidgetItem *netItem;
-                if (proc.networkUsage < 0) {
-                    netItem = new QTableWidgetItem("N/A");
-                    netItem->setForeground(QColor("#888"));
-                } else {
-                    netItem = new QTableWidgetItem(QString("%1 MB/s").arg(proc.networkUsage, 0, 'f', 2));
-                    netItem->setForeground(QColor("#00BFFF"));
-                }
-                
-                nameItem->setForeground(QColor("#fff"));
-                statusItem->setForeground(QColor("#b0b0b0"));
-                memItem->setForeground(QColor("#2196F3"));
-                diskItem->setForeground(QColor("#FF9800"));
-                netItem->setForeground(QColor("#00BFFF"));
-                
-                // Color coding for disk usage
-                if (proc.diskUsage >= 10.0) {
-                    diskItem->setForeground(QColor("#FF4444")); // Red for high usage
-                } else if (proc.diskUsage >= 5.0) {
-                    diskItem->setForeground(QColor("#FFA500")); // Orange for medium usage
-                } else if (proc.diskUsage >= 1.0) {
-                    diskItem->setForeground(QColor("#FFD700")); // Yellow for moderate usage
-                }
-                
-                // Color coding for network usage
-                if (proc.networkUsage >= 5.0) {
-                    netItem->setForeground(QColor("#FF4444")); // Red for high usage
-                } else if (proc.networkUsage >= 2.0) {
-                    netItem->setForeground(QColor("#FFA500")); // Orange for medium usage
-                } else if (proc.networkUsage >= 0.5) {
-                    netItem->setForeground(QColor("#FFD700")); // Yellow for moderate usage
-                }
-                
-                processTable->setItem(row, 0, nameItem);
-                processTable->setItem(row, 1, statusItem);
-                processTable->setItem(row, 2, cpuItem);
-                processTable->setItem(row, 3, memItem);
-                processTable->setItem(row, 4, diskItem);
-                processTable->setItem(row, 5, netItem);
-                processTable->setRowHeight(row, 24);
-                row++;
+        if (!searchText.isEmpty() || currentProcessTypeFilter != ProcessType::Unknown) {
+            computeGroupTotals(groups, groupOfRow, listed);
+            groups.erase(std::remove_if(groups.begin(), groups.end(), [](const ProcessTableModel::Group &group) {
+                return group.count == 0;
+            }), groups.end());
+        }
+
+        // A reset (rows added or removed) drops the selection; put it back on the same process
+        const ProcessInfo *selected = selectedProcess();
+        qint64 selectedPid = selected ? selected->pid : -1;
+        processModel->setGroups(groups, systemInfo->hasMemoryDetail(), systemInfo->getTotalMemoryKb());
+        if (selectedPid >= 0 && !selectedProcess()) {
+            int row = processModel->rowOfPid(selectedPid);
+            if (row >= 0) {
+                processTable->selectRow(row);
             }
         }
-        processTable->resizeRowsToContents();
     } catch (const std::exception& e) {
         qWarning() << "Failed to update process table (grouped):" << e.what();
     }
 }
 
-bool MainWindow::shouldDisplayProcess(const ProcessInfo &process, const QString &searchText)
+void MainWindow::computeGroupTotals(QVector<ProcessTableModel::Group> &groups, const QVector<qint32> &groupOfRow,
+                                    const QVector<quint8> &listed) const
 {
-    // Check search text match
-    bool matchesSearch = searchText.isEmpty() ||
-        process.name.toLower().contains(searchText) ||
-        QString::number(process.pid).contains(searchText) ||
-        process.path.toLower().contains(searchText);
-    
-    // Check process type filter
-    bool matchesType = currentProcessTypeFilter == ProcessType::Unknown ||
+    // The grouping's totals cover every process; with a filter, each metric
+    // is summed over the listed rows by the column kernels instead
+    const ProcessColumns &columns = systemInfo->getProcessColumns();
+    static const ProcessColumns::Metric summed[] = {
+        ProcessColumns::Cpu, ProcessColumns::MemoryKb, ProcessColumns::PssKb,
+        ProcessColumns::DiskMBps, ProcessColumns::NetworkMBps
+    };
+    QVector<columnkernels::GroupTotals> totals(groups.size());
+    QVector<quint8> available(columns.rows);
+    for (ProcessColumns::Metric metric : summed) {
+        const double *values = columns.column(metric);
+        const quint8 *selected = listed.constData();
+        if (metric == ProcessColumns::DiskMBps || metric == ProcessColumns::NetworkMBps) {
+            // Negative rates mean the counter is not available
+            for (int row = 0; row < columns.rows; ++row) {
+                available[row] = listed[row] && values[row] >= 0.0;
+            }
+            selected = available.constData();
+        }
+        columnkernels::groupTotals(values, groupOfRow.constData(), selected, columns.rows, groups.size(), totals.data());
+        for (int group = 0; group < groups.size(); ++group) {
+            groups[group].totals[metric] = totals[group].sum;
+            if (metric == ProcessColumns::Cpu) {
+                groups[group].count = totals[group].count;
+            }
+        }
+    }
+}
+
+bool MainWindow::isGroupCollapsed(qint64 key) const
+{
+    // Type groups start open, the many groups of other keys start closed;
+    // a click flips a group from its default
+    const bool collapsedByDefault = systemInfo->getProcessGrouping().key() != ProcessGrouping::ByType;
+    return collapsedByDefault != toggledGroups.contains(key);
+}
+
+void MainWindow::respanGroupHeaders()
+{
+    // Group titles span up to the totals. Spans only move when rows do,
+    // which comes with a reset or a layout change.
+    processTable->clearSpans();
+    for (int row = 0; row < processModel->rowCount(); ++row) {
+        if (processModel->isGroupHeader(row)) {
+            processTable->setSpan(row, 0, 1, ProcessTableModel::CpuColumn);
+        }
+    }
+}
+
+void MainWindow::onGroupByChanged(int index)
+{
+    systemInfo->setGroupingKey(static_cast<ProcessGrouping::Key>(groupBySelect->itemData(index).toInt()));
+    toggledGroups.clear();
+    frameScheduler->markDirty(processTable);
+}
+
+bool MainWindow::shouldDisplayProcess(const ProcessInfo &process)
+{
+    // Search matches are already picked; this is the process type filter
+    return currentProcessTypeFilter == ProcessType::Unknown ||
         process.type == currentProcessTypeFilter;
-    
-    return matchesSearch && matchesType;
 }
 
 void MainWindow::onProcessTypeFilterChanged(int index)
 {
     currentProcessTypeFilter = static_cast<ProcessType>(
         processTypeFilter->itemData(index).toInt());
-    updateProcessTable();
+    frameScheduler->markDirty(processTable);
 }
 
 void MainWindow::onTableHeaderClicked(int column)
 {
-    static Qt::SortOrder lastOrder = Qt::AscendingOrder;
-    lastOrder = (lastOrder == Qt::AscendingOrder) ? Qt::DescendingOrder : Qt::AscendingOrder;
-    // Synchronously sort the underlying process list (using the helper)
-    sortProcesses(column, lastOrder);
-    // Then update the table (which now uses sortedProcesses if available)
-    updateProcessTable();
+    // Each click flips the order; the next render sorts by it
+    currentSortColumn = column;
+    currentSortOrder = (currentSortOrder == Qt::AscendingOrder) ? Qt::DescendingOrder : Qt::AscendingOrder;
+    frameScheduler->markDirty(processTable);
 }
 
-void MainWindow::sortProcesses(int column, Qt::SortOrder order) {
-    QVector<ProcessInfo> procList = systemInfo->getProcessList();
-    std::sort(procList.begin(), procList.end(), [column, order](const ProcessInfo &a, const ProcessInfo &b) {
-        if (column == 0) { // Name (string)
+void MainWindow::sortProcesses(QVector<int> &indexes, const QVector<ProcessInfo> &processes) const
+{
+    const int column = currentSortColumn;
+    const Qt::SortOrder order = currentSortOrder;
+    // Sort by what the Memory column shows
+    const bool usePss = systemInfo->hasMemoryDetail();
+    // Indexes rather than the records, so the sort moves ints
+    std::stable_sort(indexes.begin(), indexes.end(), [&processes, column, order, usePss](int left, int right) {
+        const ProcessInfo &a = processes[left];
+        const ProcessInfo &b = processes[right];
+        if (column == PID_SORT) {
+            return (order == Qt::AscendingOrder) ? (a.pid < b.pid) : (a.pid > b.pid);
+        } else if (column == 0) { // Name (string)
             return (order == Qt::AscendingOrder) ? (a.name < b.name) : (a.name > b.name);
-        } else if (column == 1) { // Status (string)
+        } else if (column == 1) { // Status (enum)
             return (order == Qt::AscendingOrder) ? (a.status < b.status) : (a.status > b.status);
         } else if (column == 2) { // CPU (numeric)
             return (order == Qt::AscendingOrder) ? (a.cpuUsage < b.cpuUsage) : (a.cpuUsage > b.cpuUsage);
-        } else if (column == 3) { // Memory (numeric)
-            return (order == Qt::AscendingOrder) ? (a.memoryUsage < b.memoryUsage) : (a.memoryUsage > b.memoryUsage);
+        } else if (column == 3) { // Memory (numeric): PSS when available, else RSS
+            const qint64 memoryA = usePss ? a.pssKb : a.memoryUsage;
+            const qint64 memoryB = usePss ? b.pssKb : b.memoryUsage;
+            return (order == Qt::AscendingOrder) ? (memoryA < memoryB) : (memoryA > memoryB);
         } else if (column == 4) { // Disk (numeric)
             return (order == Qt::AscendingOrder) ? (a.diskUsage < b.diskUsage) : (a.diskUsage > b.diskUsage);
         } else if (column == 5) { // Network (numeric)
             return (order == Qt::AscendingOrder) ? (a.networkUsage < b.networkUsage) : (a.networkUsage > b.networkUsage);
+        } else if (column == 6) { // CPU anomaly (numeric)
+            return (order == Qt::AscendingOrder) ? (a.cpuZScore < b.cpuZScore) : (a.cpuZScore > b.cpuZScore);
+        } else if (column == 7) { // Affinity (string)
+            return (order == Qt::AscendingOrder) ? (a.affinity < b.affinity) : (a.affinity > b.affinity);
+        } else if (column == 8) { // Nice (numeric)
+            return (order == Qt::AscendingOrder) ? (a.scheduling.nice < b.scheduling.nice) : (a.scheduling.nice > b.scheduling.nice);
+        } else if (column == 9) { // Policy
+            return (order == Qt::AscendingOrder) ? (a.scheduling.policy < b.scheduling.policy) : (a.scheduling.policy > b.scheduling.policy);
+        } else if (column == 10) { // I/O priority: class, then level
+            auto key = [](const ProcessInfo &p) { return static_cast<int>(p.scheduling.ioClass) * 8 + p.scheduling.ioLevel; };
+            return (order == Qt::AscendingOrder) ? (key(a) < key(b)) : (key(a) > key(b));
         } else {
             return false;
         }
     });
-    sortedProcesses = procList;
 }
 
 void MainWindow::onSearchTextChanged(const QString &text)
 {
-    updateProcessTable();  // This will apply the search filter
+    frameScheduler->markDirty(processTable);  // This will apply the search filter
 }
 
 void MainWindow::sortByMemory()
 {
-    currentSortColumn = 4;  // Memory column
+    currentSortColumn = ProcessTableModel::MemoryColumn;
     currentSortOrder = Qt::DescendingOrder;
-    processTable->sortItems(currentSortColumn, currentSortOrder);
+    frameScheduler->markDirty(processTable);
 }
 
 void MainWindow::sortByCPU()
 {
-    currentSortColumn = 3;  // CPU column
+    currentSortColumn = ProcessTableModel::CpuColumn;
     currentSortOrder = Qt::DescendingOrder;
-    processTable->sortItems(currentSortColumn, currentSortOrder);
+    frameScheduler->markDirty(processTable);
 }
 
 void MainWindow::sortByPID()
 {
-    currentSortColumn = 1;  // PID column
+    currentSortColumn = PID_SORT;
     currentSortOrder = Qt::AscendingOrder;
-    processTable->sortItems(currentSortColumn, currentSortOrder);
+    frameScheduler->markDirty(processTable);
 }
 
 QString MainWindow::formatTime(qint64 fileTime)
 {
+#ifndef Q_OS_WIN
+    // Start times are clock ticks since boot on Linux
+    QFile stat("/proc/stat");
+    qint64 bootTime = 0;
+    if (stat.open(QIODevice::ReadOnly)) {
+        for (QByteArray line = stat.readLine(); !line.isEmpty(); line = stat.readLine()) {
+            if (line.startsWith("btime ")) {
+                bootTime = line.mid(6).trimmed().toLongLong();
+                break;
+            }
+        }
+    }
+    const qint64 seconds = bootTime + fileTime / sysconf(_SC_CLK_TCK);
+    return QDateTime::fromSecsSinceEpoch(seconds).toString("yyyy-MM-dd HH:mm:ss");
+#else
     FILETIME ft;
     ft.dwLowDateTime = (DWORD)(fileTime & 0xFFFFFFFF);
     ft.dwHighDateTime = (DWORD)(fileTime >> 32);
@@ -1016,18 +1276,12 @@ QString MainWindow::formatTime(qint64 fileTime)
         .arg(st.wHour, 2, 10, QChar('0'))
         .arg(st.wMinute, 2, 10, QChar('0'))
         .arg(st.wSecond, 2, 10, QChar('0'));
+#endif
 }
 
 QString MainWindow::formatMemorySize(qint64 kb)
 {
-    const char* units[] = {"KB", "MB", "GB", "TB"};
-    int unit = 0;
-    double size = static_cast<double>(kb);
-    while (size >= 1024.0 && unit < 3) {
-        size /= 1024.0;
-        unit++;
-    }
-    return QString("%1 %2").arg(size, 0, 'f', 2).arg(units[unit]);
+    return ProcessTableModel::formatMemorySize(kb);
 }
 
 void MainWindow::toggleEfficiencyMode()
@@ -1048,11 +1302,27 @@ void MainWindow::toggleEfficiencyMode()
         mainLayout->addWidget(headerLabel);
         
         // Features list
-        QLabel *featuresLabel = new QLabel(
+        QString features =
             "• Reducing priority of background processes\n"
             "• Optimizing memory usage for non-essential processes\n"
-            "• Throttling CPU usage for high-usage processes"
-        );
+            "• Throttling CPU usage for high-usage processes";
+        const CgroupBudgetManager &budgets = systemInfo->getBudgetManager();
+        if (budgets.activeMethod() == CgroupBudgetManager::Method::Cgroup) {
+            const EfficiencyBudget &budget = budgets.budget();
+            features = QString(
+                "• Moving background and busy non-essential processes into limited groups, one each\n"
+                "• Capping each at %1% of one CPU (weight %2)\n"
+                "• Reclaiming each one's memory above %3 MB")
+                .arg(budget.cpuQuotaPercent)
+                .arg(budget.cpuWeight)
+                .arg(budget.memoryHighMB);
+        } else if (budgets.activeMethod() == CgroupBudgetManager::Method::Nice) {
+            features = QString(
+                "• Lowering the priority of background and busy non-essential processes to nice %1\n"
+                "• (cgroup v2 is not delegated to this user, so no hard CPU or memory budgets)")
+                .arg(budgets.budget().fallbackNice);
+        }
+        QLabel *featuresLabel = new QLabel(features);
         featuresLabel->setStyleSheet("color: #b0b0b0;");
         mainLayout->addWidget(featuresLabel);
         
@@ -1094,7 +1364,7 @@ void MainWindow::toggleEfficiencyMode()
         scrollLayout->setSpacing(5);
         
         // Add process list header
-        QLabel *processHeader = new QLabel("High resource processes that will be affected:");
+        QLabel *processHeader = new QLabel("High resource processes that may be throttled:");
         processHeader->setStyleSheet("font-weight: bold; color: #fff;");
         scrollLayout->addWidget(processHeader);
         
@@ -1206,7 +1476,8 @@ void MainWindow::onEfficiencyModeChanged(bool enabled)
     // Show status message
     if (enabled) {
         QMessageBox::information(this, "Efficiency Mode Enabled",
-            "Efficiency mode is now active. System resources are being optimized.\n\n"
+            "Efficiency mode is now active. Processes are throttled while they stay busy and released "
+            "once they calm down; the Troubleshoot view lists what is throttled and why.\n\n"
             "You can disable it at any time by clicking the Efficiency Mode button again.");
     } else {
         QMessageBox::information(this, "Efficiency Mode Disabled",
@@ -1214,6 +1485,95 @@ void MainWindow::onEfficiencyModeChanged(bool enabled)
     }
 }
 
+void MainWindow::setAffinityForSelected()
+{
+    const ProcessInfo *process = selectedProcess();
+    if (!process) {
+        return;
+    }
+    qint64 pid = process->pid;
+    QString name = process->name;
+    AffinityDialog dialog(systemInfo->getCpuTopology(), name, ProcessAffinity::get(pid), this);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    QVector<int> cpus = dialog.selectedCpus();
+    if (cpus.isEmpty()) {
+        QMessageBox::warning(this, "Set Affinity", "Select at least one CPU.");
+        return;
+    }
+    QString error;
+    if (!systemInfo->setProcessAffinity(pid, cpus, dialog.includeDescendants(), &error)) {
+        QMessageBox::warning(this, "Set Affinity",
+            QString("Failed to change the affinity of '%1'.\n\n%2").arg(name, error));
+    }
+    frameScheduler->markDirty(processTable);
+}
+
+QVector<qint64> MainWindow::selectedProcessIds() const
+{
+    QVector<qint64> pids;
+    const QModelIndexList rows = processTable->selectionModel()->selectedRows();
+    for (const QModelIndex &index : rows) {
+        // Group headers carry no pid
+        const ProcessInfo *process = processModel->processAt(index.row());
+        if (process && !pids.contains(process->pid)) {
+            pids.append(process->pid);
+        }
+    }
+    return pids;
+}
+
+const ProcessInfo* MainWindow::selectedProcess() const
+{
+    const QModelIndexList rows = processTable->selectionModel()->selectedRows();
+    return rows.isEmpty() ? nullptr : processModel->processAt(rows.first().row());
+}
+
+bool MainWindow::selectProcessByPid(qint64 pid, qint64 startTime)
+{
+    // A process in a collapsed group has no row: open the group and show it now
+    const ProcessGrouping &grouping = systemInfo->getProcessGrouping();
+    const int slot = grouping.slotOfRow(systemInfo->getProcessColumns().rowOf(pid, startTime));
+    const bool searching = searchBox && !searchBox->text().trimmed().isEmpty();
+    if (slot >= 0 && !searching && isGroupCollapsed(grouping.group(slot).key)) {
+        const qint64 key = grouping.group(slot).key;
+        if (!toggledGroups.remove(key)) {
+            toggledGroups.insert(key);
+        }
+        updateProcessTable();
+    }
+    // The pid alone could select a newer process that reused it
+    int row = processModel->rowOfPid(pid);
+    const ProcessInfo *process = row < 0 ? nullptr : processModel->processAt(row);
+    if (!process || process->startTime != startTime) {
+        return false;
+    }
+    processTable->selectRow(row);
+    return true;
+}
+
+void MainWindow::setSchedulingForSelected()
+{
+    QVector<qint64> pids = selectedProcessIds();
+    if (pids.isEmpty()) {
+        return;
+    }
+    QString target = pids.size() == 1
+        ? QString("Scheduling for PID %1").arg(pids.first())
+        : QString("Scheduling for %1 selected processes").arg(pids.size());
+    SchedulingDialog dialog(ProcessScheduling::get(pids.first()), target, this);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+    if (!systemInfo->setProcessScheduling(pids, dialog.scheduling())) {
+        QMessageBox::warning(this, "Set Scheduling",
+            "Some processes could not be changed. Raising priority (negative nice, realtime I/O) "
+            "or changing other users' processes needs elevated privileges.");
+    }
+    frameScheduler->markDirty(processTable);
+}
+
 void MainWindow::updateEfficiencyButtonState()
 {
     if (efficiencyBtn) {
@@ -1260,20 +1620,21 @@ void MainWindow::runNewTask()
 void MainWindow::forceEndTask()
 {
     try {
-        QList<QTableWidgetItem*> selectedItems = processTable->selectedItems();
-        if (selectedItems.isEmpty()) {
+        if (processTable->selectionModel()->selectedRows().isEmpty()) {
             QMessageBox::warning(this, "Warning", "Please select a process to end.");
             return;
         }
 
-        int row = selectedItems.first()->row();
-        QTableWidgetItem* nameItem = processTable->item(row, 0);
-        if (!nameItem || nameItem->text().isEmpty()) {
+        const ProcessInfo *process = selectedProcess();
+        if (!process || process->name.isEmpty()) {
             QMessageBox::warning(this, "Warning", "Please select a valid process.");
             return;
         }
 
-        QString processName = nameItem->text();
+        QString processName = process->name;
+        // The snapshot may move on while the dialogs below are open
+        const qint64 pid = process->pid;
+        const qint64 startTime = process->startTime;
         
         // Check if it's a system process
         bool isSystemProcess = false;
@@ -1339,6 +1700,10 @@ void MainWindow::forceEndTask()
                 }
             }
 
+#ifdef Q_OS_WIN
+            // Ends every instance by name, as this path always has
+            Q_UNUSED(pid);
+            Q_UNUSED(startTime);
             // Convert QString to std::wstring for the process name
             std::wstring wProcessName = processName.toStdWString();
             
@@ -1373,6 +1738,19 @@ void MainWindow::forceEndTask()
             }
 
             CloseHandle(hSnap);
+#else
+            // Only the selected process, and not a newer one that reused its pid
+            if (!systemInfo->isSameProcess(pid, startTime)) {
+                QMessageBox::information(this, "End Task", QString("'%1' has already exited.").arg(processName));
+                return;
+            }
+            const bool processFound = systemInfo->forceTerminateProcess(pid);
+            if (processFound) {
+                QMessageBox::information(this, "Success", isSystemProcess ?
+                    QString("WARNING: System process '%1' has been terminated. Your system may become unstable.").arg(processName) :
+                    QString("Process '%1' has been terminated.").arg(processName));
+            }
+#endif
 
             if (!processFound) {
                 QMessageBox::warning(this, "Error", 
@@ -1387,60 +1765,18 @@ void MainWindow::forceEndTask()
     }
 }
 
-void MainWindow::updateProcessComboBox(QComboBox *comboBox)
-{
-    if (!comboBox) return;
-    
-    // Save current selection and view state
-    QString currentSelection = comboBox->currentText();
-    int currentIndex = comboBox->currentIndex();
-    
-    // Block signals to prevent unnecessary updates
-    bool wasBlocked = comboBox->blockSignals(true);
-    
-    // Clear and update items
-    comboBox->clear();
-    QVector<ProcessInfo> processes = systemInfo->getProcessList();
-    for (const ProcessInfo &proc : processes) {
-        comboBox->addItem(proc.name);
-    }
-    
-    // Restore selection and view position
-    int newIndex = comboBox->findText(currentSelection);
-    if (newIndex >= 0) {
-        comboBox->setCurrentIndex(newIndex);
-    } else if (currentIndex >= 0 && currentIndex < comboBox->count()) {
-        comboBox->setCurrentIndex(currentIndex);
-    }
-    
-    // Ensure the view is properly updated
-    comboBox->view()->update();
-    
-    // Get model index and scroll to it
-    QAbstractItemModel *model = comboBox->model();
-    if (model) {
-        QModelIndex index = model->index(comboBox->currentIndex(), 0);
-        if (index.isValid()) {
-            comboBox->view()->scrollTo(index, QAbstractItemView::PositionAtCenter);
-        }
-    }
-    
-    // Restore signal blocking state
-    comboBox->blockSignals(wasBlocked);
-}
-
-void MainWindow::checkProcessHealth(const QString &processName, QTextEdit *statusDisplay, QTableWidget *diagnosticTable)
+void MainWindow::checkProcessHealth(qint64 pid, qint64 startTime, QTextEdit *statusDisplay, QTableWidget *diagnosticTable)
 {
     statusDisplay->clear();
     diagnosticTable->setRowCount(0);
     
-    // Get process information
+    // Get process information; pid and start time pick the exact instance
     QVector<ProcessInfo> processes = systemInfo->getProcessList();
     ProcessInfo targetProcess;
     bool found = false;
     
     for (const ProcessInfo &proc : processes) {
-        if (proc.name == processName) {
+        if (proc.pid == pid && proc.startTime == startTime) {
             targetProcess = proc;
             found = true;
             break;
@@ -1451,6 +1787,7 @@ void MainWindow::checkProcessHealth(const QString &processName, QTextEdit *statu
         statusDisplay->setText("Process not found or no longer running.");
         return;
     }
+    const QString processName = targetProcess.name;
     
     // Analyze process health
     QString status;
@@ -1469,8 +1806,34 @@ void MainWindow::checkProcessHealth(const QString &processName, QTextEdit *statu
         issues.append({"High Memory Usage", "High", "Check for memory leaks or consider increasing system memory."});
     }
     
+    // Check memory trend: steady growth matters more than absolute size
+    if (targetProcess.memoryLeakSuspected) {
+        QString projection = "Available memory is not projected to run out.";
+        QString severity = "Medium";
+        if (targetProcess.memoryExhaustionSeconds >= 0) {
+            double hours = targetProcess.memoryExhaustionSeconds / 3600.0;
+            projection = QString("At this rate available memory runs out in about %1 hours.").arg(hours, 0, 'f', 1);
+            if (hours < 24.0) {
+                severity = "High";
+            }
+        }
+        issues.append({QString("Steady Memory Growth (+%1 MB/h, fit %2)")
+                           .arg(targetProcess.memoryGrowthMBPerHour, 0, 'f', 0)
+                           .arg(targetProcess.memoryTrendFit, 0, 'f', 2),
+                       severity, projection + " Check for a memory leak."});
+    }
+
+    // Check CPU against the process' own baseline
+    if (targetProcess.cpuZScore >= 4.0) {
+        issues.append({QString("Unusual CPU Activity (%1% vs usual %2%)")
+                           .arg(targetProcess.cpuUsage, 0, 'f', 1)
+                           .arg(targetProcess.cpuBaseline, 0, 'f', 1),
+                       targetProcess.cpuZScore >= 8.0 ? "High" : "Medium",
+                       "The process is using far more CPU than it normally does. Check what it is doing."});
+    }
+
     // Check if process is responding
-    if (targetProcess.status == "Not Responding") {
+    if (targetProcess.status == ProcessStatus::NotResponding) {
         issues.append({"Process Not Responding", "Critical", "Try ending the process and restarting it."});
         hasCriticalIssues = true;
     }
@@ -1479,13 +1842,60 @@ void MainWindow::checkProcessHealth(const QString &processName, QTextEdit *statu
     if (targetProcess.diskUsage > 10.0) {
         issues.append({"High Disk Usage", "Medium", "Check for disk-intensive operations."});
     }
+
+    // Check for stalls: high usage alone does not mean work is waiting
+    if (systemInfo->hasPressureStats()) {
+        PressureStats memoryPressure = systemInfo->getPressure(PressureResource::Memory);
+        PressureStats ioPressure = systemInfo->getPressure(PressureResource::Io);
+        PressureStats cpuPressure = systemInfo->getPressure(PressureResource::Cpu);
+        if (memoryPressure.fullAvg10 > 5.0) {
+            issues.append({QString("System Memory Thrashing (full %1%)").arg(memoryPressure.fullAvg10, 0, 'f', 1), "High",
+                           "All tasks are stalled on memory reclaim. Free memory or stop memory-heavy processes."});
+        } else if (memoryPressure.someAvg10 > 10.0) {
+            issues.append({QString("System Memory Pressure (some %1%)").arg(memoryPressure.someAvg10, 0, 'f', 1), "Medium",
+                           "Tasks are waiting on memory reclaim. Check for memory growth."});
+        }
+        if (ioPressure.fullAvg10 > 10.0) {
+            issues.append({QString("System I/O Stalls (full %1%)").arg(ioPressure.fullAvg10, 0, 'f', 1), "High",
+                           "Storage is saturated. Check the busiest device in the Performance view."});
+        }
+        if (cpuPressure.someAvg10 > 50.0) {
+            issues.append({QString("CPU Contention (some %1%)").arg(cpuPressure.someAvg10, 0, 'f', 1), "Medium",
+                           "Runnable tasks are waiting for a CPU. Consider efficiency mode for background work."});
+        }
+
+        // The process' own cgroup shows whether this workload is the one stalling
+        PressureStats groupMemory = systemInfo->getProcessPressure(targetProcess.pid, PressureResource::Memory);
+        PressureStats groupIo = systemInfo->getProcessPressure(targetProcess.pid, PressureResource::Io);
+        PressureStats groupCpu = systemInfo->getProcessPressure(targetProcess.pid, PressureResource::Cpu);
+        if (groupMemory.available && groupMemory.someAvg10 > 10.0) {
+            issues.append({QString("Process cgroup memory stalls (some %1%)").arg(groupMemory.someAvg10, 0, 'f', 1), "High",
+                           "The process is waiting on memory. Check its memory limit or for leaks."});
+        }
+        if (groupIo.available && groupIo.someAvg10 > 20.0) {
+            issues.append({QString("Process cgroup I/O stalls (some %1%)").arg(groupIo.someAvg10, 0, 'f', 1), "Medium",
+                           "The process spends significant time waiting on I/O."});
+        }
+        if (groupCpu.available && groupCpu.someAvg10 > 30.0) {
+            issues.append({QString("Process cgroup CPU stalls (some %1%)").arg(groupCpu.someAvg10, 0, 'f', 1), "Medium",
+                           "The process is runnable but waiting for CPU, possibly throttled by cpu.max."});
+        }
+    }
     
     // Update status display
     status = QString("Process Health Report for: %1\n\n").arg(processName);
     status += QString("CPU Usage: %1%\n").arg(targetProcess.cpuUsage, 0, 'f', 1);
     status += QString("Memory Usage: %1\n").arg(formatMemorySize(targetProcess.memoryUsage));
+    if (systemInfo->hasMemoryDetail()) {
+        status += QString("Memory Breakdown%1: PSS %2, USS %3, Swap %4, Anon huge pages %5\n")
+            .arg(targetProcess.memoryDetailApproximate ? " (estimated)" : "")
+            .arg(formatMemorySize(targetProcess.pssKb))
+            .arg(formatMemorySize(targetProcess.ussKb))
+            .arg(targetProcess.swapKb < 0 ? QString("unknown") : formatMemorySize(targetProcess.swapKb))
+            .arg(targetProcess.anonHugeKb < 0 ? QString("unknown") : formatMemorySize(targetProcess.anonHugeKb));
+    }
     status += QString("Disk Usage: %1 MB/s\n").arg(targetProcess.diskUsage, 0, 'f', 2);
-    status += QString("Status: %1\n\n").arg(targetProcess.status);
+    status += QString("Status: %1\n\n").arg(processStatusText(targetProcess.status));
     
     if (issues.isEmpty()) {
         status += "No issues detected. Process appears to be running normally.";
@@ -1532,13 +1942,11 @@ void MainWindow::checkProcessHealth(const QString &processName, QTextEdit *statu
 
         if (reply == QMessageBox::Yes) {
             // Find the process in the process table
-            for (int row = 0; row < processTable->rowCount(); ++row) {
-                QTableWidgetItem* nameItem = processTable->item(row, 0);
-                if (nameItem && nameItem->text() == processName) {
-                    processTable->selectRow(row);
-                    forceEndTask();
-                    break;
-                }
+            if (selectProcessByPid(pid, startTime)) {
+                forceEndTask();
+            } else {
+                QMessageBox::warning(this, "Warning", QString("'%1' is not in the process list. "
+                    "It may have exited, or the search may hide it.").arg(processName));
             }
         }
     }
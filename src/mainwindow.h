@@ -3,6 +3,7 @@
 
 #include <QMainWindow>
 #include <QTableWidget>
+#include <QTableView>
 #include <QProgressBar>
 #include <QLabel>
 #include <QTabWidget>
@@ -14,21 +15,29 @@
 #include <QTimer>
 #include <QDateTime>
 #include <QTextEdit>
+#include <QSet>
 #include "systeminfo.h"
+#include "fuzzymatcher.h"
+#include "processtablemodel.h"
+
+class StoragePanel;
+class CpuHeatmapWidget;
+class ThreadPanel;
+class PressurePanel;
+class AlertPanel;
+class EfficiencyPanel;
+class FleetAggregator;
+class FrameScheduler;
+class ProcessPickerModel;
+class ProcessMatchModel;
 
 QT_BEGIN_NAMESPACE
+class QStackedWidget;
 class QVBoxLayout;
 class QHBoxLayout;
 class QHeaderView;
 QT_END_NAMESPACE
 
-// Cache structure for process data
-struct ProcessCache {
-    QVector<ProcessInfo> processes;
-    qint64 timestamp;
-    qint64 totalMemory;
-};
-
 class MainWindow : public QMainWindow {
     Q_OBJECT
 
@@ -36,61 +45,84 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    SystemInfo* getSystemInfo() const { return systemInfo; }
+    // Adds a sidebar view for processes merged from remote agents
+    void addFleetView(FleetAggregator *aggregator);
+    // Upper bound on redraws per second, for snapshots and user actions alike
+    void setMaxFrameRate(int framesPerSecond);
+
 private slots:
-    void updateUI();
-    void onDataUpdated();
     void onSearchTextChanged(const QString &text);
     void onProcessTypeFilterChanged(int index);
+    void onGroupByChanged(int index);
     void onTableHeaderClicked(int column);
     void sortByMemory();
     void sortByCPU();
     void sortByPID();
     void runNewTask();
     void forceEndTask();
-    void sortProcesses(int column, Qt::SortOrder order);
     void toggleEfficiencyMode();
     void onEfficiencyModeChanged(bool enabled);
     void updateEfficiencyButtonState();
     void updateProcessTable();
-    void updateResourceUsage();
-    void updateProcessComboBox(QComboBox *comboBox);
-    void checkProcessHealth(const QString &processName, QTextEdit *statusDisplay, QTableWidget *diagnosticTable);
+    void checkProcessHealth(qint64 pid, qint64 startTime, QTextEdit *statusDisplay, QTableWidget *diagnosticTable);
+    void setAffinityForSelected();
+    void setSchedulingForSelected();
 
 private:
     QTabWidget *tabWidget;
-    QTableWidget *processTable;
+    QTableView *processTable;
+    ProcessTableModel *processModel;
     QProgressBar *cpuBar;
     QProgressBar *memoryBar;
     QProgressBar *diskBar;
     QLabel *cpuLabel;
     QComboBox *processSelect;
+    ProcessPickerModel *pickerModel;
+    ProcessMatchModel *pickerMatches;
     QLabel *memoryLabel;
     QLabel *diskLabel;
     QLabel *cpuSumLabel;
     QLabel *memSumLabel;
     QLabel *diskSumLabel;
     QLabel *netSumLabel;
+    StoragePanel *storagePanel;
+    CpuHeatmapWidget *cpuHeatmap;
+    QLabel *cpuCoresLabel;
+    ThreadPanel *threadPanel;
+    PressurePanel *pressurePanel;
+    AlertPanel *alertPanel;
+    EfficiencyPanel *efficiencyPanel;
     QPushButton *sortMemoryButton;
     QPushButton *sortCPUButton;
     QPushButton *sortPIDButton;
     QPushButton *endTaskButton;
+    QPushButton *affinityButton;
+    QPushButton *schedulingButton;
     QPushButton *efficiencyBtn;
     QLineEdit *searchBox;
+    FuzzyMatcher searchMatcher;
+    quint64 searchMatcherVersion;   // Snapshot the matcher holds the names of
     QComboBox *processTypeFilter;
+    QComboBox *groupBySelect;
+    QSet<qint64> toggledGroups;     // Groups flipped from their default collapsed state
     SystemInfo *systemInfo;
-    QTimer *updateTimer;
-    QTimer *comboBoxUpdateTimer;
+    FrameScheduler *frameScheduler;
+    QStackedWidget *viewStack;
+    QVBoxLayout *sidebarLayout;
+    QList<QPushButton*> sidebarButtons;
 
     // Performance optimization members
-    ProcessCache processCache;
-    qint64 lastUpdateTime;
-    int currentSortColumn;
+    // Only the sort is kept; every render sorts the fresh snapshot
+    int currentSortColumn;      // A column, NO_SORT or PID_SORT
     Qt::SortOrder currentSortOrder;
     bool isSortingEnabled;
     ProcessType currentProcessTypeFilter;
     bool efficiencyModeEnabled;
 
     void setupUI();
+    QPushButton* addSidebarButton(const QString &title);
+    void showView(int index);
     void setupProcessTable();
     void setupSortingButtons();
     void setupSearchBox();
@@ -101,14 +133,21 @@ private:
     void setupTableHeaders();
     QString formatTime(qint64 fileTime);
     QString formatMemorySize(qint64 bytes);
-    void applyProcessStyle(QTableWidgetItem* item, const QString& style);
+    QVector<qint64> selectedProcessIds() const;
+    const ProcessInfo* selectedProcess() const;
+    bool selectProcessByPid(qint64 pid, qint64 startTime);
 
-    // Process table update methods
-    bool shouldUpdateProcessTable();
-    void updateTableContents(const QVector<ProcessInfo> &processes, qint64 totalMemory);
-    void updateTableRow(int row, const ProcessInfo &process, qint64 totalMemory);
-    QTableWidgetItem* createTableItem(const QString &text, const QString &style, double sortValue = 0.0);
-    bool shouldDisplayProcess(const ProcessInfo &process, const QString &searchText);
+    // Render functions run by the frame scheduler
+    void updateResourceSummary();
+    void updatePerformanceView();
+    void updateTroubleshootView();
+    // Orders indexes into processes by currentSortColumn and currentSortOrder
+    void sortProcesses(QVector<int> &order, const QVector<ProcessInfo> &processes) const;
+    void computeGroupTotals(QVector<ProcessTableModel::Group> &groups, const QVector<qint32> &groupOfRow,
+                            const QVector<quint8> &listed) const;
+    bool isGroupCollapsed(qint64 key) const;
+    void respanGroupHeaders();
+    bool shouldDisplayProcess(const ProcessInfo &process);
 };
 
 #endif // MAINWINDOW_H 
\ No newline at end of file
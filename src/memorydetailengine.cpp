@@ -0,0 +1,205 @@
+#include "memorydetailengine.h"
+#include "systeminfo.h"
+#include <QFile>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+inline const char *parseNumber(const char *p, const char *end, qint64 &value)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    qint64 v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        v = v * 10 + (*p - '0');
+        ++p;
+    }
+    value = v;
+    return p;
+}
+
+inline bool startsWith(const char *p, const char *end, const char *key, size_t keyLength)
+{
+    return static_cast<size_t>(end - p) >= keyLength && std::memcmp(p, key, keyLength) == 0;
+}
+
+} // namespace
+
+MemoryDetailEngine::MemoryDetailEngine() :
+    available(QFile::exists("/proc/self/smaps_rollup")),
+    topN(32),
+    detailIntervalTicks(5),
+    selectedPid(-1),
+    tick(0),
+    pageSizeKb(4),
+    procFd(-1),
+    bufferLength(0)
+{
+#ifdef Q_OS_UNIX
+    pageSizeKb = sysconf(_SC_PAGESIZE) / 1024;
+    if (available) {
+        procFd = ::open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    }
+#endif
+    buffer.resize(4096);
+}
+
+MemoryDetailEngine::~MemoryDetailEngine()
+{
+#ifdef Q_OS_UNIX
+    if (procFd >= 0) {
+        ::close(procFd);
+    }
+#endif
+}
+
+bool MemoryDetailEngine::readProcessFile(qint64 pid, const char *name)
+{
+#ifdef Q_OS_UNIX
+    char path[64];
+    std::snprintf(path, sizeof(path), "%lld/%s", static_cast<long long>(pid), name);
+    int fd = procFd >= 0 ? ::openat(procFd, path, O_RDONLY | O_CLOEXEC) : -1;
+    if (fd < 0) {
+        return false;
+    }
+    bufferLength = 0;
+    for (;;) {
+        if (bufferLength == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        ssize_t n = ::read(fd, buffer.data() + bufferLength, size_t(buffer.size() - bufferLength));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            ::close(fd);
+            return n == 0 && bufferLength > 0;
+        }
+        bufferLength += n;
+    }
+#else
+    Q_UNUSED(pid);
+    Q_UNUSED(name);
+    return false;
+#endif
+}
+
+bool MemoryDetailEngine::readSharedKb(qint64 pid, qint64 &sharedKb)
+{
+    if (!readProcessFile(pid, "statm")) {
+        return false;
+    }
+    // size resident shared text lib data dt, in pages
+    const char *p = buffer.constData();
+    const char *end = p + bufferLength;
+    qint64 size, resident, shared;
+    p = parseNumber(p, end, size);
+    p = parseNumber(p, end, resident);
+    parseNumber(p, end, shared);
+    sharedKb = shared * pageSizeKb;
+    return true;
+}
+
+bool MemoryDetailEngine::readSmapsRollup(qint64 pid, Detail &detail)
+{
+    if (!readProcessFile(pid, "smaps_rollup")) {
+        return false;
+    }
+    qint64 privateClean = 0;
+    qint64 privateDirty = 0;
+    const char *p = buffer.constData();
+    const char *end = p + bufferLength;
+    while (p < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        if (!lineEnd) lineEnd = end;
+        if (startsWith(p, lineEnd, "Rss:", 4)) {
+            parseNumber(p + 4, lineEnd, detail.rssKb);
+        } else if (startsWith(p, lineEnd, "Pss:", 4)) {
+            parseNumber(p + 4, lineEnd, detail.pssKb);
+        } else if (startsWith(p, lineEnd, "Private_Clean:", 14)) {
+            parseNumber(p + 14, lineEnd, privateClean);
+        } else if (startsWith(p, lineEnd, "Private_Dirty:", 14)) {
+            parseNumber(p + 14, lineEnd, privateDirty);
+        } else if (startsWith(p, lineEnd, "Swap:", 5)) {
+            parseNumber(p + 5, lineEnd, detail.swapKb);
+        } else if (startsWith(p, lineEnd, "AnonHugePages:", 14)) {
+            parseNumber(p + 14, lineEnd, detail.anonHugeKb);
+        }
+        p = lineEnd + 1;
+    }
+    detail.ussKb = privateClean + privateDirty;
+    return true;
+}
+
+void MemoryDetailEngine::update(QVector<ProcessInfo> &processes)
+{
+    if (!available) {
+        return;
+    }
+    tick++;
+
+    // Expensive pass: smaps_rollup for the top-N by RSS, as read with the
+    // process list, and the selected process
+    bool detailTick = detailIntervalTicks == 1 || tick % detailIntervalTicks == 1;
+    int count = processes.size();
+    int sampled = qMin(topN, count);
+    order.resize(count);
+    for (int i = 0; i < count; ++i) order[i] = i;
+    std::partial_sort(order.begin(), order.begin() + sampled, order.end(), [&processes](int a, int b) {
+        return processes[a].memoryUsage > processes[b].memoryUsage;
+    });
+
+    auto sample = [this](const ProcessInfo &proc) {
+        Detail detail;
+        if (readSmapsRollup(proc.pid, detail)) {
+            detail.startTime = proc.startTime;
+            detail.sampledTick = tick;
+            details.insert(proc.pid, detail);
+        }
+    };
+    if (detailTick) {
+        for (int i = 0; i < sampled; ++i) {
+            sample(processes[order[i]]);
+        }
+    }
+
+    QHash<qint64, Detail> live;
+    live.reserve(details.size());
+    for (ProcessInfo &proc : processes) {
+        if (proc.pid == selectedPid) {
+            auto it = details.constFind(proc.pid);
+            // A newly selected process is sampled right away
+            if (it == details.constEnd() || it->startTime != proc.startTime ||
+                (detailTick && it->sampledTick != tick)) {
+                sample(proc);
+            }
+        }
+        // Values from a recent detail pass are considered exact
+        auto it = details.constFind(proc.pid);
+        if (it != details.constEnd() && it->startTime == proc.startTime &&
+            tick - it->sampledTick < 2 * detailIntervalTicks) {
+            proc.pssKb = it->pssKb;
+            proc.ussKb = it->ussKb;
+            proc.swapKb = it->swapKb;
+            proc.anonHugeKb = it->anonHugeKb;
+            proc.memoryDetailApproximate = false;
+            live.insert(proc.pid, it.value());
+            continue;
+        }
+        // Everyone else: without smaps the private part is the best
+        // estimate for both PSS and USS; swap and huge pages are not known
+        proc.memoryDetailApproximate = true;
+        proc.swapKb = -1;
+        proc.anonHugeKb = -1;
+        qint64 sharedKb = 0;
+        if (readSharedKb(proc.pid, sharedKb)) {
+            proc.ussKb = qMax<qint64>(0, proc.memoryUsage - sharedKb);
+            proc.pssKb = proc.ussKb;
+        }
+    }
+    details.swap(live);
+}
@@ -0,0 +1,59 @@
+#ifndef MEMORYDETAILENGINE_H
+#define MEMORYDETAILENGINE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+
+struct ProcessInfo;
+
+// Fills the per-process memory breakdown (PSS/USS/swap/THP).
+// /proc/[pid]/smaps_rollup walks every mapping of the process, so it is only
+// read for the top-N processes by resident size and the selected process,
+// every few ticks. Everyone else gets PSS and USS estimated from the shared
+// pages in /proc/[pid]/statm, swap and huge pages unknown (-1), and is
+// marked approximate.
+class MemoryDetailEngine {
+public:
+    MemoryDetailEngine();
+    ~MemoryDetailEngine();
+    MemoryDetailEngine(const MemoryDetailEngine &) = delete;
+    MemoryDetailEngine &operator=(const MemoryDetailEngine &) = delete;
+
+    bool isAvailable() const { return available; }
+    void setTopN(int count) { topN = count; }
+    void setDetailInterval(int ticks) { detailIntervalTicks = qMax(1, ticks); }
+    void setSelectedPid(qint64 pid) { selectedPid = pid; }
+
+    void update(QVector<ProcessInfo> &processes);
+
+private:
+    struct Detail {
+        qint64 startTime = 0;
+        qint64 rssKb = 0;
+        qint64 pssKb = 0;
+        qint64 ussKb = 0;
+        qint64 swapKb = 0;
+        qint64 anonHugeKb = 0;
+        qint64 sampledTick = 0;
+    };
+
+    // /proc/[pid]/name into buffer, opened relative to procFd
+    bool readProcessFile(qint64 pid, const char *name);
+    bool readSharedKb(qint64 pid, qint64 &sharedKb);
+    bool readSmapsRollup(qint64 pid, Detail &detail);
+
+    bool available;
+    int topN;
+    int detailIntervalTicks;
+    qint64 selectedPid;
+    qint64 tick;
+    qint64 pageSizeKb;
+    int procFd;
+    QByteArray buffer;
+    qint64 bufferLength;
+    QHash<qint64, Detail> details;
+    QVector<int> order;
+};
+
+#endif // MEMORYDETAILENGINE_H
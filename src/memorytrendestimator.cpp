@@ -0,0 +1,80 @@
+#include "memorytrendestimator.h"
+#include "processcolumns.h"
+#include "systeminfo.h"
+#include <cmath>
+
+MemoryTrendEstimator::MemoryTrendEstimator() :
+    windowSeconds(1800.0),
+    minGrowthMBPerHour(50.0),
+    minFit(0.8)
+{
+}
+
+void MemoryTrendEstimator::update(const ProcessColumns &columns, QVector<ProcessInfo> &processes, double availableKb)
+{
+    const double dt = clock.isValid() ? clock.restart() / 1000.0 : 0.0;
+    if (!clock.isValid()) {
+        clock.start();
+    }
+
+    remapColumn(sumW, columns.previousRow, 0.0);
+    remapColumn(sumT, columns.previousRow, 0.0);
+    remapColumn(sumY, columns.previousRow, 0.0);
+    remapColumn(sumTT, columns.previousRow, 0.0);
+    remapColumn(sumTY, columns.previousRow, 0.0);
+    remapColumn(sumYY, columns.previousRow, 0.0);
+    remapColumn(suspected, columns.previousRow, quint8(0));
+    newRows.clear();
+
+    const int rows = columns.rows;
+    const double *memoryKb = columns.column(ProcessColumns::MemoryKb);
+    const double decay = std::exp(-dt / windowSeconds);
+    double *w = sumW.data();
+    double *t = sumT.data();
+    double *y = sumY.data();
+    double *tt = sumTT.data();
+    double *ty = sumTY.data();
+    double *yy = sumYY.data();
+
+    // Move every earlier sample dt seconds into the past, decay, then add
+    // the new sample at t = 0 (which contributes nothing to the t sums)
+    for (int row = 0; row < rows; ++row) {
+        const double value = memoryKb[row] / 1024.0;  // MB
+        tt[row] = decay * (tt[row] - 2.0 * dt * t[row] + dt * dt * w[row]);
+        ty[row] = decay * (ty[row] - dt * y[row]);
+        t[row] = decay * (t[row] - dt * w[row]);
+        w[row] = decay * w[row] + 1.0;
+        y[row] = decay * y[row] + value;
+        yy[row] = decay * yy[row] + value * value;
+    }
+
+    const double minSlope = minGrowthMBPerHour / 3600.0;
+    for (int row = 0; row < rows; ++row) {
+        ProcessInfo &process = processes[row];
+        const double timeSpread = w[row] * tt[row] - t[row] * t[row];
+        const double valueSpread = w[row] * yy[row] - y[row] * y[row];
+        const double covariance = w[row] * ty[row] - t[row] * y[row];
+        double slope = 0.0;    // MB per second
+        double fit = 0.0;      // r^2 of the weighted line
+        if (timeSpread > 1e-9) {
+            slope = covariance / timeSpread;
+            fit = valueSpread > 1e-9 ? (covariance * covariance) / (timeSpread * valueSpread) : 0.0;
+        }
+        // Weighted spread of sample times approaches the window once the
+        // process has been observed for about that long
+        const bool enoughHistory = w[row] > 0.0 && std::sqrt(timeSpread) / w[row] >= windowSeconds * 0.5;
+
+        if (!suspected[row] && enoughHistory && slope >= minSlope && fit >= minFit) {
+            suspected[row] = 1;
+            newRows.append(row);
+        } else if (suspected[row] && (slope < minSlope * 0.5 || fit < minFit * 0.6)) {
+            suspected[row] = 0;
+        }
+
+        process.memoryGrowthMBPerHour = slope * 3600.0;
+        process.memoryTrendFit = fit;
+        process.memoryLeakSuspected = suspected[row];
+        process.memoryExhaustionSeconds = slope > 0.0 && availableKb > 0.0
+            ? qint64(availableKb / 1024.0 / slope) : -1;
+    }
+}
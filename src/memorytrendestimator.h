@@ -0,0 +1,44 @@
+#ifndef MEMORYTRENDESTIMATOR_H
+#define MEMORYTRENDESTIMATOR_H
+
+#include <QElapsedTimer>
+#include <QVector>
+
+struct ProcessInfo;
+struct ProcessColumns;
+
+// Streaming leak detector. For every process it keeps exponentially decayed
+// least-squares sums over (time, memory) samples, so the growth slope and
+// how well a straight line fits are available in O(1) per sample with six
+// doubles of state. Time is kept relative to the newest sample, which keeps
+// the sums bounded no matter how long a process runs.
+class MemoryTrendEstimator {
+public:
+    MemoryTrendEstimator();
+
+    void setWindowSeconds(double seconds) { windowSeconds = qMax(60.0, seconds); }
+    void setMinGrowthMBPerHour(double growth) { minGrowthMBPerHour = growth; }
+
+    // Rows of columns and processes must match. Fills the memory trend
+    // fields of every process; availableKb is used for the exhaustion estimate.
+    void update(const ProcessColumns &columns, QVector<ProcessInfo> &processes, double availableKb);
+
+    // Rows that started looking like a leak in the last update
+    const QVector<int>& newlySuspected() const { return newRows; }
+
+private:
+    QVector<double> sumW;
+    QVector<double> sumT;
+    QVector<double> sumY;
+    QVector<double> sumTT;
+    QVector<double> sumTY;
+    QVector<double> sumYY;
+    QVector<quint8> suspected;
+    QVector<int> newRows;
+    QElapsedTimer clock;
+    double windowSeconds;
+    double minGrowthMBPerHour;
+    double minFit;
+};
+
+#endif // MEMORYTRENDESTIMATOR_H
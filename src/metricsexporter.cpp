@@ -0,0 +1,275 @@
+#include "metricsexporter.h"
+#include "systeminfo.h"
+#include <QDebug>
+#include <QHostAddress>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUrlQuery>
+#include <algorithm>
+
+namespace {
+
+// Enough prepared responses for a few scrapers with different queries
+const int MAX_CACHED_QUERIES = 8;
+// A query nobody scraped for this many snapshots stops being prepared
+const int MAX_IDLE_SNAPSHOTS = 60;
+const int MAX_REQUEST_BYTES = 8192;
+
+void appendDouble(QByteArray &out, double value)
+{
+    out += QByteArray::number(value, 'g', 10);
+}
+
+void appendHeader(QByteArray &out, const char *name, const char *type, const char *help)
+{
+    out += "# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += "\n# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += '\n';
+}
+
+} // namespace
+
+MetricsExporter::MetricsExporter(SystemInfo *source, QObject *parent) : QObject(parent),
+    systemInfo(source),
+    server(new QTcpServer(this)),
+    maxProcesses(100)
+{
+    notFound = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    connect(server, &QTcpServer::newConnection, this, &MetricsExporter::onNewConnection);
+    connect(systemInfo, &SystemInfo::dataUpdated, this, &MetricsExporter::onSnapshot);
+}
+
+bool MetricsExporter::listen(quint16 port)
+{
+    // Never exposed beyond this host
+    if (!server->listen(QHostAddress::LocalHost, port)) {
+        qWarning() << "Failed to start metrics endpoint on port" << port << server->errorString();
+        return false;
+    }
+    return true;
+}
+
+void MetricsExporter::onSnapshot()
+{
+    for (int index = prepared.size() - 1; index >= 0; --index) {
+        if (++prepared[index].idleSnapshots > MAX_IDLE_SNAPSHOTS) {
+            prepared.removeAt(index);
+        }
+    }
+    if (prepared.isEmpty()) {
+        return;
+    }
+    const QVector<ProcessInfo> processes = systemInfo->getProcessList();
+    for (Prepared &entry : prepared) {
+        prepare(entry, processes);
+    }
+}
+
+void MetricsExporter::prepare(Prepared &entry, const QVector<ProcessInfo> &processes) const
+{
+    static const QByteArray headerTemplate =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+        "Connection: close\r\n"
+        "Content-Length: ";
+    // The buffer keeps its capacity from the last snapshot
+    QByteArray body;
+    body.reserve(entry.response.capacity());
+    serialize(entry.query, processes, body);
+    entry.response.resize(0);
+    entry.response += headerTemplate;
+    entry.response += QByteArray::number(body.size());
+    entry.response += "\r\n\r\n";
+    entry.response += body;
+}
+
+void MetricsExporter::onNewConnection()
+{
+    while (QTcpSocket *socket = server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { handleRequest(socket); });
+    }
+}
+
+void MetricsExporter::handleRequest(QTcpSocket *socket)
+{
+    if (!socket->canReadLine()) {
+        if (socket->bytesAvailable() > MAX_REQUEST_BYTES) {
+            socket->abort();
+        }
+        return;
+    }
+    // Only the request line matters: "GET /metrics?top=10 HTTP/1.1"
+    QList<QByteArray> requestLine = socket->readLine(MAX_REQUEST_BYTES).trimmed().split(' ');
+    socket->disconnect(this);
+    if (requestLine.size() < 2 || requestLine[0] != "GET" || !requestLine[1].startsWith("/metrics")) {
+        socket->write(notFound);
+    } else {
+        socket->write(responseFor(requestLine[1]));
+    }
+    socket->disconnectFromHost();
+}
+
+const QByteArray& MetricsExporter::responseFor(const QByteArray &target)
+{
+    const Query query = parseQuery(target);
+    int index = 0;
+    while (index < prepared.size() && !(prepared[index].query == query)) {
+        ++index;
+    }
+    if (index == prepared.size()) {
+        // First scrape of this query: build it now, then on every snapshot
+        if (prepared.size() >= MAX_CACHED_QUERIES) {
+            prepared.removeLast();
+            --index;
+        }
+        Prepared entry;
+        entry.query = query;
+        prepare(entry, systemInfo->getProcessList());
+        prepared.append(entry);
+    }
+    prepared[index].idleSnapshots = 0;
+    // Most recently scraped first
+    if (index > 0) {
+        prepared.move(index, 0);
+    }
+    return prepared.first().response;
+}
+
+MetricsExporter::Query MetricsExporter::parseQuery(const QByteArray &target) const
+{
+    Query query;
+    query.top = maxProcesses;
+    int separator = target.indexOf('?');
+    if (separator < 0) {
+        return query;
+    }
+    QUrlQuery parameters(QString::fromUtf8(target.mid(separator + 1)));
+    bool ok = false;
+    int top = parameters.queryItemValue("top").toInt(&ok);
+    if (ok && top >= 0) {
+        query.top = qMin(top, maxProcesses);
+    }
+    query.byMemory = parameters.queryItemValue("sort") == "memory";
+    query.name = parameters.queryItemValue("name", QUrl::FullyDecoded).toLower();
+    return query;
+}
+
+void MetricsExporter::appendLabelValue(QByteArray &out, const QString &value)
+{
+    // OpenMetrics escapes backslash, double quote and newline in label values
+    const QByteArray utf8 = value.toUtf8();
+    for (char c : utf8) {
+        switch (c) {
+        case '\\': out += "\\\\"; break;
+        case '"': out += "\\\""; break;
+        case '\n': out += "\\n"; break;
+        default: out += c; break;
+        }
+    }
+}
+
+void MetricsExporter::serialize(const Query &query, const QVector<ProcessInfo> &processes, QByteArray &out) const
+{
+    appendHeader(out, "procmanager_cpu_usage_ratio", "gauge", "Total CPU usage.");
+    out += "procmanager_cpu_usage_ratio ";
+    appendDouble(out, systemInfo->getCpuUsage() / 100.0);
+    out += '\n';
+    appendHeader(out, "procmanager_memory_usage_ratio", "gauge", "Physical memory in use.");
+    out += "procmanager_memory_usage_ratio ";
+    appendDouble(out, systemInfo->getMemoryUsage() / 100.0);
+    out += '\n';
+    appendHeader(out, "procmanager_memory_available_bytes", "gauge", "Physical memory available.");
+    out += "procmanager_memory_available_bytes ";
+    out += QByteArray::number(systemInfo->getAvailableMemoryKb() * 1024);
+    out += '\n';
+    appendHeader(out, "procmanager_disk_busy_ratio", "gauge", "Utilization of the busiest disk.");
+    out += "procmanager_disk_busy_ratio ";
+    appendDouble(out, systemInfo->getDiskUsage() / 100.0);
+    out += '\n';
+    appendHeader(out, "procmanager_processes", "gauge", "Number of processes.");
+    out += "procmanager_processes ";
+    out += QByteArray::number(processes.size());
+    out += '\n';
+    appendHeader(out, "procmanager_health_alerts_active", "gauge", "Health rule alerts currently raised.");
+    out += "procmanager_health_alerts_active ";
+    out += QByteArray::number(systemInfo->getHealthRules().activeCount());
+    out += '\n';
+
+    if (systemInfo->hasPressureStats()) {
+        appendHeader(out, "procmanager_pressure_some_ratio", "gauge", "Share of time some tasks stalled on a resource, 10 s average.");
+        for (PressureResource resource : {PressureResource::Cpu, PressureResource::Memory, PressureResource::Io}) {
+            out += "procmanager_pressure_some_ratio{resource=\"";
+            out += PressureCollector::resourceName(resource).toLatin1();
+            out += "\"} ";
+            appendDouble(out, systemInfo->getPressure(resource).someAvg10 / 100.0);
+            out += '\n';
+        }
+    }
+
+    // Select processes: filter, order, then cap at the configured cardinality
+    QVector<int> rows;
+    rows.reserve(processes.size());
+    for (int row = 0; row < processes.size(); ++row) {
+        if (query.name.isEmpty() || processes[row].name.contains(query.name, Qt::CaseInsensitive)) {
+            rows.append(row);
+        }
+    }
+    const int limit = qMin(query.top, int(rows.size()));
+    const bool byMemory = query.byMemory;
+    auto heavier = [&processes, byMemory](int a, int b) {
+        return byMemory ? processes[a].memoryUsage > processes[b].memoryUsage
+                        : processes[a].cpuUsage > processes[b].cpuUsage;
+    };
+    std::partial_sort(rows.begin(), rows.begin() + limit, rows.end(), heavier);
+    rows.resize(limit);
+
+    struct ProcessMetric {
+        const char *name;
+        const char *help;
+        double (*value)(const ProcessInfo &);
+    };
+    static const ProcessMetric metrics[] = {
+        {"procmanager_process_cpu_ratio", "CPU usage of the process.",
+         [](const ProcessInfo &p) { return p.cpuUsage / 100.0; }},
+        {"procmanager_process_resident_bytes", "Resident memory of the process.",
+         [](const ProcessInfo &p) { return double(p.memoryUsage) * 1024.0; }},
+        {"procmanager_process_pss_bytes", "Proportional set size of the process.",
+         [](const ProcessInfo &p) { return double(p.pssKb) * 1024.0; }},
+        {"procmanager_process_disk_bytes_per_second", "Disk I/O of the process.",
+         [](const ProcessInfo &p) { return p.diskUsage * 1048576.0; }},
+        {"procmanager_process_cpu_anomaly_zscore", "CPU usage relative to the process' own baseline.",
+         [](const ProcessInfo &p) { return p.cpuZScore; }},
+        {"procmanager_process_memory_growth_bytes_per_second", "Memory growth trend of the process.",
+         [](const ProcessInfo &p) { return p.memoryGrowthMBPerHour * 1048576.0 / 3600.0; }},
+    };
+
+    // Labels are the same for every metric of a process; build them once
+    QVector<QByteArray> labels;
+    labels.reserve(rows.size());
+    for (int row : rows) {
+        const ProcessInfo &process = processes[row];
+        QByteArray label = "{pid=\"";
+        label += QByteArray::number(process.pid);
+        label += "\",name=\"";
+        appendLabelValue(label, process.name);
+        label += "\"} ";
+        labels.append(label);
+    }
+    for (const ProcessMetric &metric : metrics) {
+        appendHeader(out, metric.name, "gauge", metric.help);
+        for (int index = 0; index < rows.size(); ++index) {
+            out += metric.name;
+            out += labels[index];
+            appendDouble(out, metric.value(processes[rows[index]]));
+            out += '\n';
+        }
+    }
+    out += "# EOF\n";
+}
@@ -0,0 +1,68 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+class QTcpServer;
+class QTcpSocket;
+class SystemInfo;
+struct ProcessInfo;
+
+// Serves the latest snapshot in OpenMetrics text format on a localhost-only
+// HTTP endpoint. Responses for the recently scraped queries are built when
+// a snapshot arrives, so a scrape only writes out a prepared buffer.
+//
+//   GET /metrics                       top processes by CPU
+//   GET /metrics?top=20&sort=memory    top 20 by resident memory
+//   GET /metrics?name=postgres         processes whose name contains "postgres"
+class MetricsExporter : public QObject {
+    Q_OBJECT
+
+public:
+    explicit MetricsExporter(SystemInfo *source, QObject *parent = nullptr);
+
+    bool listen(quint16 port);
+    // Upper bound on per-process series, whatever the query asks for
+    void setMaxProcesses(int count) { maxProcesses = qMax(0, count); prepared.clear(); }
+
+private slots:
+    void onSnapshot();
+    void onNewConnection();
+
+private:
+    // Normalized, so targets that select the same series share a response
+    struct Query {
+        int top = 0;            // Already capped at maxProcesses
+        bool byMemory = false;
+        QString name;           // Lower case; matching ignores case
+
+        bool operator==(const Query &other) const {
+            return top == other.top && byMemory == other.byMemory && name == other.name;
+        }
+    };
+
+    struct Prepared {
+        Query query;
+        QByteArray response;
+        int idleSnapshots = 0;  // Since the last scrape
+    };
+
+    void handleRequest(QTcpSocket *socket);
+    const QByteArray& responseFor(const QByteArray &target);
+    void prepare(Prepared &prepared, const QVector<ProcessInfo> &processes) const;
+    void serialize(const Query &query, const QVector<ProcessInfo> &processes, QByteArray &out) const;
+    Query parseQuery(const QByteArray &target) const;
+    static void appendLabelValue(QByteArray &out, const QString &value);
+
+    SystemInfo *systemInfo;
+    QTcpServer *server;
+    int maxProcesses;
+    // Least recently scraped last; evicted from the back
+    QVector<Prepared> prepared;
+    QByteArray notFound;
+};
+
+#endif // METRICSEXPORTER_H
@@ -0,0 +1,39 @@
+#include "numberformat.h"
+#include <charconv>
+#include <cstring>
+
+namespace numberformat {
+
+namespace {
+
+// Enough for any value a cell shows; larger ones take the slow path
+const int DIGITS_ROOM = 48;
+const int SUFFIX_ROOM = 16;
+
+} // namespace
+
+QString fixed(double value, int decimals, const char *suffix)
+{
+    char buffer[DIGITS_ROOM + SUFFIX_ROOM];
+    std::to_chars_result result = std::to_chars(buffer, buffer + DIGITS_ROOM, value, std::chars_format::fixed, decimals);
+    size_t suffixLength = std::strlen(suffix);
+    if (result.ec != std::errc() || suffixLength > size_t(SUFFIX_ROOM)) {
+        return QString::number(value, 'f', decimals) + QString::fromUtf8(suffix);
+    }
+    std::memcpy(result.ptr, suffix, suffixLength);
+    return QString::fromUtf8(buffer, int(result.ptr - buffer) + int(suffixLength));
+}
+
+QString memorySize(qint64 kb)
+{
+    static const char *const units[] = {" KB", " MB", " GB", " TB"};
+    int unit = 0;
+    double size = static_cast<double>(kb);
+    while (size >= 1024.0 && unit < 3) {
+        size /= 1024.0;
+        unit++;
+    }
+    return fixed(size, 2, units[unit]);
+}
+
+} // namespace numberformat
@@ -0,0 +1,18 @@
+#ifndef NUMBERFORMAT_H
+#define NUMBERFORMAT_H
+
+#include <QString>
+
+// Number to text for table cells. Digits are produced with std::to_chars
+// into a stack buffer and converted once, instead of going through
+// QString::number and QString::arg with their temporary strings.
+namespace numberformat {
+
+// value with a fixed number of decimals, followed by suffix (UTF-8, short)
+QString fixed(double value, int decimals, const char *suffix = "");
+// Kilobytes scaled to KB, MB, GB or TB with two decimals, as "1.50 GB"
+QString memorySize(qint64 kb);
+
+} // namespace numberformat
+
+#endif // NUMBERFORMAT_H
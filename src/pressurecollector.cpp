@@ -0,0 +1,151 @@
+#include "pressurecollector.h"
+#include <QDebug>
+#include <QFile>
+#include <QSocketNotifier>
+#include <cstdio>
+#include <cstring>
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char *const CGROUP2_ROOT = "/sys/fs/cgroup";
+
+} // namespace
+
+PressureCollector::PressureCollector(QObject *parent) : QObject(parent),
+    available(QFile::exists("/proc/pressure/cpu"))
+{
+}
+
+PressureCollector::~PressureCollector()
+{
+#ifdef Q_OS_LINUX
+    for (Trigger &trigger : triggers) {
+        delete trigger.notifier;
+        if (trigger.fd >= 0) {
+            ::close(trigger.fd);
+        }
+    }
+#endif
+}
+
+QString PressureCollector::resourceName(PressureResource resource)
+{
+    switch (resource) {
+    case PressureResource::Cpu: return "cpu";
+    case PressureResource::Memory: return "memory";
+    case PressureResource::Io: return "io";
+    }
+    return QString();
+}
+
+bool PressureCollector::readPressureFile(const QString &path, PressureStats &stats)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        stats.available = false;
+        return false;
+    }
+    char line[256];
+    while (file.readLine(line, sizeof(line)) > 0) {
+        double avg10 = 0.0, avg60 = 0.0, avg300 = 0.0;
+        if (std::sscanf(line, "some avg10=%lf avg60=%lf avg300=%lf", &avg10, &avg60, &avg300) == 3) {
+            stats.someAvg10 = avg10;
+            stats.someAvg60 = avg60;
+            stats.someAvg300 = avg300;
+        } else if (std::sscanf(line, "full avg10=%lf avg60=%lf avg300=%lf", &avg10, &avg60, &avg300) == 3) {
+            stats.fullAvg10 = avg10;
+            stats.fullAvg60 = avg60;
+            stats.fullAvg300 = avg300;
+        }
+    }
+    stats.available = true;
+    return true;
+}
+
+void PressureCollector::update()
+{
+    if (!available) {
+        return;
+    }
+    for (PressureResource resource : {PressureResource::Cpu, PressureResource::Memory, PressureResource::Io}) {
+        readPressureFile("/proc/pressure/" + resourceName(resource), stats[static_cast<int>(resource)]);
+    }
+}
+
+PressureStats PressureCollector::systemPressure(PressureResource resource) const
+{
+    return stats[static_cast<int>(resource)];
+}
+
+QString PressureCollector::cgroupOfProcess(qint64 pid)
+{
+    // cgroup v2 has a single hierarchy, listed as "0::/path"
+    QFile file(QString("/proc/%1/cgroup").arg(pid));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    char line[4096];
+    while (file.readLine(line, sizeof(line)) > 0) {
+        if (std::strncmp(line, "0::", 3) == 0) {
+            return QString::fromUtf8(line + 3).trimmed();
+        }
+    }
+    return QString();
+}
+
+PressureStats PressureCollector::cgroupPressure(const QString &cgroupPath, PressureResource resource)
+{
+    PressureStats result;
+    if (!cgroupPath.isEmpty()) {
+        readPressureFile(QString("%1%2/%3.pressure").arg(CGROUP2_ROOT, cgroupPath, resourceName(resource)), result);
+    }
+    return result;
+}
+
+bool PressureCollector::addTrigger(PressureResource resource, bool full, int stallUs, int windowUs)
+{
+#ifdef Q_OS_LINUX
+    if (!available) {
+        return false;
+    }
+    QByteArray path = "/proc/pressure/" + resourceName(resource).toLatin1();
+    int fd = ::open(path.constData(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    // The kernel expects the trailing NUL to be written as well
+    QByteArray spec = QByteArray(full ? "full " : "some ") + QByteArray::number(stallUs) + " " + QByteArray::number(windowUs);
+    if (::write(fd, spec.constData(), spec.size() + 1) < 0) {
+        // Unprivileged users need a window that is a multiple of 2 s
+        qWarning() << "Failed to arm PSI trigger" << spec;
+        ::close(fd);
+        return false;
+    }
+
+    Trigger trigger;
+    trigger.fd = fd;
+    trigger.resource = resource;
+    trigger.description = QString("%1 %2 stall of %3 ms within %4 ms")
+        .arg(resourceName(resource), full ? "full" : "some")
+        .arg(stallUs / 1000)
+        .arg(windowUs / 1000);
+    // Trigger events are reported as POLLPRI, which QSocketNotifier maps to Exception
+    trigger.notifier = new QSocketNotifier(fd, QSocketNotifier::Exception);
+    QString description = trigger.description;
+    connect(trigger.notifier, &QSocketNotifier::activated, this, [this, resource, description]() {
+        emit stallDetected(resource, description);
+    });
+    triggers.append(trigger);
+    return true;
+#else
+    Q_UNUSED(resource);
+    Q_UNUSED(full);
+    Q_UNUSED(stallUs);
+    Q_UNUSED(windowUs);
+    return false;
+#endif
+}
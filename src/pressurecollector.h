@@ -0,0 +1,68 @@
+#ifndef PRESSURECOLLECTOR_H
+#define PRESSURECOLLECTOR_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+class QSocketNotifier;
+
+enum class PressureResource {
+    Cpu,
+    Memory,
+    Io
+};
+
+// One /proc/pressure/<resource> or <cgroup>/<resource>.pressure file.
+// "some": share of time at least one task was stalled on the resource,
+// "full": share of time all non-idle tasks were stalled at once.
+struct PressureStats {
+    bool available = false;
+    double someAvg10 = 0.0;
+    double someAvg60 = 0.0;
+    double someAvg300 = 0.0;
+    double fullAvg10 = 0.0;
+    double fullAvg60 = 0.0;
+    double fullAvg300 = 0.0;
+};
+
+// Collects pressure stall information (PSI) system-wide and per cgroup, and
+// arms PSI triggers so stalls shorter than the sampling interval are
+// reported as they happen instead of being averaged away.
+class PressureCollector : public QObject {
+    Q_OBJECT
+
+public:
+    explicit PressureCollector(QObject *parent = nullptr);
+    ~PressureCollector();
+
+    bool isAvailable() const { return available; }
+    void update();
+    PressureStats systemPressure(PressureResource resource) const;
+
+    static QString resourceName(PressureResource resource);
+    static QString cgroupOfProcess(qint64 pid);
+    static PressureStats cgroupPressure(const QString &cgroupPath, PressureResource resource);
+
+    // Fires stallDetected when tasks are stalled for stallUs within windowUs
+    bool addTrigger(PressureResource resource, bool full, int stallUs, int windowUs);
+
+signals:
+    void stallDetected(PressureResource resource, const QString &description);
+
+private:
+    struct Trigger {
+        int fd = -1;
+        PressureResource resource = PressureResource::Cpu;
+        QString description;
+        QSocketNotifier *notifier = nullptr;
+    };
+
+    static bool readPressureFile(const QString &path, PressureStats &stats);
+
+    bool available;
+    PressureStats stats[3];
+    QVector<Trigger> triggers;
+};
+
+#endif // PRESSURECOLLECTOR_H
@@ -0,0 +1,85 @@
+#include "pressurepanel.h"
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QDateTime>
+
+namespace {
+
+QColor pressureColor(double percent)
+{
+    if (percent >= 40.0) return QColor("#FF4444");
+    if (percent >= 10.0) return QColor("#FFA500");
+    if (percent >= 1.0) return QColor("#FFD700");
+    return QColor("#4CAF50");
+}
+
+} // namespace
+
+PressurePanel::PressurePanel(QWidget *parent) : QWidget(parent),
+    pressureTable(nullptr),
+    stallLabel(nullptr),
+    stallEvents(0)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(8);
+
+    QLabel *title = new QLabel("Pressure Stall Information (% of time stalled)");
+    stallLabel = new QLabel("No stall events since start");
+    stallLabel->setStyleSheet("color:#b0b0b0;");
+
+    pressureTable = new QTableWidget(3, 4);
+    pressureTable->setHorizontalHeaderLabels({"Some avg10", "Some avg60", "Full avg10", "Full avg60"});
+    pressureTable->setVerticalHeaderLabels({"CPU", "Memory", "I/O"});
+    pressureTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    pressureTable->setSelectionMode(QAbstractItemView::NoSelection);
+    pressureTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    pressureTable->setFixedHeight(130);
+    pressureTable->setStyleSheet(R"(
+        QTableWidget {
+            background-color: #232323;
+            color: #ffffff;
+            border: 1px solid #3a3a3a;
+            border-radius: 4px;
+            gridline-color: #3a3a3a;
+        }
+    )");
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            QTableWidgetItem *item = new QTableWidgetItem("-");
+            item->setTextAlignment(Qt::AlignCenter);
+            pressureTable->setItem(row, column, item);
+        }
+    }
+
+    layout->addWidget(title);
+    layout->addWidget(pressureTable);
+    layout->addWidget(stallLabel);
+}
+
+void PressurePanel::updatePressure(const PressureStats &cpu, const PressureStats &memory, const PressureStats &io)
+{
+    const PressureStats *rows[] = {&cpu, &memory, &io};
+    for (int row = 0; row < 3; ++row) {
+        const PressureStats &stats = *rows[row];
+        double values[] = {stats.someAvg10, stats.someAvg60, stats.fullAvg10, stats.fullAvg60};
+        for (int column = 0; column < 4; ++column) {
+            QTableWidgetItem *item = pressureTable->item(row, column);
+            item->setText(stats.available ? QString("%1%").arg(values[column], 0, 'f', 2) : "-");
+            item->setForeground(pressureColor(values[column]));
+        }
+    }
+}
+
+void PressurePanel::onStallDetected(PressureResource resource, const QString &description)
+{
+    Q_UNUSED(resource);
+    stallEvents++;
+    stallLabel->setText(QString("Stall events: %1 - last at %2: %3")
+        .arg(stallEvents)
+        .arg(QDateTime::currentDateTime().toString("hh:mm:ss"))
+        .arg(description));
+    stallLabel->setStyleSheet("color:#FFA500;");
+}
@@ -0,0 +1,30 @@
+#ifndef PRESSUREPANEL_H
+#define PRESSUREPANEL_H
+
+#include <QWidget>
+#include "pressurecollector.h"
+
+QT_BEGIN_NAMESPACE
+class QLabel;
+class QTableWidget;
+QT_END_NAMESPACE
+
+// Performance view section with system-wide PSI averages and trigger events
+class PressurePanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit PressurePanel(QWidget *parent = nullptr);
+
+    void updatePressure(const PressureStats &cpu, const PressureStats &memory, const PressureStats &io);
+
+public slots:
+    void onStallDetected(PressureResource resource, const QString &description);
+
+private:
+    QTableWidget *pressureTable;
+    QLabel *stallLabel;
+    int stallEvents;
+};
+
+#endif // PRESSUREPANEL_H
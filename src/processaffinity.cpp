@@ -0,0 +1,149 @@
+#include "processaffinity.h"
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <cstring>
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Large enough for every CPU the kernel can report
+const int MAX_CPUS = 4096;
+
+#ifdef Q_OS_LINUX
+// Fixed-size set for the *_S macros; on the stack it costs no allocation,
+// unlike CPU_ALLOC, which get() would otherwise pay for every process
+struct CpuSet {
+    cpu_set_t words[MAX_CPUS / CPU_SETSIZE];
+
+    cpu_set_t *data() { return words; }
+    static constexpr size_t size() { return sizeof(words); }
+};
+#endif
+
+} // namespace
+
+bool ProcessAffinity::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+QVector<int> ProcessAffinity::get(qint64 pid)
+{
+    QVector<int> cpus;
+#ifdef Q_OS_LINUX
+    CpuSet cpuSet;
+    cpu_set_t *set = cpuSet.data();
+    const size_t size = CpuSet::size();
+    CPU_ZERO_S(size, set);
+    if (sched_getaffinity(static_cast<pid_t>(pid), size, set) == 0) {
+        // Stop at the last set bit instead of scanning all MAX_CPUS
+        int remaining = CPU_COUNT_S(size, set);
+        cpus.reserve(remaining);
+        for (int cpu = 0; cpu < MAX_CPUS && remaining > 0; ++cpu) {
+            if (CPU_ISSET_S(cpu, size, set)) {
+                cpus.append(cpu);
+                --remaining;
+            }
+        }
+    }
+#else
+    Q_UNUSED(pid);
+#endif
+    return cpus;
+}
+
+QVector<qint64> ProcessAffinity::descendants(qint64 pid)
+{
+    QVector<qint64> result;
+#ifdef Q_OS_LINUX
+    // Build the parent -> children map from one pass over /proc
+    QHash<qint64, QVector<qint64>> children;
+    const QStringList entries = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &entry : entries) {
+        bool ok = false;
+        qint64 child = entry.toLongLong(&ok);
+        if (!ok) {
+            continue;
+        }
+        QFile file(QString("/proc/%1/stat").arg(child));
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        QByteArray stat = file.read(512);
+        int end = stat.lastIndexOf(')');
+        if (end < 0) {
+            continue;
+        }
+        // Fields after the command name: state ppid ...
+        QList<QByteArray> fields = stat.mid(end + 2).split(' ');
+        if (fields.size() > 1) {
+            children[fields[1].toLongLong()].append(child);
+        }
+    }
+    QVector<qint64> pending = children.value(pid);
+    while (!pending.isEmpty()) {
+        qint64 next = pending.takeLast();
+        result.append(next);
+        pending += children.value(next);
+    }
+#else
+    Q_UNUSED(pid);
+#endif
+    return result;
+}
+
+bool ProcessAffinity::set(qint64 pid, const QVector<int> &cpus, bool includeDescendants, QString *error)
+{
+#ifdef Q_OS_LINUX
+    if (cpus.isEmpty()) {
+        if (error) *error = "No CPUs selected";
+        return false;
+    }
+    CpuSet cpuSet;
+    cpu_set_t *set = cpuSet.data();
+    const size_t size = CpuSet::size();
+    CPU_ZERO_S(size, set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < MAX_CPUS) {
+            CPU_SET_S(cpu, size, set);
+        }
+    }
+
+    QVector<qint64> processes = {pid};
+    if (includeDescendants) {
+        processes += descendants(pid);
+    }
+
+    int failures = 0;
+    int lastErrno = 0;
+    for (qint64 process : processes) {
+        const QStringList tasks = QDir(QString("/proc/%1/task").arg(process)).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString &task : tasks) {
+            // Threads may exit between listing and the call; that is not a failure
+            if (sched_setaffinity(static_cast<pid_t>(task.toLongLong()), size, set) != 0 && errno != ESRCH) {
+                ++failures;
+                lastErrno = errno;
+            }
+        }
+    }
+
+    if (failures > 0 && error) {
+        *error = QString("%1 threads could not be changed: %2").arg(failures).arg(QString::fromLocal8Bit(std::strerror(lastErrno)));
+    }
+    return failures == 0;
+#else
+    Q_UNUSED(pid);
+    Q_UNUSED(cpus);
+    Q_UNUSED(includeDescendants);
+    if (error) *error = "CPU affinity is not supported on this platform";
+    return false;
+#endif
+}
@@ -0,0 +1,23 @@
+#ifndef PROCESSAFFINITY_H
+#define PROCESSAFFINITY_H
+
+#include <QString>
+#include <QVector>
+
+// CPU affinity of processes. Linux applies affinity per thread, so setting
+// it walks /proc/[pid]/task and calls sched_setaffinity() on every thread.
+class ProcessAffinity {
+public:
+    static bool isSupported();
+
+    // Allowed CPUs of the main thread; empty if it could not be read
+    static QVector<int> get(qint64 pid);
+
+    // Applies to every thread of pid, and of all its descendants if
+    // includeDescendants is set. Returns false if any thread failed.
+    static bool set(qint64 pid, const QVector<int> &cpus, bool includeDescendants, QString *error = nullptr);
+
+    static QVector<qint64> descendants(qint64 pid);
+};
+
+#endif // PROCESSAFFINITY_H
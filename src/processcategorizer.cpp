@@ -1,8 +1,11 @@
 #include "processcategorizer.h"
 #include <QDebug>
+#ifdef Q_OS_WIN
+#include <windows.h>
 #include <tlhelp32.h>
 #include <processthreadsapi.h>
 #include <winsvc.h>
+#endif
 
 ProcessCategorizer& ProcessCategorizer::getInstance()
 {
@@ -48,6 +51,7 @@ ProcessCategorizer::ProcessCategorizer()
 
 void ProcessCategorizer::initializeSystemProcesses()
 {
+#ifdef Q_OS_WIN
     // Common Windows system processes
     knownProcesses["System"] = ProcessType::System;
     knownProcesses["System Idle Process"] = ProcessType::System;
@@ -69,39 +73,51 @@ void ProcessCategorizer::initializeSystemProcesses()
     knownProcesses["StartMenuExperienceHost.exe"] = ProcessType::System;
     knownProcesses["TextInputHost.exe"] = ProcessType::System;
     knownProcesses["WmiPrvSE.exe"] = ProcessType::System;
+#else
+    // Common Linux system processes; kernel threads are recognised by parent
+    knownProcesses["systemd"] = ProcessType::System;
+    knownProcesses["init"] = ProcessType::System;
+    knownProcesses["systemd-journald"] = ProcessType::System;
+    knownProcesses["systemd-logind"] = ProcessType::System;
+    knownProcesses["systemd-udevd"] = ProcessType::System;
+    knownProcesses["dbus-daemon"] = ProcessType::System;
+    knownProcesses["dbus-broker"] = ProcessType::System;
+    knownProcesses["Xorg"] = ProcessType::System;
+    knownProcesses["Xwayland"] = ProcessType::System;
+#endif
 }
 
-bool ProcessCategorizer::isSystemProcess(const QString& name, DWORD pid) const
+bool ProcessCategorizer::isSystemProcess(const QString& name, const QString& path) const
 {
     // Check if it's a known system process
-    if (knownProcesses.contains(name) && knownProcesses[name] == ProcessType::System) {
+    if (knownProcesses.value(name, ProcessType::Unknown) == ProcessType::System) {
         return true;
     }
     
     // Check if process is running from system directories
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pid);
-    if (hProcess) {
-        wchar_t path[MAX_PATH];
-        if (GetModuleFileNameExW(hProcess, nullptr, path, MAX_PATH)) {
-            QString processPath = QString::fromWCharArray(path).toLower();
-            // Check if process is running from Windows system directories
-            if (processPath.contains("\\windows\\system32\\") ||
-                processPath.contains("\\windows\\syswow64\\") ||
-                processPath.contains("\\program files\\") ||
-                processPath.contains("\\program files (x86)\\")) {
-                CloseHandle(hProcess);
-                return true;
-            }
+#ifdef Q_OS_WIN
+    for (const char *directory : {"\\windows\\system32\\", "\\windows\\syswow64\\",
+                                  "\\program files\\", "\\program files (x86)\\"}) {
+        if (path.contains(QLatin1String(directory), Qt::CaseInsensitive)) {
+            return true;
         }
-        CloseHandle(hProcess);
     }
+#else
+    for (const char *directory : {"/sbin/", "/usr/sbin/", "/lib/systemd/", "/usr/lib/systemd/"}) {
+        if (path.startsWith(QLatin1String(directory))) {
+            return true;
+        }
+    }
+#endif
     
     return false;
 }
 
-bool ProcessCategorizer::isBackgroundService(DWORD pid) const
+bool ProcessCategorizer::isBackgroundService(qint64 pid, const QString& cgroupPath) const
 {
-    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, pid);
+#ifdef Q_OS_WIN
+    Q_UNUSED(cgroupPath);
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, static_cast<DWORD>(pid));
     if (hProcess) {
         // Check if process is a service
         SC_HANDLE scm = OpenSCManager(nullptr, nullptr, SC_MANAGER_CONNECT);
@@ -123,7 +139,7 @@ bool ProcessCategorizer::isBackgroundService(DWORD pid) const
                                        SERVICE_STATE_ALL, buffer.data(), buffer.size(),
                                        &bytesNeeded, &servicesReturned, nullptr, nullptr)) {
                     for (DWORD i = 0; i < servicesReturned; i++) {
-                        if (services[i].ServiceStatusProcess.dwProcessId == pid) {
+                        if (services[i].ServiceStatusProcess.dwProcessId == static_cast<DWORD>(pid)) {
                             CloseServiceHandle(scm);
                             CloseHandle(hProcess);
                             return true;
@@ -136,32 +152,38 @@ bool ProcessCategorizer::isBackgroundService(DWORD pid) const
         CloseHandle(hProcess);
     }
     return false;
+#else
+    // systemd runs services, system and per-user, in a cgroup named after
+    // the unit; apps and terminals run in .scope units instead
+    Q_UNUSED(pid);
+    return cgroupPath.endsWith(".service");
+#endif
 }
 
-ProcessCategory ProcessCategorizer::categorizeProcess(const QString& name, DWORD pid)
+ProcessCategory ProcessCategorizer::categorizeProcess(const QString& name, const QString& path, qint64 pid,
+                                                     const QString& cgroupPath)
 {
     ProcessCategory category;
     
-    if (isSystemProcess(name, pid)) {
+    if (isSystemProcess(name, path)) {
         category.type = ProcessType::System;
-    } else if (isBackgroundService(pid)) {
+    } else if (isBackgroundService(pid, cgroupPath)) {
         category.type = ProcessType::Background;
     } else {
         category.type = ProcessType::Application;
     }
     
-    category.description = typeDescriptions[category.type];
-    category.style = typeStyles[category.type];
-    
     return category;
 }
 
-QString ProcessCategorizer::getProcessStyle(ProcessType type) const
+const QString& ProcessCategorizer::getProcessStyle(ProcessType type) const
 {
-    return typeStyles.value(type, typeStyles[ProcessType::Unknown]);
+    auto it = typeStyles.constFind(type);
+    return it != typeStyles.constEnd() ? *it : typeStyles.find(ProcessType::Unknown).value();
 }
 
-QString ProcessCategorizer::getProcessDescription(ProcessType type) const
+const QString& ProcessCategorizer::getProcessDescription(ProcessType type) const
 {
-    return typeDescriptions.value(type, typeDescriptions[ProcessType::Unknown]);
+    auto it = typeDescriptions.constFind(type);
+    return it != typeDescriptions.constEnd() ? *it : typeDescriptions.find(ProcessType::Unknown).value();
 } 
\ No newline at end of file
@@ -3,11 +3,9 @@
 
 #include <QString>
 #include <QMap>
-#include <windows.h>
-#include <psapi.h>
 
 enum class ProcessType {
-    System,         // Windows system processes
+    System,         // Operating system processes
     Background,     // Background services
     Application,    // User applications
     Unknown        // Unclassified processes
@@ -15,17 +13,19 @@ enum class ProcessType {
 
 struct ProcessCategory {
     ProcessType type;
-    QString description;
-    QString style;  // CSS style for visual differentiation
 };
 
 class ProcessCategorizer {
 public:
     static ProcessCategorizer& getInstance();
     
-    ProcessCategory categorizeProcess(const QString& name, DWORD pid);
-    QString getProcessStyle(ProcessType type) const;
-    QString getProcessDescription(ProcessType type) const;
+    // path is the executable path if known, used to spot system binaries;
+    // cgroupPath tells services apart on Linux and is unused elsewhere
+    ProcessCategory categorizeProcess(const QString& name, const QString& path, qint64 pid,
+                                      const QString& cgroupPath = QString());
+    // Shared per type, so callers never need their own copy
+    const QString& getProcessStyle(ProcessType type) const;
+    const QString& getProcessDescription(ProcessType type) const;
     
 private:
     ProcessCategorizer();  // Private constructor for singleton
@@ -36,8 +36,8 @@ private:
     ProcessCategorizer& operator=(const ProcessCategorizer&) = delete;
     
     void initializeSystemProcesses();
-    bool isSystemProcess(const QString& name, DWORD pid) const;
-    bool isBackgroundService(DWORD pid) const;
+    bool isSystemProcess(const QString& name, const QString& path) const;
+    bool isBackgroundService(qint64 pid, const QString& cgroupPath) const;
     
     QMap<QString, ProcessType> knownProcesses;
     QMap<ProcessType, QString> typeDescriptions;
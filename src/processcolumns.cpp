@@ -0,0 +1,80 @@
+#include "processcolumns.h"
+#include "systeminfo.h"
+
+void ProcessColumns::assign(const QVector<ProcessInfo> &processes)
+{
+    rows = processes.size();
+    pid.resize(rows);
+    startTime.resize(rows);
+    name.resize(rows);
+    type.resize(rows);
+    parentPid.resize(rows);
+    nameId.resize(rows);
+    userId.resize(rows);
+    containerId.resize(rows);
+    previousRow.resize(rows);
+    for (QVector<double> &values : metrics) {
+        values.resize(rows);
+    }
+
+    double *cpu = metrics[Cpu].data();
+    double *memory = metrics[MemoryKb].data();
+    double *pss = metrics[PssKb].data();
+    double *swap = metrics[SwapKb].data();
+    double *disk = metrics[DiskMBps].data();
+    double *network = metrics[NetworkMBps].data();
+    double *cpuZScore = metrics[CpuZScore].data();
+
+    QHash<Identity, int> currentIndex;
+    currentIndex.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        const ProcessInfo &process = processes[row];
+        pid[row] = process.pid;
+        startTime[row] = process.startTime;
+        name[row] = process.name;
+        type[row] = process.type;
+        parentPid[row] = process.parentPid;
+        nameId[row] = process.nameId;
+        userId[row] = process.userId;
+        containerId[row] = process.containerId;
+        cpu[row] = process.cpuUsage;
+        memory[row] = double(process.memoryUsage);
+        pss[row] = double(process.pssKb);
+        swap[row] = double(process.swapKb);
+        disk[row] = process.diskUsage;
+        network[row] = process.networkUsage;
+        cpuZScore[row] = process.cpuZScore;
+
+        Identity identity{process.pid, process.startTime};
+        previousRow[row] = previousIndex.value(identity, -1);
+        currentIndex.insert(identity, row);
+    }
+    previousIndex.swap(currentIndex);
+}
+
+QString ProcessColumns::metricName(Metric metric)
+{
+    switch (metric) {
+    case Cpu: return "cpu";
+    case MemoryKb: return "memoryKb";
+    case PssKb: return "pssKb";
+    case SwapKb: return "swapKb";
+    case DiskMBps: return "diskMBps";
+    case NetworkMBps: return "networkMBps";
+    case CpuZScore: return "cpuZScore";
+    case MetricCount: break;
+    }
+    return QString();
+}
+
+ProcessColumns::Metric ProcessColumns::metricFromName(const QString &name, bool *ok)
+{
+    for (int metric = 0; metric < MetricCount; ++metric) {
+        if (metricName(Metric(metric)).compare(name, Qt::CaseInsensitive) == 0) {
+            if (ok) *ok = true;
+            return Metric(metric);
+        }
+    }
+    if (ok) *ok = false;
+    return Cpu;
+}
@@ -0,0 +1,79 @@
+#ifndef PROCESSCOLUMNS_H
+#define PROCESSCOLUMNS_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "processcategorizer.h"
+#include "stringinterner.h"
+
+struct ProcessInfo;
+
+// Column-wise copy of one process snapshot. Rules and aggregates scan a
+// single contiguous array per metric instead of striding over ProcessInfo,
+// which keeps the inner loops vectorizable.
+struct ProcessColumns {
+    enum Metric {
+        Cpu,            // Percent of total CPU
+        MemoryKb,       // Working set / RSS
+        PssKb,
+        SwapKb,
+        DiskMBps,
+        NetworkMBps,
+        CpuZScore,      // CPU relative to the process' own baseline
+        MetricCount
+    };
+
+    int rows = 0;
+    QVector<qint64> pid;
+    QVector<qint64> startTime;
+    QVector<QString> name;
+    QVector<ProcessType> type;
+    QVector<qint64> parentPid;
+    // Interned ids, equal exactly when the strings are; keys for grouping
+    QVector<StringInterner::Id> nameId;
+    QVector<StringInterner::Id> userId;
+    QVector<StringInterner::Id> containerId;
+    QVector<double> metrics[MetricCount];
+
+    // Row of the same process (pid and start time) in the previous snapshot,
+    // or -1 if the process is new. Per-process state kept by consumers is
+    // carried over with this instead of a hash lookup per row.
+    QVector<int> previousRow;
+
+    void assign(const QVector<ProcessInfo> &processes);
+    const double *column(Metric metric) const { return metrics[metric].constData(); }
+    // Row of the process in this snapshot, or -1
+    int rowOf(qint64 processId, qint64 processStartTime) const { return previousIndex.value(Identity{processId, processStartTime}, -1); }
+
+    static QString metricName(Metric metric);
+    static Metric metricFromName(const QString &name, bool *ok = nullptr);
+
+private:
+    struct Identity {
+        qint64 pid;
+        qint64 startTime;
+        bool operator==(const Identity &other) const { return pid == other.pid && startTime == other.startTime; }
+    };
+    friend size_t qHash(const Identity &key, size_t seed) { return qHashMulti(seed, key.pid, key.startTime); }
+
+    // Rows of this snapshot; the next assign() looks the previous rows up here
+    QHash<Identity, int> previousIndex;
+};
+
+// Carries per-row state from the previous snapshot; new processes start at fill
+template <typename T>
+void remapColumn(QVector<T> &state, const QVector<int> &previousRow, T fill)
+{
+    QVector<T> remapped(previousRow.size(), fill);
+    const int previousRows = state.size();
+    for (int row = 0; row < previousRow.size(); ++row) {
+        int from = previousRow[row];
+        if (from >= 0 && from < previousRows) {
+            remapped[row] = state[from];
+        }
+    }
+    state.swap(remapped);
+}
+
+#endif // PROCESSCOLUMNS_H
@@ -0,0 +1,243 @@
+#include "processgrouping.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+// Adding and subtracting deltas drifts in the last bits; totals are summed
+// afresh from the stored contributions this often
+const int RESUM_INTERVAL = 600;
+
+// Negative readings mean "not available" and NaN never compares, so
+// neither adds anything
+inline double contribution(double value)
+{
+    return value > 0.0 ? value : 0.0;
+}
+
+QString typeTitle(ProcessType type)
+{
+    switch (type) {
+    case ProcessType::Application: return "Apps";
+    case ProcessType::Background: return "Background processes";
+    case ProcessType::System: return "System processes";
+    case ProcessType::Unknown: break;
+    }
+    return "Other";
+}
+
+int typeRank(ProcessType type)
+{
+    switch (type) {
+    case ProcessType::Application: return 0;
+    case ProcessType::Background: return 1;
+    case ProcessType::System: return 2;
+    case ProcessType::Unknown: break;
+    }
+    return 3;
+}
+
+} // namespace
+
+ProcessGrouping::ProcessGrouping(const StringInterner &interner) :
+    strings(interner),
+    groupKey(ByType),
+    updatesSinceResum(0)
+{
+}
+
+QString ProcessGrouping::keyName(Key key)
+{
+    switch (key) {
+    case ByType: return "Type";
+    case ByUser: return "User";
+    case ByExecutable: return "Executable";
+    case ByParent: return "Parent";
+    case ByContainer: return "Container";
+    case KeyCount: break;
+    }
+    return QString();
+}
+
+qint64 ProcessGrouping::keyOf(const ProcessColumns &columns, int row) const
+{
+    switch (groupKey) {
+    case ByType: return qint64(columns.type[row]);
+    case ByUser: return columns.userId[row];
+    case ByExecutable: return columns.nameId[row];
+    case ByParent: return columns.parentPid[row];
+    case ByContainer: return columns.containerId[row];
+    case KeyCount: break;
+    }
+    return 0;
+}
+
+void ProcessGrouping::setKey(Key key, const ProcessColumns &columns)
+{
+    groupKey = key;
+    groups.clear();
+    freeSlots.clear();
+    slotOfKey.clear();
+    rowSlot.clear();
+    for (QVector<double> &values : contributions) {
+        values.clear();
+    }
+    // With no previous rows, every process joins its group afresh
+    update(columns);
+}
+
+void ProcessGrouping::update(const ProcessColumns &columns)
+{
+    const int previousRows = rowSlot.size();
+    QVector<quint8> continued(previousRows, 0);
+    QVector<int> nextSlot(columns.rows);
+    QVector<double> next[ProcessColumns::MetricCount];
+    for (QVector<double> &values : next) {
+        values.resize(columns.rows);
+    }
+    QHash<qint64, int> rowOfPid;    // For parent titles, built on first need
+
+    for (int row = 0; row < columns.rows; ++row) {
+        const qint64 key = keyOf(columns, row);
+        const int previous = columns.previousRow[row];
+        int slot;
+        if (previous >= 0 && previous < previousRows && groups[rowSlot[previous]].key == key) {
+            // Same group as before: add only the change
+            continued[previous] = 1;
+            slot = rowSlot[previous];
+            Group &group = groups[slot];
+            for (int metric = 0; metric < ProcessColumns::MetricCount; ++metric) {
+                const double value = contribution(columns.metrics[metric][row]);
+                group.totals[metric] += value - contributions[metric][previous];
+                next[metric][row] = value;
+            }
+        } else {
+            slot = acquire(columns, key, rowOfPid);
+            Group &group = groups[slot];
+            ++group.count;
+            for (int metric = 0; metric < ProcessColumns::MetricCount; ++metric) {
+                const double value = contribution(columns.metrics[metric][row]);
+                group.totals[metric] += value;
+                next[metric][row] = value;
+            }
+        }
+        nextSlot[row] = slot;
+    }
+
+    // Exited, or moved to another group above
+    for (int previous = 0; previous < previousRows; ++previous) {
+        if (continued[previous]) {
+            continue;
+        }
+        const int slot = rowSlot[previous];
+        Group &group = groups[slot];
+        for (int metric = 0; metric < ProcessColumns::MetricCount; ++metric) {
+            group.totals[metric] -= contributions[metric][previous];
+        }
+        if (--group.count == 0) {
+            release(slot);
+        }
+    }
+
+    rowSlot.swap(nextSlot);
+    for (int metric = 0; metric < ProcessColumns::MetricCount; ++metric) {
+        contributions[metric].swap(next[metric]);
+    }
+    if (++updatesSinceResum >= RESUM_INTERVAL) {
+        resum();
+    }
+}
+
+int ProcessGrouping::acquire(const ProcessColumns &columns, qint64 key, QHash<qint64, int> &rowOfPid)
+{
+    auto it = slotOfKey.constFind(key);
+    if (it != slotOfKey.constEnd()) {
+        return *it;
+    }
+    int slot;
+    if (!freeSlots.isEmpty()) {
+        slot = freeSlots.takeLast();
+    } else {
+        slot = groups.size();
+        groups.append(Group());
+    }
+    Group &group = groups[slot];
+    group.key = key;
+    group.title = titleOf(columns, key, rowOfPid);
+    group.count = 0;
+    std::fill(std::begin(group.totals), std::end(group.totals), 0.0);
+    slotOfKey.insert(key, slot);
+    return slot;
+}
+
+void ProcessGrouping::release(int slot)
+{
+    slotOfKey.remove(groups[slot].key);
+    groups[slot].title.clear();
+    groups[slot].count = 0;
+    freeSlots.append(slot);
+}
+
+QString ProcessGrouping::titleOf(const ProcessColumns &columns, qint64 key, QHash<qint64, int> &rowOfPid) const
+{
+    switch (groupKey) {
+    case ByType:
+        return typeTitle(ProcessType(key));
+    case ByParent: {
+        if (key <= 0) {
+            return QString("(no parent)");
+        }
+        if (rowOfPid.isEmpty()) {
+            rowOfPid.reserve(columns.rows);
+            for (int row = 0; row < columns.rows; ++row) {
+                rowOfPid.insert(columns.pid[row], row);
+            }
+        }
+        const int parent = rowOfPid.value(key, -1);
+        return parent >= 0 ? QString("%1 (PID %2)").arg(columns.name[parent]).arg(key) : QString("PID %1").arg(key);
+    }
+    case ByUser:
+    case ByExecutable:
+    case ByContainer:
+    case KeyCount:
+        break;
+    }
+    const QString &text = strings.string(StringInterner::Id(key));
+    return text.isEmpty() ? QString("(unknown)") : text;
+}
+
+void ProcessGrouping::resum()
+{
+    for (Group &group : groups) {
+        std::fill(std::begin(group.totals), std::end(group.totals), 0.0);
+    }
+    for (int metric = 0; metric < ProcessColumns::MetricCount; ++metric) {
+        const double *values = contributions[metric].constData();
+        for (int row = 0; row < rowSlot.size(); ++row) {
+            groups[rowSlot[row]].totals[metric] += values[row];
+        }
+    }
+    updatesSinceResum = 0;
+}
+
+QVector<int> ProcessGrouping::orderedSlots() const
+{
+    QVector<int> occupied;
+    occupied.reserve(groups.size() - freeSlots.size());
+    for (int slot = 0; slot < groups.size(); ++slot) {
+        if (groups[slot].count > 0) {
+            occupied.append(slot);
+        }
+    }
+    if (groupKey == ByType) {
+        std::sort(occupied.begin(), occupied.end(), [this](int a, int b) {
+            return typeRank(ProcessType(groups[a].key)) < typeRank(ProcessType(groups[b].key));
+        });
+    } else {
+        std::sort(occupied.begin(), occupied.end(), [this](int a, int b) {
+            int order = QString::compare(groups[a].title, groups[b].title, Qt::CaseInsensitive);
+            return order != 0 ? order < 0 : groups[a].key < groups[b].key;
+        });
+    }
+    return occupied;
+}
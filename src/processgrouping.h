@@ -0,0 +1,69 @@
+#ifndef PROCESSGROUPING_H
+#define PROCESSGROUPING_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+#include "processcolumns.h"
+#include "stringinterner.h"
+
+// Live processes bucketed by a key (type, user, executable, parent or
+// container) with per-group totals of every metric. Totals follow the
+// snapshots incrementally: a continuing process adds only the change in
+// its values, and only processes that start, exit or change group join or
+// leave one. A group keeps its slot while it has members.
+class ProcessGrouping {
+public:
+    enum Key {
+        ByType,
+        ByUser,
+        ByExecutable,
+        ByParent,
+        ByContainer,
+        KeyCount
+    };
+
+    struct Group {
+        qint64 key;         // ProcessType, interned string id or parent pid
+        QString title;
+        int count;          // Members; 0 for a free slot
+        double totals[ProcessColumns::MetricCount];     // Negative values count as 0
+    };
+
+    explicit ProcessGrouping(const StringInterner &strings);
+
+    // Must see every snapshot: deltas come from columns.previousRow
+    void update(const ProcessColumns &columns);
+    // Regroups columns, the current snapshot, by key
+    void setKey(Key key, const ProcessColumns &columns);
+    Key key() const { return groupKey; }
+
+    // Slots, free ones included
+    int slotCount() const { return groups.size(); }
+    const Group &group(int slot) const { return groups[slot]; }
+    // Slot of a row of the current snapshot, or -1
+    int slotOfRow(int row) const { return row >= 0 && row < rowSlot.size() ? rowSlot[row] : -1; }
+    // Occupied slots for display: types in a fixed order, other keys by title
+    QVector<int> orderedSlots() const;
+
+    static QString keyName(Key key);
+
+private:
+    qint64 keyOf(const ProcessColumns &columns, int row) const;
+    int acquire(const ProcessColumns &columns, qint64 key, QHash<qint64, int> &rowOfPid);
+    void release(int slot);
+    QString titleOf(const ProcessColumns &columns, qint64 key, QHash<qint64, int> &rowOfPid) const;
+    void resum();
+
+    const StringInterner &strings;
+    Key groupKey;
+    QVector<Group> groups;
+    QVector<int> freeSlots;
+    QHash<qint64, int> slotOfKey;
+    // Per row of the last snapshot: its slot and what it added to the totals
+    QVector<int> rowSlot;
+    QVector<double> contributions[ProcessColumns::MetricCount];
+    int updatesSinceResum;
+};
+
+#endif // PROCESSGROUPING_H
@@ -0,0 +1,173 @@
+#include "processhistory.h"
+#include "processcolumns.h"
+#include <cmath>
+
+namespace {
+
+// A day: the last hour at one sample per update, the rest per minute
+const int DEFAULT_RETENTION_SECONDS = 24 * 60 * 60;
+const qint64 FULL_RATE_MS = 60 * 60 * 1000;
+const qint64 MINUTE_MS = 60 * 1000;
+// Binary fractions leave the low mantissa bits zero, which XOR encoding
+// stores for free; 1/64 % is finer than any display of CPU usage.
+const double CPU_STEPS_PER_PERCENT = 64.0;
+
+inline double quantizeCpu(double cpu)
+{
+    return std::round(cpu * CPU_STEPS_PER_PERCENT) / CPU_STEPS_PER_PERCENT;
+}
+
+} // namespace
+
+void ProcessHistory::Slot::clear()
+{
+    recent.clear();
+    minutes.clear();
+    minuteStart = -1;
+    cpuSum = 0.0;
+    cpuCount = 0;
+    memoryPeak = 0.0;
+}
+
+void ProcessHistory::Slot::flushMinute()
+{
+    if (cpuCount == 0) {
+        return;
+    }
+    double values[2] = {quantizeCpu(cpuSum / cpuCount), memoryPeak};
+    minutes.append(minuteStart, values);
+    cpuSum = 0.0;
+    cpuCount = 0;
+    memoryPeak = 0.0;
+}
+
+ProcessHistory::ProcessHistory() :
+    retentionMs(qint64(DEFAULT_RETENTION_SECONDS) * 1000)
+{
+}
+
+void ProcessHistory::update(const ProcessColumns &columns, qint64 timestampMs)
+{
+    remapColumn(slotOfRow, columns.previousRow, -1);
+
+    // Release series of processes that are gone
+    QVector<quint8> stillUsed(slots.size(), 0);
+    for (int slot : slotOfRow) {
+        if (slot >= 0) {
+            stillUsed[slot] = 1;
+        }
+    }
+    for (int slot = 0; slot < slots.size(); ++slot) {
+        if (slotUsed[slot] && !stillUsed[slot]) {
+            slots[slot].clear();
+            freeSlots.append(slot);
+        }
+    }
+    slotUsed.swap(stillUsed);
+
+    const double *cpu = columns.column(ProcessColumns::Cpu);
+    const double *memory = columns.column(ProcessColumns::MemoryKb);
+    const qint64 recentCutoff = timestampMs - qMin(FULL_RATE_MS, retentionMs);
+    const qint64 cutoff = timestampMs - retentionMs;
+    for (int row = 0; row < columns.rows; ++row) {
+        int &slotIndex = slotOfRow[row];
+        if (slotIndex < 0) {
+            if (!freeSlots.isEmpty()) {
+                slotIndex = freeSlots.takeLast();
+            } else {
+                slotIndex = slots.size();
+                slots.append(Slot());
+                slotUsed.append(0);
+            }
+            slotUsed[slotIndex] = 1;
+        }
+        Slot &slot = slots[slotIndex];
+        double values[2] = {quantizeCpu(cpu[row]), memory[row]};
+        slot.recent.append(timestampMs, values);
+        if (slot.recent.firstTimestamp() < recentCutoff) {
+            slot.recent.dropBefore(recentCutoff);
+        }
+
+        if (slot.minuteStart >= 0 && timestampMs - slot.minuteStart >= MINUTE_MS) {
+            slot.flushMinute();
+            slot.minuteStart = -1;
+        }
+        if (slot.minuteStart < 0) {
+            slot.minuteStart = timestampMs;
+        }
+        slot.cpuSum += values[Cpu];
+        slot.cpuCount++;
+        slot.memoryPeak = qMax(slot.memoryPeak, values[MemoryKb]);
+        if (!slot.minutes.isEmpty() && slot.minutes.firstTimestamp() < cutoff) {
+            slot.minutes.dropBefore(cutoff);
+        }
+    }
+}
+
+const CompressedSeries *ProcessHistory::series(int row) const
+{
+    if (row < 0 || row >= slotOfRow.size() || slotOfRow[row] < 0) {
+        return nullptr;
+    }
+    return &slots[slotOfRow[row]].recent;
+}
+
+const CompressedSeries *ProcessHistory::minuteSeries(int row) const
+{
+    if (row < 0 || row >= slotOfRow.size() || slotOfRow[row] < 0) {
+        return nullptr;
+    }
+    return &slots[slotOfRow[row]].minutes;
+}
+
+bool ProcessHistory::summarize(int row, Summary &summary) const
+{
+    if (row < 0 || row >= slotOfRow.size() || slotOfRow[row] < 0) {
+        return false;
+    }
+    const Slot &slot = slots[slotOfRow[row]];
+    if (slot.recent.isEmpty()) {
+        return false;
+    }
+    summary = Summary();
+    qint64 timestamp = 0;
+    double values[2];
+    int count = 0;
+    CompressedSeries::Cursor recent = slot.recent.cursor();
+    while (recent.next(timestamp, values)) {
+        summary.hourCpuMean += values[Cpu];
+        summary.hourCpuPeak = qMax(summary.hourCpuPeak, values[Cpu]);
+        summary.memoryPeakKb = qMax(summary.memoryPeakKb, values[MemoryKb]);
+        count++;
+    }
+    summary.hourCpuMean /= qMax(1, count);
+    summary.sinceMs = slot.recent.firstTimestamp();
+
+    // Minutes weigh equally; the minute still being accumulated counts too
+    double cpuSum = 0.0;
+    int minutes = 0;
+    CompressedSeries::Cursor older = slot.minutes.cursor();
+    while (older.next(timestamp, values)) {
+        cpuSum += values[Cpu];
+        summary.memoryPeakKb = qMax(summary.memoryPeakKb, values[MemoryKb]);
+        minutes++;
+    }
+    if (slot.cpuCount > 0) {
+        cpuSum += slot.cpuSum / slot.cpuCount;
+        minutes++;
+    }
+    summary.cpuMean = cpuSum / qMax(1, minutes);
+    if (!slot.minutes.isEmpty()) {
+        summary.sinceMs = qMin(summary.sinceMs, slot.minutes.firstTimestamp());
+    }
+    return true;
+}
+
+qint64 ProcessHistory::memoryBytes() const
+{
+    qint64 bytes = 0;
+    for (const Slot &slot : slots) {
+        bytes += slot.recent.memoryBytes() + slot.minutes.memoryBytes();
+    }
+    return bytes;
+}
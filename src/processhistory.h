@@ -0,0 +1,68 @@
+#ifndef PROCESSHISTORY_H
+#define PROCESSHISTORY_H
+
+#include <QVector>
+#include "compressedseries.h"
+
+struct ProcessColumns;
+
+// Per-process CPU and memory history in compressed series. Series live in
+// a pool and follow their process across snapshots through previousRow;
+// when a process exits its series is cleared and reused for a new one.
+//
+// The last hour is kept at full rate; the rest of the retention period at
+// one sample per minute (mean CPU, peak memory). A day costs about 14 KB
+// for an idle process and about 55 KB for one whose CPU and memory change
+// every second, so 20k mostly idle processes take around 300 MB and 20k
+// busy ones about 1 GB. At full rate for the whole day it would be 5-6 GB.
+class ProcessHistory {
+public:
+    enum Value {
+        Cpu,        // Percent of total CPU, in steps of 1/64 %
+        MemoryKb
+    };
+
+    // Of one process, for tooltips and details
+    struct Summary {
+        double hourCpuMean = 0.0;
+        double hourCpuPeak = 0.0;
+        double cpuMean = 0.0;           // Over the whole retention period
+        double memoryPeakKb = 0.0;      // Over the whole retention period
+        qint64 sinceMs = 0;             // Oldest sample
+    };
+
+    ProcessHistory();
+
+    void setRetentionSeconds(int seconds) { retentionMs = qint64(qMax(60, seconds)) * 1000; }
+    void update(const ProcessColumns &columns, qint64 timestampMs);
+
+    // Full-rate series of the process in row of the latest snapshot, last
+    // hour only, or nullptr
+    const CompressedSeries *series(int row) const;
+    // One sample per minute over the whole retention period, or nullptr
+    const CompressedSeries *minuteSeries(int row) const;
+    bool summarize(int row, Summary &summary) const;
+    qint64 memoryBytes() const;
+
+private:
+    struct Slot {
+        CompressedSeries recent{2};
+        CompressedSeries minutes{2};
+        // Minute being accumulated
+        qint64 minuteStart = -1;
+        double cpuSum = 0.0;
+        int cpuCount = 0;
+        double memoryPeak = 0.0;
+
+        void clear();
+        void flushMinute();
+    };
+
+    QVector<int> slotOfRow;
+    QVector<Slot> slots;
+    QVector<quint8> slotUsed;
+    QVector<int> freeSlots;
+    qint64 retentionMs;
+};
+
+#endif // PROCESSHISTORY_H
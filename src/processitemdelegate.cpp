@@ -0,0 +1,168 @@
+#include "processitemdelegate.h"
+#include "processtablemodel.h"
+#include "processsparklines.h"
+#include <QPainter>
+
+namespace {
+
+const int TEXT_PADDING = 6;
+const int ROW_HEIGHT = 24;
+// Distinct cell texts are few (names, rounded numbers); this only bounds pathological cases
+const int MAX_CACHED_TEXTS = 8192;
+
+QColor mix(const QColor &a, const QColor &b, double t)
+{
+    return QColor::fromRgbF(a.redF() + (b.redF() - a.redF()) * t,
+                            a.greenF() + (b.greenF() - a.greenF()) * t,
+                            a.blueF() + (b.blueF() - a.blueF()) * t);
+}
+
+} // namespace
+
+ProcessItemDelegate::ProcessItemDelegate(const ProcessSparklines *sparklines, QObject *parent) : QStyledItemDelegate(parent),
+    sparklineSource(sparklines),
+    baseColor("#181818"),
+    alternateColor("#232323"),
+    headerColor("#232323"),
+    selectedColor("#0078d4"),
+    cpuTrendPen(QColor("#4CAF50"), 1.5),
+    memoryTrendPen(QColor("#2196F3"), 1.5),
+    selectedTrendPen(QColor(Qt::white), 1.5)
+{
+    // Same bands as the text colors (green, yellow, orange, red), blended
+    // into the row background so text on top stays readable
+    const QColor stops[] = {QColor("#4CAF50"), QColor("#FFD700"), QColor("#FFA500"), QColor("#FF4444")};
+    for (int step = 0; step < HEAT_STEPS; ++step) {
+        double position = double(step) / (HEAT_STEPS - 1) * 3.0;
+        int stop = qMin(int(position), 2);
+        QColor color = mix(stops[stop], stops[stop + 1], position - stop);
+        heatPalette[step] = mix(baseColor, color, 0.35);
+    }
+}
+
+QSize ProcessItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const QString text = index.data(Qt::DisplayRole).toString();
+    return QSize(option.fontMetrics.horizontalAdvance(text) + 2 * TEXT_PADDING, ROW_HEIGHT);
+}
+
+const QStaticText &ProcessItemDelegate::layoutText(const QString &text, const QFont &font, bool bold) const
+{
+    QHash<QString, QStaticText> &cache = bold ? boldTextCache : textCache;
+    auto it = cache.find(text);
+    if (it != cache.end()) {
+        return *it;
+    }
+    if (cache.size() >= MAX_CACHED_TEXTS) {
+        cache.clear();
+    }
+    QStaticText laidOut(text);
+    laidOut.setTextFormat(Qt::PlainText);
+    laidOut.setPerformanceHint(QStaticText::AggressiveCaching);
+    QFont textFont = font;
+    textFont.setBold(bold);
+    laidOut.prepare(QTransform(), textFont);
+    return *cache.insert(text, laidOut);
+}
+
+void ProcessItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const QRect rect = option.rect;
+    const bool selected = option.state & QStyle::State_Selected;
+    const bool header = index.data(ProcessTableModel::GroupHeaderRole).toBool();
+
+    if (selected) {
+        painter->fillRect(rect, selectedColor);
+    } else if (header) {
+        painter->fillRect(rect, headerColor);
+    } else {
+        painter->fillRect(rect, (index.row() & 1) ? alternateColor : baseColor);
+        const QVariant heat = index.data(ProcessTableModel::HeatRole);
+        if (heat.isValid()) {
+            double share = qBound(0.0, heat.toDouble(), 1.0);
+            int width = int(rect.width() * share + 0.5);
+            if (width > 0) {
+                painter->fillRect(QRect(rect.left(), rect.top() + 2, width, rect.height() - 4),
+                                  heatPalette[int(share * (HEAT_STEPS - 1))]);
+            }
+        }
+    }
+
+    const QVariant sparkline = index.data(ProcessTableModel::SparklineRole);
+    if (sparkline.isValid()) {
+        paintSparkline(painter, rect, sparkline.toInt(), index.column() == ProcessTableModel::MemoryTrendColumn, selected);
+        return;
+    }
+
+    const QString text = index.data(Qt::DisplayRole).toString();
+    if (text.isEmpty()) {
+        return;
+    }
+    const QVariant foreground = index.data(Qt::ForegroundRole);
+    painter->setPen(selected || !foreground.isValid() ? QColor(Qt::white) : foreground.value<QColor>());
+    // The painter font must match the one the text was laid out with
+    if (header) {
+        QFont bold = option.font;
+        bold.setBold(true);
+        painter->setFont(bold);
+    } else {
+        painter->setFont(option.font);
+    }
+
+    const QStaticText &laidOut = layoutText(text, option.font, header);
+    const QSizeF size = laidOut.size();
+    QPointF origin(rect.left() + TEXT_PADDING, rect.top() + (rect.height() - size.height()) / 2.0);
+    if (size.width() > rect.width() - 2 * TEXT_PADDING) {
+        // Clip rather than elide, which would need a fresh layout per width
+        painter->save();
+        painter->setClipRect(rect.adjusted(0, 0, -TEXT_PADDING, 0));
+        painter->drawStaticText(origin, laidOut);
+        painter->restore();
+    } else {
+        painter->drawStaticText(origin, laidOut);
+    }
+}
+
+void ProcessItemDelegate::paintSparkline(QPainter *painter, const QRect &rect, int slot, bool memory, bool selected) const
+{
+    if (!sparklineSource) {
+        return;
+    }
+    // Fixed-size buffers on the stack: painting allocates nothing
+    float values[ProcessSparklines::SAMPLES];
+    const int count = sparklineSource->samples(slot, memory ? ProcessSparklines::MemoryKb : ProcessSparklines::Cpu, values);
+    if (count < 2) {
+        return;
+    }
+
+    float low = values[0];
+    float high = values[0];
+    for (int index = 1; index < count; ++index) {
+        low = qMin(low, values[index]);
+        high = qMax(high, values[index]);
+    }
+    // CPU is drawn from zero so an idle process stays flat at the bottom;
+    // memory spans its own range, with a floor so noise does not fill the cell
+    if (!memory) {
+        low = 0.0f;
+        high = qMax(high, 1.0f);
+    } else if (high - low < high * 0.01f) {
+        low = high - qMax(high * 0.01f, 1.0f);
+    }
+
+    const QRectF area = QRectF(rect).adjusted(TEXT_PADDING, 4, -TEXT_PADDING, -4);
+    const qreal step = area.width() / (ProcessSparklines::SAMPLES - 1);
+    const qreal scale = area.height() / qreal(high - low);
+    // Newest sample at the right edge; a young process fills in from there
+    QPointF points[ProcessSparklines::SAMPLES];
+    qreal x = area.right() - step * (count - 1);
+    for (int index = 0; index < count; ++index) {
+        points[index] = QPointF(x, area.bottom() - (values[index] - low) * scale);
+        x += step;
+    }
+
+    painter->setPen(selected ? selectedTrendPen : memory ? memoryTrendPen : cpuTrendPen);
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->drawPolyline(points, count);
+    painter->setRenderHint(QPainter::Antialiasing, false);
+}
@@ -0,0 +1,48 @@
+#ifndef PROCESSITEMDELEGATE_H
+#define PROCESSITEMDELEGATE_H
+
+#include <QColor>
+#include <QHash>
+#include <QPen>
+#include <QStaticText>
+#include <QStyledItemDelegate>
+
+class ProcessSparklines;
+
+// Paints process table cells directly: row background, a heat bar sized by
+// the model's HeatRole, and the text. It bypasses the style (and so any
+// stylesheet) entirely; colors come from palettes built once, and laid-out
+// text is cached so scrolling repaints do no text layout for values seen
+// before. Trend columns are drawn as sparklines straight from the rings in
+// ProcessSparklines.
+class ProcessItemDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    explicit ProcessItemDelegate(const ProcessSparklines *sparklines, QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+private:
+    static const int HEAT_STEPS = 64;
+
+    const QStaticText &layoutText(const QString &text, const QFont &font, bool bold) const;
+    void paintSparkline(QPainter *painter, const QRect &rect, int slot, bool memory, bool selected) const;
+
+    const ProcessSparklines *sparklineSource;
+
+    QColor heatPalette[HEAT_STEPS];
+    QColor baseColor;
+    QColor alternateColor;
+    QColor headerColor;
+    QColor selectedColor;
+    // Built once; a pen made per paint would allocate
+    QPen cpuTrendPen;
+    QPen memoryTrendPen;
+    QPen selectedTrendPen;
+    mutable QHash<QString, QStaticText> textCache;
+    mutable QHash<QString, QStaticText> boldTextCache;
+};
+
+#endif // PROCESSITEMDELEGATE_H
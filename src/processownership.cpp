@@ -0,0 +1,185 @@
+#include "processownership.h"
+#include <QFile>
+#include <QStringList>
+#include <cstdlib>
+#include <cstring>
+#ifdef Q_OS_LINUX
+#include <pwd.h>
+#endif
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <sddl.h>
+#endif
+
+namespace {
+
+// As shown by docker ps
+const int SHORT_ID_LENGTH = 12;
+
+struct Runtime {
+    const char *prefix;     // Of the systemd scope the runtime creates
+    const char *name;
+};
+
+const Runtime SCOPE_RUNTIMES[] = {
+    {"docker-", "docker"},
+    {"cri-containerd-", "containerd"},
+    {"crio-", "cri-o"},
+    {"libpod-", "podman"}
+};
+
+bool isContainerId(const QString &text)
+{
+    if (text.size() < 32) {
+        return false;
+    }
+    for (QChar c : text) {
+        if (!c.isDigit() && (c < 'a' || c > 'f')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool ProcessOwnership::hasUsers()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_WIN)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ProcessOwnership::hasContainers()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+qint64 ProcessOwnership::userOf(qint64 pid)
+{
+    QFile file(QString("/proc/%1/status").arg(pid));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    // "Uid:" lists the real, effective, saved and filesystem uids
+    char line[256];
+    while (file.readLine(line, sizeof(line)) > 0) {
+        if (std::strncmp(line, "Uid:", 4) == 0) {
+            char *end = nullptr;
+            long long uid = std::strtoll(line + 4, &end, 10);
+            return end != line + 4 ? qint64(uid) : -1;
+        }
+    }
+    return -1;
+}
+
+QString ProcessOwnership::userName(qint64 uid)
+{
+    if (uid < 0) {
+        return QString();
+    }
+#ifdef Q_OS_LINUX
+    struct passwd entry;
+    struct passwd *found = nullptr;
+    char buffer[4096];
+    if (getpwuid_r(static_cast<uid_t>(uid), &entry, buffer, sizeof(buffer), &found) == 0 && found) {
+        return QString::fromLocal8Bit(found->pw_name);
+    }
+#endif
+    return QString::number(uid);
+}
+
+QByteArray ProcessOwnership::userSidOf(qint64 pid)
+{
+    QByteArray sid;
+#ifdef Q_OS_WIN
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (!process) {
+        return sid;
+    }
+    HANDLE token = nullptr;
+    if (OpenProcessToken(process, TOKEN_QUERY, &token)) {
+        // TOKEN_USER points into the same buffer, at the SID that follows it
+        union {
+            TOKEN_USER user;
+            BYTE bytes[sizeof(TOKEN_USER) + SECURITY_MAX_SID_SIZE];
+        } info;
+        DWORD size = 0;
+        if (GetTokenInformation(token, TokenUser, &info, sizeof(info), &size) && IsValidSid(info.user.User.Sid)) {
+            sid = QByteArray(static_cast<const char *>(info.user.User.Sid), int(GetLengthSid(info.user.User.Sid)));
+        }
+        CloseHandle(token);
+    }
+    CloseHandle(process);
+#else
+    Q_UNUSED(pid);
+#endif
+    return sid;
+}
+
+QString ProcessOwnership::userNameOfSid(const QByteArray &sid)
+{
+    if (sid.isEmpty()) {
+        return QString();
+    }
+#ifdef Q_OS_WIN
+    PSID account = const_cast<char *>(sid.constData());
+    // The bare account name, as Task Manager shows it ("SYSTEM", not
+    // "NT AUTHORITY\SYSTEM")
+    wchar_t name[256];
+    wchar_t domain[256];
+    DWORD nameLength = 256;
+    DWORD domainLength = 256;
+    SID_NAME_USE use;
+    if (LookupAccountSidW(nullptr, account, name, &nameLength, domain, &domainLength, &use)) {
+        return QString::fromWCharArray(name, int(nameLength));
+    }
+    LPWSTR text = nullptr;
+    if (ConvertSidToStringSidW(account, &text)) {
+        const QString string = QString::fromWCharArray(text);
+        LocalFree(text);
+        return string;
+    }
+#endif
+    return QString();
+}
+
+QString ProcessOwnership::containerOf(const QString &cgroupPath)
+{
+    if (cgroupPath.isEmpty()) {
+        return QString();
+    }
+    const QStringList parts = cgroupPath.split('/', Qt::SkipEmptyParts);
+    if (parts.isEmpty()) {
+        return QString("/");
+    }
+    // Innermost first, so a container inside a pod or a service names itself
+    for (int index = parts.size() - 1; index >= 0; --index) {
+        QString part = parts[index];
+        if (part.endsWith(".scope")) {
+            part.chop(6);
+        }
+        for (const Runtime &runtime : SCOPE_RUNTIMES) {
+            const int length = int(std::strlen(runtime.prefix));
+            if (part.startsWith(runtime.prefix) && isContainerId(part.mid(length))) {
+                return QString("%1 %2").arg(runtime.name, part.mid(length, SHORT_ID_LENGTH));
+            }
+        }
+        // The cgroupfs driver names the group after the bare id: /docker/<id>
+        if (isContainerId(part)) {
+            const QString runtime = index > 0 && parts[index - 1] == "docker" ? "docker" : "container";
+            return QString("%1 %2").arg(runtime, part.left(SHORT_ID_LENGTH));
+        }
+        if (part.startsWith("lxc.payload.")) {
+            return "lxc " + part.mid(12);
+        }
+    }
+    const QString &unit = parts.last();
+    return unit.endsWith(".service") || unit.endsWith(".scope") ? unit : cgroupPath;
+}
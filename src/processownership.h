@@ -0,0 +1,30 @@
+#ifndef PROCESSOWNERSHIP_H
+#define PROCESSOWNERSHIP_H
+
+#include <QString>
+
+// Who a process runs as and what it runs in: the real user from
+// /proc/[pid]/status on Linux and from the process token on Windows, and
+// the container (or, outside containers, the systemd unit) from its cgroup
+// v2 path, Linux only.
+class ProcessOwnership {
+public:
+    static bool hasUsers();
+    static bool hasContainers();
+
+    // Linux: real uid, or -1
+    static qint64 userOf(qint64 pid);
+    // Account name of uid, or the number when it has none
+    static QString userName(qint64 uid);
+    // Windows: SID of the token user, empty when the process cannot be
+    // opened (protected and some system processes without elevation)
+    static QByteArray userSidOf(qint64 pid);
+    // Account name of sid, or its S-1-... form when it has none
+    static QString userNameOfSid(const QByteArray &sid);
+    // Runtime and short id for container cgroups ("docker 3f2a9c1e0b7d"),
+    // the unit for systemd cgroups ("nginx.service"), otherwise the path;
+    // empty when the path is (the cgroup could not be read)
+    static QString containerOf(const QString &cgroupPath);
+};
+
+#endif // PROCESSOWNERSHIP_H
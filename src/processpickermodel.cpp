@@ -0,0 +1,264 @@
+#include "processpickermodel.h"
+#include "processcolumns.h"
+#include <algorithm>
+
+namespace {
+
+// Above this many starts and exits in one snapshot, one reset is cheaper
+// than row-by-row notifications
+const int MAX_INCREMENTAL_CHANGES = 256;
+
+bool pidHasPrefix(qint64 pid, qint64 prefix)
+{
+    while (pid > prefix) {
+        pid /= 10;
+    }
+    return pid == prefix;
+}
+
+} // namespace
+
+ProcessPickerModel::ProcessPickerModel(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+bool ProcessPickerModel::entryLess(const Entry &a, const Entry &b)
+{
+    int order = QString::compare(a.name, b.name, Qt::CaseInsensitive);
+    if (order != 0) {
+        return order < 0;
+    }
+    return a.pid != b.pid ? a.pid < b.pid : a.startTime < b.startTime;
+}
+
+void ProcessPickerModel::update(const ProcessColumns &columns)
+{
+    // Rows of the previous snapshot that continue; the rest exited (or
+    // were renamed by exec, which moves them in the sort order)
+    QVector<quint8> continued(lastPid.size(), 0);
+    QVector<int> started;
+    for (int row = 0; row < columns.rows; ++row) {
+        int previous = columns.previousRow[row];
+        if (previous >= 0 && previous < lastPid.size() && lastName[previous] == columns.name[row]) {
+            continued[previous] = 1;
+        } else {
+            started.append(row);
+        }
+    }
+    int exited = int(std::count(continued.cbegin(), continued.cend(), quint8(0)));
+
+    // Every change to entries below marks the matcher stale, since match()
+    // may run in between, from a slot connected to the row signals
+    if (lastPid.isEmpty() || exited + started.size() > MAX_INCREMENTAL_CHANGES) {
+        rebuild(columns);
+    } else {
+        for (int previous = 0; previous < continued.size(); ++previous) {
+            if (continued[previous]) {
+                continue;
+            }
+            const Entry key{lastPid[previous], lastStartTime[previous], lastName[previous]};
+            auto it = std::lower_bound(entries.begin(), entries.end(), key, entryLess);
+            if (it != entries.end() && it->pid == key.pid && it->startTime == key.startTime) {
+                int row = int(it - entries.begin());
+                beginRemoveRows(QModelIndex(), row, row);
+                entries.remove(row);
+                matcherStale = true;
+                endRemoveRows();
+            }
+        }
+        for (int row : started) {
+            Entry entry{columns.pid[row], columns.startTime[row], columns.name[row]};
+            int position = int(std::lower_bound(entries.begin(), entries.end(), entry, entryLess) - entries.begin());
+            beginInsertRows(QModelIndex(), position, position);
+            entries.insert(position, entry);
+            matcherStale = true;
+            endInsertRows();
+        }
+    }
+
+    lastPid = columns.pid;
+    lastStartTime = columns.startTime;
+    lastName = columns.name;
+    if (exited > 0 || !started.isEmpty()) {
+        emit entriesChanged();
+    }
+}
+
+void ProcessPickerModel::rebuild(const ProcessColumns &columns)
+{
+    beginResetModel();
+    entries.clear();
+    entries.reserve(columns.rows);
+    for (int row = 0; row < columns.rows; ++row) {
+        entries.append(Entry{columns.pid[row], columns.startTime[row], columns.name[row]});
+    }
+    std::sort(entries.begin(), entries.end(), entryLess);
+    matcherStale = true;
+    endResetModel();
+}
+
+int ProcessPickerModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : entries.size();
+}
+
+QVariant ProcessPickerModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= entries.size()) {
+        return QVariant();
+    }
+    const Entry &entry = entries[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return QString("%1 (PID %2)").arg(entry.name).arg(entry.pid);
+    case PidRole:
+        return entry.pid;
+    case StartTimeRole:
+        return entry.startTime;
+    case NameRole:
+        return entry.name;
+    default:
+        return QVariant();
+    }
+}
+
+int ProcessPickerModel::rowOf(qint64 pid, qint64 startTime) const
+{
+    for (int row = 0; row < entries.size(); ++row) {
+        if (entries[row].pid == pid && entries[row].startTime == startTime) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+int ProcessPickerModel::rowOf(qint64 pid, qint64 startTime, const QString &name) const
+{
+    const Entry key{pid, startTime, name};
+    auto it = std::lower_bound(entries.cbegin(), entries.cend(), key, entryLess);
+    if (it == entries.cend() || it->pid != pid || it->startTime != startTime) {
+        return -1;
+    }
+    return int(it - entries.cbegin());
+}
+
+qint64 ProcessPickerModel::pidAt(int row) const
+{
+    return row >= 0 && row < entries.size() ? entries[row].pid : -1;
+}
+
+qint64 ProcessPickerModel::startTimeAt(int row) const
+{
+    return row >= 0 && row < entries.size() ? entries[row].startTime : 0;
+}
+
+const QString &ProcessPickerModel::nameAt(int row) const
+{
+    static const QString none;
+    return row >= 0 && row < entries.size() ? entries[row].name : none;
+}
+
+QVector<int> ProcessPickerModel::match(const QString &pattern, int limit) const
+{
+    QVector<int> result;
+    if (pattern.isEmpty() || limit <= 0) {
+        return result;
+    }
+    QVector<quint8> taken(entries.size(), 0);
+    auto take = [&](int row) {
+        taken[row] = 1;
+        result.append(row);
+        return result.size() < limit;
+    };
+
+    // Entries are sorted case-insensitively, so name prefixes are one run
+    auto first = std::lower_bound(entries.cbegin(), entries.cend(), pattern, [](const Entry &entry, const QString &key) {
+        return QString::compare(entry.name, key, Qt::CaseInsensitive) < 0;
+    });
+    for (auto it = first; it != entries.cend() && it->name.startsWith(pattern, Qt::CaseInsensitive); ++it) {
+        if (!take(int(it - entries.cbegin()))) {
+            return result;
+        }
+    }
+
+    bool numeric = false;
+    qint64 pidPrefix = pattern.toLongLong(&numeric);
+    if (numeric && pidPrefix >= 0 && !(pattern.size() > 1 && pattern[0] == '0')) {
+        for (int row = 0; row < entries.size(); ++row) {
+            if (!taken[row] && pidHasPrefix(entries[row].pid, pidPrefix) && !take(row)) {
+                return result;
+            }
+        }
+    }
+
+    // Matcher indexes are entry rows; a matcher of another size is stale
+    // whatever the flag says
+    if (matcherStale || matcher.size() != entries.size()) {
+        matcher.clear();
+        matcher.reserve(entries.size(), entries.size() * 16);
+        for (const Entry &entry : entries) {
+            matcher.add(entry.name);
+        }
+        matcherStale = false;
+    }
+    for (const FuzzyMatcher::Match &match : matcher.rank(pattern, limit)) {
+        if (!taken[match.index] && !take(match.index)) {
+            return result;
+        }
+    }
+    return result;
+}
+
+ProcessMatchModel::ProcessMatchModel(ProcessPickerModel *sourceModel, QObject *parent) : QAbstractListModel(parent),
+    source(sourceModel)
+{
+}
+
+void ProcessMatchModel::setPattern(const QString &text)
+{
+    pattern = text;
+    refresh();
+}
+
+void ProcessMatchModel::refresh()
+{
+    // The popup shows a screenful; more would only cost matching time
+    static const int MAX_MATCHES = 200;
+    beginResetModel();
+    matches.clear();
+    for (int row : source->match(pattern, MAX_MATCHES)) {
+        matches.append(Match{source->pidAt(row), source->startTimeAt(row), source->nameAt(row), row});
+    }
+    endResetModel();
+}
+
+void ProcessMatchModel::relocate()
+{
+    if (matches.isEmpty()) {
+        return;
+    }
+    for (Match &match : matches) {
+        match.sourceRow = source->rowOf(match.pid, match.startTime, match.name);
+    }
+    emit dataChanged(index(0), index(matches.size() - 1));
+}
+
+int ProcessMatchModel::sourceRow(int row) const
+{
+    return row >= 0 && row < matches.size() ? matches[row].sourceRow : -1;
+}
+
+int ProcessMatchModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : matches.size();
+}
+
+QVariant ProcessMatchModel::data(const QModelIndex &index, int role) const
+{
+    const int row = sourceRow(index.isValid() ? index.row() : -1);
+    if (row < 0) {
+        return QVariant();
+    }
+    return source->data(source->index(row), role);
+}
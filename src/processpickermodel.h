@@ -0,0 +1,107 @@
+#ifndef PROCESSPICKERMODEL_H
+#define PROCESSPICKERMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QVector>
+#include "fuzzymatcher.h"
+
+struct ProcessColumns;
+
+// Every live process, sorted by name, for pickers. Entries are identified
+// by pid and start time, so instances of the same executable stay apart
+// and a reused pid is a different entry. The list follows snapshots
+// incrementally: only processes that started or exited are inserted or
+// removed, which keeps selection and scroll position in attached views.
+class ProcessPickerModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Role {
+        PidRole = Qt::UserRole,
+        StartTimeRole,
+        NameRole
+    };
+
+    explicit ProcessPickerModel(QObject *parent = nullptr);
+
+    // Must see every snapshot: deltas come from columns.previousRow
+    void update(const ProcessColumns &columns);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    int rowOf(qint64 pid, qint64 startTime) const;
+    // The same by binary search, for callers that also know the name
+    int rowOf(qint64 pid, qint64 startTime, const QString &name) const;
+    qint64 pidAt(int row) const;
+    qint64 startTimeAt(int row) const;
+    const QString &nameAt(int row) const;
+
+    // Rows for type-ahead, best first: names starting with pattern (found by
+    // binary search), then pids starting with it, then fuzzy matches ranked
+    // by FuzzyMatcher. Stops after limit rows.
+    QVector<int> match(const QString &pattern, int limit) const;
+
+signals:
+    // Once at the end of an update() that inserted or removed anything,
+    // however many rows it touched
+    void entriesChanged();
+
+private:
+    struct Entry {
+        qint64 pid;
+        qint64 startTime;
+        QString name;
+    };
+
+    static bool entryLess(const Entry &a, const Entry &b);
+    void rebuild(const ProcessColumns &columns);
+
+    QVector<Entry> entries;
+    // Names of entries, packed for fuzzy matching; every change to entries
+    // marks it stale and the next match rebuilds it
+    mutable FuzzyMatcher matcher;
+    mutable bool matcherStale = true;
+    // Previous snapshot, to name the processes that exited
+    QVector<qint64> lastPid;
+    QVector<qint64> lastStartTime;
+    QVector<QString> lastName;
+};
+
+// Results of ProcessPickerModel::match() for a QCompleter in unfiltered
+// popup mode: the completer shows these rows as they are. Rows hold the
+// process they matched, so they stay right as source rows shift.
+class ProcessMatchModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    explicit ProcessMatchModel(ProcessPickerModel *source, QObject *parent = nullptr);
+
+    void setPattern(const QString &pattern);
+    // Matches again; resets the model
+    void refresh();
+    // Looks the same processes up again after the source changed, without
+    // re-matching, so an open popup keeps its current row and scroll
+    // position. Processes that exited are left blank.
+    void relocate();
+    // Row in the source model, or -1
+    int sourceRow(int row) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    struct Match {
+        qint64 pid;
+        qint64 startTime;
+        QString name;
+        int sourceRow;
+    };
+
+    ProcessPickerModel *source;
+    QString pattern;
+    QVector<Match> matches;
+};
+
+#endif // PROCESSPICKERMODEL_H
@@ -0,0 +1,241 @@
+#include "processscheduling.h"
+#include <QDir>
+#include <QStringList>
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// From linux/ioprio.h, which glibc does not wrap
+const int IOPRIO_CLASS_SHIFT = 13;
+const int IOPRIO_WHO_PROCESS = 1;
+
+// Only the non-realtime policies can be set
+bool isSettablePolicy(SchedPolicy policy)
+{
+    return policy == SchedPolicy::Other || policy == SchedPolicy::Batch || policy == SchedPolicy::Idle;
+}
+
+#ifdef Q_OS_LINUX
+QStringList threadsOf(qint64 pid)
+{
+    return QDir(QString("/proc/%1/task").arg(pid)).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+}
+
+template <typename Apply>
+bool forEachThread(qint64 pid, Apply apply)
+{
+    const QStringList tasks = threadsOf(pid);
+    if (tasks.isEmpty()) {
+        return apply(pid);
+    }
+    bool success = true;
+    for (const QString &task : tasks) {
+        // Threads that exit in between are not failures
+        if (!apply(task.toLongLong()) && errno != ESRCH) {
+            success = false;
+        }
+    }
+    return success;
+}
+
+bool setThreadNice(qint64 tid, int nice)
+{
+    return ::setpriority(PRIO_PROCESS, static_cast<id_t>(tid), qBound(-20, nice, 19)) == 0;
+}
+
+bool setThreadPolicy(qint64 tid, SchedPolicy policy)
+{
+    int native = SCHED_OTHER;
+    switch (policy) {
+    case SchedPolicy::Other: native = SCHED_OTHER; break;
+    case SchedPolicy::Batch: native = SCHED_BATCH; break;
+    case SchedPolicy::Idle: native = SCHED_IDLE; break;
+    default: return false;
+    }
+    sched_param param{};
+    param.sched_priority = 0;
+    return sched_setscheduler(static_cast<pid_t>(tid), native, &param) == 0;
+}
+
+bool setThreadIoPriority(qint64 tid, IoClass ioClass, int level)
+{
+    int value = (static_cast<int>(ioClass) << IOPRIO_CLASS_SHIFT) | qBound(0, level, 7);
+    if (ioClass == IoClass::None || ioClass == IoClass::Idle) {
+        value = static_cast<int>(ioClass) << IOPRIO_CLASS_SHIFT;
+    }
+    return syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, static_cast<int>(tid), value) == 0;
+}
+#endif
+
+} // namespace
+
+bool ProcessScheduling::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+SchedulingInfo ProcessScheduling::get(qint64 pid)
+{
+    SchedulingInfo info;
+#ifdef Q_OS_LINUX
+    errno = 0;
+    int nice = ::getpriority(PRIO_PROCESS, static_cast<id_t>(pid));
+    if (errno != 0) {
+        return info;
+    }
+    info.nice = nice;
+
+    switch (sched_getscheduler(static_cast<pid_t>(pid)) & ~SCHED_RESET_ON_FORK) {
+    case SCHED_OTHER: info.policy = SchedPolicy::Other; break;
+    case SCHED_BATCH: info.policy = SchedPolicy::Batch; break;
+    case SCHED_IDLE: info.policy = SchedPolicy::Idle; break;
+    case SCHED_FIFO: info.policy = SchedPolicy::Fifo; break;
+    case SCHED_RR: info.policy = SchedPolicy::RoundRobin; break;
+#ifdef SCHED_DEADLINE
+    case SCHED_DEADLINE: info.policy = SchedPolicy::Deadline; break;
+#endif
+    default: info.policy = SchedPolicy::Unknown; break;
+    }
+
+    long ioprio = syscall(SYS_ioprio_get, IOPRIO_WHO_PROCESS, static_cast<int>(pid));
+    if (ioprio >= 0) {
+        info.ioClass = static_cast<IoClass>(qBound(0, int(ioprio >> IOPRIO_CLASS_SHIFT), 3));
+        info.ioLevel = int(ioprio & ((1 << IOPRIO_CLASS_SHIFT) - 1));
+    }
+    info.valid = true;
+#else
+    Q_UNUSED(pid);
+#endif
+    return info;
+}
+
+bool ProcessScheduling::setNice(qint64 pid, int nice)
+{
+#ifdef Q_OS_LINUX
+    return forEachThread(pid, [nice](qint64 tid) {
+        return setThreadNice(tid, nice);
+    });
+#else
+    Q_UNUSED(pid);
+    Q_UNUSED(nice);
+    return false;
+#endif
+}
+
+bool ProcessScheduling::setPolicy(qint64 pid, SchedPolicy policy)
+{
+#ifdef Q_OS_LINUX
+    if (!isSettablePolicy(policy)) {
+        return false;
+    }
+    return forEachThread(pid, [policy](qint64 tid) {
+        return setThreadPolicy(tid, policy);
+    });
+#else
+    Q_UNUSED(pid);
+    Q_UNUSED(policy);
+    return false;
+#endif
+}
+
+bool ProcessScheduling::setIoPriority(qint64 pid, IoClass ioClass, int level)
+{
+#ifdef Q_OS_LINUX
+    return forEachThread(pid, [ioClass, level](qint64 tid) {
+        return setThreadIoPriority(tid, ioClass, level);
+    });
+#else
+    Q_UNUSED(pid);
+    Q_UNUSED(ioClass);
+    Q_UNUSED(level);
+    return false;
+#endif
+}
+
+bool ProcessScheduling::apply(qint64 pid, const SchedulingInfo &info)
+{
+    bool success = true;
+    if (isSettablePolicy(info.policy)) {
+        success &= setPolicy(pid, info.policy);
+    }
+    success &= setNice(pid, info.nice);
+    success &= setIoPriority(pid, info.ioClass, info.ioLevel);
+    return success;
+}
+
+QHash<qint64, SchedulingInfo> ProcessScheduling::getThreads(qint64 pid)
+{
+    QHash<qint64, SchedulingInfo> threads;
+#ifdef Q_OS_LINUX
+    const QStringList tasks = threadsOf(pid);
+    threads.reserve(tasks.size());
+    for (const QString &task : tasks) {
+        const qint64 tid = task.toLongLong();
+        SchedulingInfo info = get(tid);
+        if (info.valid) {
+            threads.insert(tid, info);
+        }
+    }
+#else
+    Q_UNUSED(pid);
+#endif
+    return threads;
+}
+
+bool ProcessScheduling::applyThreads(qint64 pid, const QHash<qint64, SchedulingInfo> &threads, const SchedulingInfo &fallback)
+{
+#ifdef Q_OS_LINUX
+    // Only tids still in this process: a saved thread that exited may
+    // have had its tid reused elsewhere
+    return forEachThread(pid, [&threads, &fallback](qint64 tid) {
+        const SchedulingInfo info = threads.value(tid, fallback);
+        bool success = true;
+        if (isSettablePolicy(info.policy)) {
+            success &= setThreadPolicy(tid, info.policy);
+        }
+        success &= setThreadNice(tid, info.nice);
+        success &= setThreadIoPriority(tid, info.ioClass, info.ioLevel);
+        return success;
+    });
+#else
+    Q_UNUSED(pid);
+    Q_UNUSED(threads);
+    Q_UNUSED(fallback);
+    return false;
+#endif
+}
+
+QString ProcessScheduling::policyName(SchedPolicy policy)
+{
+    switch (policy) {
+    case SchedPolicy::Other: return "Normal";
+    case SchedPolicy::Batch: return "Batch";
+    case SchedPolicy::Idle: return "Idle";
+    case SchedPolicy::Fifo: return "FIFO (realtime)";
+    case SchedPolicy::RoundRobin: return "Round robin (realtime)";
+    case SchedPolicy::Deadline: return "Deadline";
+    case SchedPolicy::Unknown: break;
+    }
+    return "Unknown";
+}
+
+QString ProcessScheduling::ioPriorityText(IoClass ioClass, int level)
+{
+    switch (ioClass) {
+    case IoClass::None: return "Default";
+    case IoClass::RealTime: return QString("Realtime %1").arg(level);
+    case IoClass::BestEffort: return QString("Best effort %1").arg(level);
+    case IoClass::Idle: return "Idle";
+    }
+    return QString();
+}
@@ -0,0 +1,55 @@
+#ifndef PROCESSSCHEDULING_H
+#define PROCESSSCHEDULING_H
+
+#include <QHash>
+#include <QString>
+
+enum class SchedPolicy {
+    Other,      // SCHED_OTHER, the default time-sharing policy
+    Batch,      // SCHED_BATCH, CPU-bound work that does not need low latency
+    Idle,       // SCHED_IDLE, runs only when nothing else wants the CPU
+    Fifo,
+    RoundRobin,
+    Deadline,
+    Unknown
+};
+
+enum class IoClass {
+    None,       // No explicit class, derived from nice
+    RealTime,
+    BestEffort,
+    Idle
+};
+
+struct SchedulingInfo {
+    bool valid = false;
+    int nice = 0;
+    SchedPolicy policy = SchedPolicy::Other;
+    IoClass ioClass = IoClass::None;
+    int ioLevel = 4;    // 0 (highest) to 7 (lowest)
+};
+
+// Linux nice, scheduling policy and I/O priority. All three are per-thread
+// attributes, so setters apply them to every thread in /proc/[pid]/task.
+class ProcessScheduling {
+public:
+    static bool isSupported();
+
+    // Of the main thread; a tid reads one thread
+    static SchedulingInfo get(qint64 pid);
+    // Every thread's values by tid, to restore each thread exactly
+    static QHash<qint64, SchedulingInfo> getThreads(qint64 pid);
+    static bool setNice(qint64 pid, int nice);
+    // Only the non-realtime policies (Other, Batch, Idle) can be set
+    static bool setPolicy(qint64 pid, SchedPolicy policy);
+    static bool setIoPriority(qint64 pid, IoClass ioClass, int level);
+    static bool apply(qint64 pid, const SchedulingInfo &info);
+    // Gives each thread its own saved values back; threads started since
+    // they were saved get fallback
+    static bool applyThreads(qint64 pid, const QHash<qint64, SchedulingInfo> &threads, const SchedulingInfo &fallback);
+
+    static QString policyName(SchedPolicy policy);
+    static QString ioPriorityText(IoClass ioClass, int level);
+};
+
+#endif // PROCESSSCHEDULING_H
@@ -0,0 +1,79 @@
+#include "processsparklines.h"
+#include "processcolumns.h"
+
+void ProcessSparklines::update(const ProcessColumns &columns)
+{
+    remapColumn(slotOfRow, columns.previousRow, -1);
+
+    // Release rings of processes that are gone
+    QVector<quint8> stillUsed(rings.size(), 0);
+    for (int slot : slotOfRow) {
+        if (slot >= 0) {
+            stillUsed[slot] = 1;
+        }
+    }
+    for (int slot = 0; slot < rings.size(); ++slot) {
+        if (slotUsed[slot] && !stillUsed[slot]) {
+            freeSlots.append(slot);
+        }
+    }
+    slotUsed.swap(stillUsed);
+
+    const double *cpu = columns.column(ProcessColumns::Cpu);
+    const double *memory = columns.column(ProcessColumns::MemoryKb);
+    const int previous = (head + SAMPLES - 1) % SAMPLES;
+    for (int row = 0; row < columns.rows; ++row) {
+        int &slot = slotOfRow[row];
+        if (slot < 0) {
+            if (!freeSlots.isEmpty()) {
+                slot = freeSlots.takeLast();
+            } else {
+                slot = rings.size();
+                rings.append(Ring());
+                values.resize(values.size() + SeriesCount * SAMPLES);
+                slotUsed.append(0);
+            }
+            slotUsed[slot] = 1;
+            rings[slot] = Ring();
+        }
+
+        Ring &ring = rings[slot];
+        float *cpuRing = values.data() + slot * SeriesCount * SAMPLES;
+        float *memoryRing = cpuRing + SAMPLES;
+        const float cpuValue = float(cpu[row]);
+        const float memoryValue = float(memory[row]);
+        const bool same = ring.count > 0 && cpuRing[previous] == cpuValue && memoryRing[previous] == memoryValue;
+        cpuRing[head] = cpuValue;
+        memoryRing[head] = memoryValue;
+        ring.count = qMin(ring.count + 1, SAMPLES);
+        ring.steady = same ? qMin(ring.steady + 1, SAMPLES + 1) : 1;
+        // A full ring of equal samples looks the same after one more
+        ring.changed = ring.count < SAMPLES || ring.steady <= SAMPLES;
+    }
+    head = (head + 1) % SAMPLES;
+}
+
+int ProcessSparklines::slotOf(int row) const
+{
+    return row >= 0 && row < slotOfRow.size() ? slotOfRow[row] : -1;
+}
+
+int ProcessSparklines::samples(int slot, Series series, float *out) const
+{
+    if (slot < 0 || slot >= rings.size()) {
+        return 0;
+    }
+    const int count = rings[slot].count;
+    const float *ring = values.constData() + (slot * SeriesCount + series) * SAMPLES;
+    int position = (head + SAMPLES - count) % SAMPLES;
+    for (int index = 0; index < count; ++index) {
+        out[index] = ring[position];
+        position = position + 1 == SAMPLES ? 0 : position + 1;
+    }
+    return count;
+}
+
+bool ProcessSparklines::changed(int slot) const
+{
+    return slot >= 0 && slot < rings.size() && rings[slot].changed;
+}
@@ -0,0 +1,47 @@
+#ifndef PROCESSSPARKLINES_H
+#define PROCESSSPARKLINES_H
+
+#include <QVector>
+
+struct ProcessColumns;
+
+// Last minute of CPU and memory samples per process, in fixed rings for the
+// table's trend columns. Rings live in a pool and follow their process
+// through previousRow like ProcessHistory; all rings advance together, so
+// one write position serves every process.
+class ProcessSparklines {
+public:
+    enum Series {
+        Cpu,
+        MemoryKb,
+        SeriesCount
+    };
+
+    static const int SAMPLES = 60;
+
+    void update(const ProcessColumns &columns);
+
+    // Ring of the process in row of the latest snapshot, or -1
+    int slotOf(int row) const;
+    // Copies the samples of slot, oldest first, into out (SAMPLES long) and
+    // returns how many there are. Never allocates, so it is safe per paint.
+    int samples(int slot, Series series, float *out) const;
+    // Whether the last update changed what the slot's line looks like
+    bool changed(int slot) const;
+
+private:
+    struct Ring {
+        int count = 0;          // Samples recorded, up to SAMPLES
+        int steady = 0;         // Trailing samples equal to the latest, per both series
+        bool changed = false;
+    };
+
+    QVector<int> slotOfRow;
+    QVector<Ring> rings;
+    QVector<float> values;      // SAMPLES per series per slot
+    QVector<quint8> slotUsed;
+    QVector<int> freeSlots;
+    int head = 0;               // Position written by the next update
+};
+
+#endif // PROCESSSPARKLINES_H
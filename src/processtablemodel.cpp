@@ -0,0 +1,425 @@
+#include "processtablemodel.h"
+#include "processsparklines.h"
+#include "processhistory.h"
+#include "numberformat.h"
+#include <QColor>
+#include <QDateTime>
+#include <QFont>
+#include <QPair>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace {
+
+// Full scale of the usage bars; the color bands top out at the same values
+const double DISK_FULL_SCALE_MBPS = 10.0;
+const double NETWORK_FULL_SCALE_MBPS = 5.0;
+const double ANOMALY_FULL_SCALE = 8.0;
+
+QColor bandColor(double value, double red, double orange, double yellow, const QColor &low)
+{
+    if (value >= red) return QColor("#FF4444");
+    if (value >= orange) return QColor("#FFA500");
+    if (value >= yellow) return QColor("#FFD700");
+    return low;
+}
+
+// Whether anything a process row shows differs between two snapshots
+bool rowDiffers(const ProcessInfo &a, const ProcessInfo &b)
+{
+    return a.cpuUsage != b.cpuUsage || a.memoryUsage != b.memoryUsage || a.pssKb != b.pssKb
+        || a.memoryDetailApproximate != b.memoryDetailApproximate || a.memoryLeakSuspected != b.memoryLeakSuspected
+        || a.diskUsage != b.diskUsage || a.networkUsage != b.networkUsage || a.cpuZScore != b.cpuZScore
+        || a.status != b.status || a.nameId != b.nameId || a.affinity != b.affinity
+        || a.scheduling.valid != b.scheduling.valid || a.scheduling.nice != b.scheduling.nice
+        || a.scheduling.policy != b.scheduling.policy || a.scheduling.ioClass != b.scheduling.ioClass
+        || a.scheduling.ioLevel != b.scheduling.ioLevel;
+}
+
+} // namespace
+
+ProcessTableModel::ProcessTableModel(QObject *parent) : QAbstractTableModel(parent),
+    hasMemoryDetail(false),
+    totalMemory(0),
+    sparklineColumns(nullptr),
+    sparklineSource(nullptr),
+    historySource(nullptr)
+{
+}
+
+void ProcessTableModel::setSparklines(const ProcessColumns *columns, const ProcessSparklines *sparklines)
+{
+    sparklineColumns = columns;
+    sparklineSource = sparklines;
+}
+
+int ProcessTableModel::sparklineOf(const ProcessInfo &process) const
+{
+    if (!sparklineColumns || !sparklineSource) {
+        return -1;
+    }
+    return sparklineSource->slotOf(sparklineColumns->rowOf(process.pid, process.startTime));
+}
+
+void ProcessTableModel::setGroups(const QVector<Group> &groups, bool memoryDetail, qint64 totalMemoryKb)
+{
+    QVector<Row> nextRows;
+    for (int group = 0; group < groups.size(); ++group) {
+        nextRows.append(Row{group, -1, -1});
+        for (int index = 0; index < groups[group].processes.size(); ++index) {
+            nextRows.append(Row{group, index, sparklineOf(groups[group].processes[index])});
+        }
+    }
+
+    bool sameRows = nextRows.size() == rows.size();
+    for (int row = 0; sameRows && row < rows.size(); ++row) {
+        const Row &a = rows[row];
+        const Row &b = nextRows[row];
+        if (a.index != b.index || groupList[a.group].key != groups[b.group].key) {
+            sameRows = false;
+        } else if (a.index >= 0) {
+            const ProcessInfo &before = groupList[a.group].processes[a.index];
+            const ProcessInfo &after = groups[b.group].processes[b.index];
+            sameRows = before.pid == after.pid && before.startTime == after.startTime;
+        }
+    }
+
+    if (sameRows) {
+        // Report changed rows in contiguous runs; the view repaints only
+        // the part of each run that is on screen
+        const bool allChanged = memoryDetail != hasMemoryDetail || totalMemoryKb != totalMemory;
+        QVector<bool> changed(nextRows.size(), allChanged);
+        for (int row = 0; !allChanged && row < nextRows.size(); ++row) {
+            const Row &a = rows[row];
+            const Row &b = nextRows[row];
+            if (b.index < 0) {
+                const Group &before = groupList[a.group];
+                const Group &after = groups[b.group];
+                changed[row] = before.count != after.count || before.collapsed != after.collapsed || before.title != after.title
+                    || !std::equal(std::begin(before.totals), std::end(before.totals), std::begin(after.totals));
+            } else {
+                changed[row] = a.sparkline != b.sparkline || (sparklineSource && sparklineSource->changed(b.sparkline))
+                    || rowDiffers(groupList[a.group].processes[a.index], groups[b.group].processes[b.index]);
+            }
+        }
+        groupList = groups;
+        rows.swap(nextRows);
+        hasMemoryDetail = memoryDetail;
+        totalMemory = totalMemoryKb;
+        for (int first = 0; first < rows.size(); ++first) {
+            if (!changed[first]) {
+                continue;
+            }
+            int last = first;
+            while (last + 1 < rows.size() && changed[last + 1]) {
+                ++last;
+            }
+            emit dataChanged(index(first, 0), index(last, ColumnCount - 1));
+            first = last;
+        }
+        return;
+    }
+
+    // Rows are identified by (pid, start time), group headers by (-1, key);
+    // no process has a negative pid
+    QHash<QPair<qint64, qint64>, int> previousRowOf;
+    previousRowOf.reserve(rows.size());
+    for (int row = 0; row < rows.size(); ++row) {
+        if (const ProcessInfo *process = processAt(row)) {
+            previousRowOf.insert(qMakePair(process->pid, process->startTime), row);
+        } else {
+            previousRowOf.insert(qMakePair(qint64(-1), groupList[rows[row].group].key), row);
+        }
+    }
+    // Keep the cached texts of processes that are still listed
+    const CellText unset{std::numeric_limits<double>::quiet_NaN(), QString()};
+    QVector<CellText> nextTexts(nextRows.size() * CachedCellCount, unset);
+    QVector<int> previousOfNext(nextRows.size(), -1);
+    bool reordered = nextRows.size() == rows.size();
+    for (int row = 0; row < nextRows.size(); ++row) {
+        const Row &next = nextRows[row];
+        if (next.index < 0) {
+            previousOfNext[row] = previousRowOf.value(qMakePair(qint64(-1), groups[next.group].key), -1);
+            reordered = reordered && previousOfNext[row] >= 0;
+            continue;
+        }
+        const ProcessInfo &process = groups[next.group].processes[next.index];
+        int previous = previousRowOf.value(qMakePair(process.pid, process.startTime), -1);
+        previousOfNext[row] = previous;
+        reordered = reordered && previous >= 0;
+        for (int cell = 0; previous >= 0 && cell < CachedCellCount; ++cell) {
+            nextTexts[row * CachedCellCount + cell].key = cellTexts[previous * CachedCellCount + cell].key;
+            nextTexts[row * CachedCellCount + cell].text.swap(cellTexts[previous * CachedCellCount + cell].text);
+        }
+    }
+
+    if (reordered) {
+        // The same rows in another order, e.g. after a sort: a layout change
+        // keeps selection, current row and scroll anchor on their processes
+        emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+        QVector<int> nextOfPrevious(rows.size(), -1);
+        for (int row = 0; row < previousOfNext.size(); ++row) {
+            nextOfPrevious[previousOfNext[row]] = row;
+        }
+        const QModelIndexList from = persistentIndexList();
+        QModelIndexList to;
+        to.reserve(from.size());
+        for (const QModelIndex &index : from) {
+            to.append(this->index(nextOfPrevious[index.row()], index.column()));
+        }
+        groupList = groups;
+        rows.swap(nextRows);
+        cellTexts.swap(nextTexts);
+        hasMemoryDetail = memoryDetail;
+        totalMemory = totalMemoryKb;
+        changePersistentIndexList(from, to);
+        emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+        return;
+    }
+
+    beginResetModel();
+    groupList = groups;
+    rows.swap(nextRows);
+    cellTexts.swap(nextTexts);
+    hasMemoryDetail = memoryDetail;
+    totalMemory = totalMemoryKb;
+    endResetModel();
+}
+
+int ProcessTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int ProcessTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+bool ProcessTableModel::isGroupHeader(int row) const
+{
+    return row >= 0 && row < rows.size() && rows[row].index < 0;
+}
+
+const ProcessTableModel::Group *ProcessTableModel::groupAt(int row) const
+{
+    return isGroupHeader(row) ? &groupList[rows[row].group] : nullptr;
+}
+
+const ProcessInfo *ProcessTableModel::processAt(int row) const
+{
+    if (row < 0 || row >= rows.size() || rows[row].index < 0) {
+        return nullptr;
+    }
+    return &groupList[rows[row].group].processes[rows[row].index];
+}
+
+int ProcessTableModel::rowOfPid(qint64 pid) const
+{
+    for (int row = 0; row < rows.size(); ++row) {
+        const ProcessInfo *process = processAt(row);
+        if (process && process->pid == pid) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+Qt::ItemFlags ProcessTableModel::flags(const QModelIndex &index) const
+{
+    // Enabled so that clicks reach the view, which collapses the group
+    if (isGroupHeader(index.row())) {
+        return Qt::ItemIsEnabled;
+    }
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+}
+
+QVariant ProcessTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    static const char *const titles[ColumnCount] = {
+        "Name", "Status", "CPU", "Memory (auto)", "Disk", "Network", "CPU Anomaly", "Affinity",
+        "Nice", "Policy", "I/O Priority", "CPU Trend", "Memory Trend"
+    };
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 && section < ColumnCount) {
+        return QString(titles[section]);
+    }
+    return QVariant();
+}
+
+QVariant ProcessTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows.size()) {
+        return QVariant();
+    }
+    const Row &row = rows[index.row()];
+    const Group &group = groupList[row.group];
+    if (row.index >= 0) {
+        return processData(index.row(), index.column(), role);
+    }
+
+    // Group header; the view spans the title over the columns before CPU
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        // Triangles pointing right (collapsed) and down, as UTF-8 bytes
+        case NameColumn:
+            return QString::fromUtf8(group.collapsed ? "\xE2\x96\xB8 " : "\xE2\x96\xBE ")
+                + QString("%1 (%2)").arg(group.title).arg(group.count);
+        case CpuColumn: return numberformat::fixed(group.totals[ProcessColumns::Cpu], 1, "%");
+        case MemoryColumn:
+            return numberformat::memorySize(qint64(group.totals[hasMemoryDetail ? ProcessColumns::PssKb : ProcessColumns::MemoryKb]));
+        case DiskColumn: return numberformat::fixed(group.totals[ProcessColumns::DiskMBps], 2, " MB/s");
+        case NetworkColumn: return numberformat::fixed(group.totals[ProcessColumns::NetworkMBps], 2, " MB/s");
+        default: return QVariant();
+        }
+    case Qt::ForegroundRole:
+        return QColor("#80bfff");
+    case GroupHeaderRole:
+        return true;
+    default:
+        return QVariant();
+    }
+}
+
+QString ProcessTableModel::cellText(int row, CachedCell cell, double key, QString (*format)(double)) const
+{
+    CellText &cached = cellTexts[row * CachedCellCount + cell];
+    // NaN never compares equal, so unset entries always format
+    if (!(cached.key == key)) {
+        cached.key = key;
+        cached.text = format(key);
+    }
+    return cached.text;
+}
+
+QVariant ProcessTableModel::processData(int row, int column, int role) const
+{
+    const ProcessInfo &proc = groupList[rows[row].group].processes[rows[row].index];
+    const int sparkline = rows[row].sparkline;
+    if (role == PidRole) {
+        return proc.pid;
+    }
+
+    if (role == SparklineRole) {
+        return (column == CpuTrendColumn || column == MemoryTrendColumn) && sparkline >= 0 ? QVariant(sparkline) : QVariant();
+    }
+
+    if (role == HeatRole) {
+        switch (column) {
+        case CpuColumn: return proc.cpuUsage / 100.0;
+        case MemoryColumn:
+            return totalMemory > 0 ? double(hasMemoryDetail ? proc.pssKb : proc.memoryUsage) / double(totalMemory) : QVariant();
+        case DiskColumn: return qMax(0.0, proc.diskUsage) / DISK_FULL_SCALE_MBPS;
+        case NetworkColumn: return proc.networkUsage >= 0 ? proc.networkUsage / NETWORK_FULL_SCALE_MBPS : QVariant();
+        case AnomalyColumn: return proc.cpuZScore > 0.0 ? proc.cpuZScore / ANOMALY_FULL_SCALE : QVariant();
+        default: return QVariant();
+        }
+    }
+
+    const SchedulingInfo &scheduling = proc.scheduling;
+    if (role == Qt::DisplayRole) {
+        switch (column) {
+        case NameColumn: return proc.name;
+        case StatusColumn: return processStatusText(proc.status);
+        case CpuColumn:
+            return cellText(row, CpuCell, proc.cpuUsage, [](double cpu) { return numberformat::fixed(cpu, 1, "%"); });
+        case MemoryColumn: {
+            // Prefer PSS, which does not double-count shared libraries; "~" marks estimates.
+            // The key packs the size and the estimate flag: 2 * kb + flag.
+            if (!hasMemoryDetail) {
+                return cellText(row, MemoryCell, double(proc.memoryUsage) * 2.0,
+                                [](double key) { return numberformat::memorySize(qint64(key) / 2); });
+            }
+            return cellText(row, MemoryCell, double(proc.pssKb) * 2.0 + (proc.memoryDetailApproximate ? 1.0 : 0.0),
+                            [](double key) {
+                                QString text = numberformat::memorySize(qint64(key) / 2);
+                                return (qint64(key) & 1) ? "~" + text : text;
+                            });
+        }
+        case DiskColumn:
+            return cellText(row, DiskCell, qMax(0.0, proc.diskUsage), [](double disk) { return numberformat::fixed(disk, 2, " MB/s"); });
+        case NetworkColumn:
+            return cellText(row, NetworkCell, proc.networkUsage, [](double network) {
+                return network < 0 ? QString("N/A") : numberformat::fixed(network, 2, " MB/s");
+            });
+        case AnomalyColumn:
+            return cellText(row, AnomalyCell, proc.cpuZScore, [](double zScore) {
+                // Suffix is " \u03C3" (sigma) spelled as UTF-8 bytes
+                return zScore > 0.0 ? numberformat::fixed(zScore, 1, " \xCF\x83") : QString("-");
+            });
+        case AffinityColumn: return proc.affinity.isEmpty() ? QString("All") : proc.affinity;
+        case NiceColumn: return scheduling.valid ? QString::number(scheduling.nice) : QString("-");
+        case PolicyColumn: return scheduling.valid ? ProcessScheduling::policyName(scheduling.policy) : QString("-");
+        case IoPriorityColumn:
+            return scheduling.valid ? ProcessScheduling::ioPriorityText(scheduling.ioClass, scheduling.ioLevel) : QString("-");
+        default: return QVariant();
+        }
+    }
+
+    if (role == Qt::ForegroundRole) {
+        switch (column) {
+        case NameColumn: return QColor("#fff");
+        case StatusColumn: return QColor("#b0b0b0");
+        case CpuColumn: return bandColor(proc.cpuUsage, 80.0, 50.0, 20.0, QColor("#4CAF50"));
+        case MemoryColumn: return QColor(proc.memoryLeakSuspected ? "#FFA500" : "#2196F3");
+        case DiskColumn: return bandColor(proc.diskUsage, 10.0, 5.0, 1.0, QColor("#FF9800"));
+        case NetworkColumn:
+            return proc.networkUsage < 0 ? QColor("#888") : bandColor(proc.networkUsage, 5.0, 2.0, 0.5, QColor("#00BFFF"));
+        case AnomalyColumn: return bandColor(proc.cpuZScore, 8.0, 4.0, 2.0, QColor("#b0b0b0"));
+        case AffinityColumn: return QColor(proc.affinity.isEmpty() ? "#b0b0b0" : "#80bfff");
+        // Highlight anything that deviates from the defaults
+        case NiceColumn: return QColor(scheduling.nice != 0 ? "#80bfff" : "#b0b0b0");
+        case PolicyColumn: return QColor(scheduling.policy != SchedPolicy::Other ? "#80bfff" : "#b0b0b0");
+        case IoPriorityColumn: return QColor(scheduling.ioClass != IoClass::None ? "#80bfff" : "#b0b0b0");
+        default: return QVariant();
+        }
+    }
+
+    if (role == Qt::ToolTipRole) {
+        // Decoded on hover only; a day of one process is a few thousand samples
+        ProcessHistory::Summary history;
+        const bool hasHistory = (column == CpuColumn || column == MemoryColumn) && historySource && sparklineColumns
+            && historySource->summarize(sparklineColumns->rowOf(proc.pid, proc.startTime), history);
+        const QString since = hasHistory ? QDateTime::fromMSecsSinceEpoch(history.sinceMs).toString("hh:mm") : QString();
+        if (column == CpuColumn && hasHistory) {
+            return QString("Last hour: %1% average, %2% peak\nSince %3: %4% average")
+                .arg(history.hourCpuMean, 0, 'f', 1)
+                .arg(history.hourCpuPeak, 0, 'f', 1)
+                .arg(since)
+                .arg(history.cpuMean, 0, 'f', 1);
+        }
+        if (column == MemoryColumn) {
+            QString tip;
+            if (hasMemoryDetail) {
+                tip = QString("PSS: %1\nUSS: %2\nRSS: %3\nSwap: %4\nAnon huge pages: %5%6")
+                    .arg(formatMemorySize(proc.pssKb))
+                    .arg(formatMemorySize(proc.ussKb))
+                    .arg(formatMemorySize(proc.memoryUsage))
+                    .arg(proc.swapKb < 0 ? QString("unknown") : formatMemorySize(proc.swapKb))
+                    .arg(proc.anonHugeKb < 0 ? QString("unknown") : formatMemorySize(proc.anonHugeKb))
+                    .arg(proc.memoryDetailApproximate ? "\n(~ estimated from statm)" : "");
+            }
+            if (proc.memoryLeakSuspected) {
+                tip += (tip.isEmpty() ? "" : "\n") + QString("Growing steadily: +%1 MB/h").arg(proc.memoryGrowthMBPerHour, 0, 'f', 0);
+            }
+            if (hasHistory) {
+                tip += (tip.isEmpty() ? "" : "\n") + QString("Peak since %1: %2")
+                    .arg(since, formatMemorySize(qint64(history.memoryPeakKb)));
+            }
+            return tip.isEmpty() ? QVariant() : tip;
+        }
+        if (column == AnomalyColumn) {
+            return QString("Usual CPU: %1%").arg(proc.cpuBaseline, 0, 'f', 1);
+        }
+        if (column == CpuTrendColumn || column == MemoryTrendColumn) {
+            return QString("Last minute, scaled to the process' own range");
+        }
+    }
+    return QVariant();
+}
+
+QString ProcessTableModel::formatMemorySize(qint64 kb)
+{
+    return numberformat::memorySize(kb);
+}
@@ -0,0 +1,117 @@
+#ifndef PROCESSTABLEMODEL_H
+#define PROCESSTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include "systeminfo.h"
+
+class ProcessSparklines;
+class ProcessHistory;
+
+// Grouped process list for the Processes view: a header row per group,
+// with the group's totals in the usage columns, followed by its processes
+// unless the group is collapsed. Cells are produced on request, so only rows the view actually
+// shows are ever formatted.
+class ProcessTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn,
+        StatusColumn,
+        CpuColumn,
+        MemoryColumn,
+        DiskColumn,
+        NetworkColumn,
+        AnomalyColumn,
+        AffinityColumn,
+        NiceColumn,
+        PolicyColumn,
+        IoPriorityColumn,
+        CpuTrendColumn,             // Sparklines, painted by the delegate
+        MemoryTrendColumn,
+        ColumnCount
+    };
+
+    enum Role {
+        PidRole = Qt::UserRole,     // On every cell of a process row
+        GroupHeaderRole,            // True on group header rows
+        HeatRole,                   // Share of the column's full scale, 0..1, for usage bars
+        SparklineRole               // Slot in ProcessSparklines, on trend columns
+    };
+
+    struct Group {
+        qint64 key;                         // Identifies the group across updates
+        QString title;
+        int count;                          // Processes in the group, listed or not
+        bool collapsed;                     // Only the header row is shown
+        QVector<ProcessInfo> processes;     // Listed processes
+        double totals[ProcessColumns::MetricCount];     // Sums per metric
+    };
+
+    explicit ProcessTableModel(QObject *parent = nullptr);
+
+    // Source of the trend columns; rows are matched through columns
+    void setSparklines(const ProcessColumns *columns, const ProcessSparklines *sparklines);
+    // Source of the CPU and memory tooltips' history, matched the same way
+    void setHistory(const ProcessHistory *history) { historySource = history; }
+
+    // Updates in place when the rows are the same processes in the same
+    // order, which keeps selection and scroll position; only rows whose
+    // cells changed are reported to the view. The same rows in another
+    // order are a layout change that moves persistent indexes with their
+    // processes; anything else resets.
+    void setGroups(const QVector<Group> &groups, bool memoryDetail, qint64 totalMemoryKb);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+    bool isGroupHeader(int row) const;
+    // Group of a header row, or nullptr
+    const Group *groupAt(int row) const;
+    const ProcessInfo *processAt(int row) const;
+    int rowOfPid(qint64 pid) const;
+
+    static QString formatMemorySize(qint64 kb);
+
+private:
+    struct Row {
+        int group;
+        int index;      // -1 for the group header
+        int sparkline;  // Slot in sparklineSource, or -1
+    };
+
+    // Numeric cells keep their last text with the raw value it was made
+    // from; a cell whose value did not change reuses the string
+    enum CachedCell {
+        CpuCell,
+        MemoryCell,
+        DiskCell,
+        NetworkCell,
+        AnomalyCell,
+        CachedCellCount
+    };
+
+    struct CellText {
+        double key;
+        QString text;
+    };
+
+    QVariant processData(int row, int column, int role) const;
+    QString cellText(int row, CachedCell cell, double key, QString (*format)(double)) const;
+    int sparklineOf(const ProcessInfo &process) const;
+
+    QVector<Group> groupList;
+    QVector<Row> rows;
+    mutable QVector<CellText> cellTexts;    // CachedCellCount per row
+    bool hasMemoryDetail;
+    qint64 totalMemory;
+    const ProcessColumns *sparklineColumns;
+    const ProcessSparklines *sparklineSource;
+    const ProcessHistory *historySource;
+};
+
+#endif // PROCESSTABLEMODEL_H
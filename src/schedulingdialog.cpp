@@ -0,0 +1,91 @@
+#include "schedulingdialog.h"
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QVBoxLayout>
+
+SchedulingDialog::SchedulingDialog(const SchedulingInfo &current, const QString &target, QWidget *parent) : QDialog(parent),
+    niceSpin(nullptr),
+    policySelect(nullptr),
+    ioClassSelect(nullptr),
+    ioLevelSpin(nullptr)
+{
+    setWindowTitle("Set Scheduling");
+    setFixedWidth(380);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(10);
+
+    QLabel *headerLabel = new QLabel(target);
+    headerLabel->setStyleSheet("font-weight: bold; color: #fff;");
+    headerLabel->setWordWrap(true);
+    mainLayout->addWidget(headerLabel);
+
+    QFormLayout *form = new QFormLayout();
+    niceSpin = new QSpinBox();
+    niceSpin->setRange(-20, 19);
+    niceSpin->setValue(current.nice);
+    niceSpin->setToolTip("Lower values get more CPU time. Negative values need privileges.");
+
+    policySelect = new QComboBox();
+    policySelect->addItem(ProcessScheduling::policyName(SchedPolicy::Other), static_cast<int>(SchedPolicy::Other));
+    policySelect->addItem(ProcessScheduling::policyName(SchedPolicy::Batch), static_cast<int>(SchedPolicy::Batch));
+    policySelect->addItem(ProcessScheduling::policyName(SchedPolicy::Idle), static_cast<int>(SchedPolicy::Idle));
+    policySelect->setCurrentIndex(qMax(0, policySelect->findData(static_cast<int>(current.policy))));
+    policySelect->setToolTip("Batch: throughput work that can wait. Idle: only runs when the CPU is otherwise idle.");
+
+    ioClassSelect = new QComboBox();
+    ioClassSelect->addItem("Default (from nice)", static_cast<int>(IoClass::None));
+    ioClassSelect->addItem("Best effort", static_cast<int>(IoClass::BestEffort));
+    ioClassSelect->addItem("Idle", static_cast<int>(IoClass::Idle));
+    ioClassSelect->addItem("Realtime", static_cast<int>(IoClass::RealTime));
+    ioClassSelect->setCurrentIndex(qMax(0, ioClassSelect->findData(static_cast<int>(current.ioClass))));
+
+    ioLevelSpin = new QSpinBox();
+    ioLevelSpin->setRange(0, 7);
+    ioLevelSpin->setValue(current.ioLevel);
+    ioLevelSpin->setToolTip("0 is the highest priority within the class, 7 the lowest");
+
+    // Levels only exist for the best-effort and realtime classes
+    auto updateLevel = [this]() {
+        IoClass ioClass = static_cast<IoClass>(ioClassSelect->currentData().toInt());
+        ioLevelSpin->setEnabled(ioClass == IoClass::BestEffort || ioClass == IoClass::RealTime);
+    };
+    connect(ioClassSelect, QOverload<int>::of(&QComboBox::currentIndexChanged), this, updateLevel);
+    updateLevel();
+
+    form->addRow("Nice:", niceSpin);
+    form->addRow("CPU policy:", policySelect);
+    form->addRow("I/O class:", ioClassSelect);
+    form->addRow("I/O level:", ioLevelSpin);
+    mainLayout->addLayout(form);
+
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    buttonBox->button(QDialogButtonBox::Ok)->setText("Apply");
+    mainLayout->addWidget(buttonBox);
+    connect(buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    setStyleSheet(R"(
+        QDialog {
+            background-color: #1e1e1e;
+        }
+        QLabel {
+            color: #ffffff;
+        }
+    )");
+}
+
+SchedulingInfo SchedulingDialog::scheduling() const
+{
+    SchedulingInfo info;
+    info.valid = true;
+    info.nice = niceSpin->value();
+    info.policy = static_cast<SchedPolicy>(policySelect->currentData().toInt());
+    info.ioClass = static_cast<IoClass>(ioClassSelect->currentData().toInt());
+    info.ioLevel = ioLevelSpin->value();
+    return info;
+}
@@ -0,0 +1,28 @@
+#ifndef SCHEDULINGDIALOG_H
+#define SCHEDULINGDIALOG_H
+
+#include <QDialog>
+#include "processscheduling.h"
+
+QT_BEGIN_NAMESPACE
+class QComboBox;
+class QSpinBox;
+QT_END_NAMESPACE
+
+// Edits nice, scheduling policy and I/O priority for one or more processes
+class SchedulingDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    SchedulingDialog(const SchedulingInfo &current, const QString &target, QWidget *parent = nullptr);
+
+    SchedulingInfo scheduling() const;
+
+private:
+    QSpinBox *niceSpin;
+    QComboBox *policySelect;
+    QComboBox *ioClassSelect;
+    QSpinBox *ioLevelSpin;
+};
+
+#endif // SCHEDULINGDIALOG_H
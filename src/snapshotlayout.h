@@ -0,0 +1,81 @@
+#ifndef SNAPSHOTLAYOUT_H
+#define SNAPSHOTLAYOUT_H
+
+// Shared-memory snapshot format, shared by SnapshotPublisher and the
+// standalone reader library. Plain C++ only: readers do not link Qt.
+//
+// The segment holds a header and two slots. The publisher always writes the
+// slot that is not current, bracketing the write with the slot's sequence
+// counter (odd while writing), and then advances the header generation.
+// Readers pick the current slot, read in place, and accept the result only
+// if the slot's sequence was even and unchanged across the read.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace snapshot {
+
+constexpr uint32_t MAGIC = 0x50524d53;   // "PRMS"
+constexpr uint32_t VERSION = 1;
+constexpr const char *DEFAULT_NAME = "/procmanager-snapshot";
+constexpr int NAME_LENGTH = 64;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory counters must be lock-free to be address-free");
+
+struct Process {
+    int64_t pid;
+    int64_t startTime;
+    int64_t residentKb;
+    int64_t pssKb;
+    double cpuUsage;        // Percent of total CPU
+    double diskMBps;
+    double cpuZScore;
+    uint32_t type;          // ProcessType
+    uint32_t reserved;
+    char name[NAME_LENGTH]; // UTF-8, NUL-terminated, truncated if longer
+};
+
+struct SlotHeader {
+    std::atomic<uint64_t> sequence;
+    uint64_t generation;
+    int64_t timestampMs;
+    double cpuUsage;
+    double memoryUsage;
+    double diskUsage;
+    uint32_t processCount;
+    uint32_t truncated;     // Non-zero if more processes existed than fit
+};
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;      // Processes per slot
+    uint32_t slotBytes;
+    std::atomic<uint64_t> generation;   // Slot (generation & 1) is current
+};
+
+inline size_t slotSize(uint32_t capacity)
+{
+    return sizeof(SlotHeader) + size_t(capacity) * sizeof(Process);
+}
+
+inline size_t segmentSize(uint32_t capacity)
+{
+    return sizeof(Header) + 2 * slotSize(capacity);
+}
+
+inline SlotHeader *slotAt(void *base, uint32_t capacity, int index)
+{
+    return reinterpret_cast<SlotHeader *>(static_cast<char *>(base) + sizeof(Header) + index * slotSize(capacity));
+}
+
+inline Process *processesOf(SlotHeader *slot)
+{
+    return reinterpret_cast<Process *>(slot + 1);
+}
+
+} // namespace snapshot
+
+#endif // SNAPSHOTLAYOUT_H
@@ -0,0 +1,92 @@
+#include "snapshotpublisher.h"
+#include "systeminfo.h"
+#include <QDateTime>
+#include <QDebug>
+#include <cstring>
+
+SnapshotPublisher::SnapshotPublisher(SystemInfo *source, QObject *parent) : QObject(parent),
+    systemInfo(source)
+{
+    connect(systemInfo, &SystemInfo::dataUpdated, this, &SnapshotPublisher::onSnapshot);
+}
+
+SnapshotPublisher::~SnapshotPublisher()
+{
+    close();
+}
+
+bool SnapshotPublisher::open(const QString &name, int processCapacity)
+{
+#ifdef Q_OS_UNIX
+    if (processCapacity <= 0) {
+        return false;
+    }
+    std::string error;
+    if (!writer.open(name.toStdString(), uint32_t(processCapacity), &error)) {
+        qWarning() << "Failed to create shared-memory segment" << name << QString::fromStdString(error);
+        return false;
+    }
+    onSnapshot();
+    return true;
+#else
+    Q_UNUSED(name);
+    Q_UNUSED(processCapacity);
+    qWarning() << "Shared-memory snapshots are not supported on this platform";
+    return false;
+#endif
+}
+
+void SnapshotPublisher::close()
+{
+#ifdef Q_OS_UNIX
+    writer.close();
+#endif
+}
+
+void SnapshotPublisher::onSnapshot()
+{
+#ifdef Q_OS_UNIX
+    snapshot::SlotHeader *slot = writer.beginWrite();
+    if (!slot) {
+        return;
+    }
+    const ProcessColumns &columns = systemInfo->getProcessColumns();
+
+    uint32_t count = uint32_t(qMin<qint64>(columns.rows, writer.capacity()));
+    slot->timestampMs = QDateTime::currentMSecsSinceEpoch();
+    slot->cpuUsage = systemInfo->getCpuUsage();
+    slot->memoryUsage = systemInfo->getMemoryUsage();
+    slot->diskUsage = systemInfo->getDiskUsage();
+    slot->processCount = count;
+    slot->truncated = uint32_t(columns.rows) > count ? 1 : 0;
+
+    const double *cpu = columns.column(ProcessColumns::Cpu);
+    const double *memory = columns.column(ProcessColumns::MemoryKb);
+    const double *pss = columns.column(ProcessColumns::PssKb);
+    const double *disk = columns.column(ProcessColumns::DiskMBps);
+    const double *zScore = columns.column(ProcessColumns::CpuZScore);
+    snapshot::Process *processes = snapshot::processesOf(slot);
+    for (uint32_t row = 0; row < count; ++row) {
+        snapshot::Process &process = processes[row];
+        process.pid = columns.pid[row];
+        process.startTime = columns.startTime[row];
+        process.residentKb = qint64(memory[row]);
+        process.pssKb = qint64(pss[row]);
+        process.cpuUsage = cpu[row];
+        process.diskMBps = disk[row];
+        process.cpuZScore = zScore[row];
+        process.type = uint32_t(columns.type[row]);
+        process.reserved = 0;
+
+        // Truncate on a character boundary so the name stays valid UTF-8
+        QByteArray name = columns.name[row].toUtf8();
+        int length = qMin(int(name.size()), snapshot::NAME_LENGTH - 1);
+        while (length > 0 && length < name.size() && (uchar(name[length]) & 0xC0) == 0x80) {
+            --length;
+        }
+        std::memcpy(process.name, name.constData(), size_t(length));
+        std::memset(process.name + length, 0, size_t(snapshot::NAME_LENGTH - length));
+    }
+    writer.publish();
+#endif
+}
@@ -0,0 +1,37 @@
+#ifndef SNAPSHOTPUBLISHER_H
+#define SNAPSHOTPUBLISHER_H
+
+#include <QObject>
+#include <QString>
+#include "snapshotlayout.h"
+#ifdef Q_OS_UNIX
+#include "snapshotwriter.h"
+#endif
+
+class SystemInfo;
+
+// Publishes every snapshot into a POSIX shared-memory segment (see
+// snapshotlayout.h) through SnapshotWriter, so local tools can read it with
+// SnapshotReader without talking to this process. Unsupported platforms
+// fail to open.
+class SnapshotPublisher : public QObject {
+    Q_OBJECT
+
+public:
+    explicit SnapshotPublisher(SystemInfo *source, QObject *parent = nullptr);
+    ~SnapshotPublisher();
+
+    bool open(const QString &name = snapshot::DEFAULT_NAME, int capacity = 8192);
+    void close();
+
+private slots:
+    void onSnapshot();
+
+private:
+    SystemInfo *systemInfo;
+#ifdef Q_OS_UNIX
+    SnapshotWriter writer;
+#endif
+};
+
+#endif // SNAPSHOTPUBLISHER_H
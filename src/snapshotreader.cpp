@@ -0,0 +1,96 @@
+#include "snapshotreader.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+SnapshotReader::~SnapshotReader()
+{
+    close();
+}
+
+bool SnapshotReader::open(const std::string &name)
+{
+    close();
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(snapshot::Header)) {
+        ::close(fd);
+        return false;
+    }
+    void *mapped = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    const snapshot::Header *header = static_cast<const snapshot::Header *>(mapped);
+    if (header->magic != snapshot::MAGIC || header->version != snapshot::VERSION
+        || snapshot::segmentSize(header->capacity) > size_t(info.st_size)) {
+        munmap(mapped, size_t(info.st_size));
+        return false;
+    }
+    base = mapped;
+    mappedBytes = size_t(info.st_size);
+    capacity = header->capacity;
+    return true;
+}
+
+void SnapshotReader::close()
+{
+    if (base) {
+        munmap(base, mappedBytes);
+        base = nullptr;
+        mappedBytes = 0;
+        capacity = 0;
+    }
+}
+
+uint64_t SnapshotReader::generation() const
+{
+    if (!base) {
+        return 0;
+    }
+    return static_cast<const snapshot::Header *>(base)->generation.load(std::memory_order_acquire);
+}
+
+bool SnapshotReader::begin(int &slot, uint64_t &sequence) const
+{
+    if (!base) {
+        return false;
+    }
+    const snapshot::Header *header = static_cast<const snapshot::Header *>(base);
+    uint64_t generation = header->generation.load(std::memory_order_acquire);
+    if (generation == 0) {
+        return false;   // Nothing published yet
+    }
+    slot = int(generation & 1);
+    sequence = snapshot::slotAt(base, capacity, slot)->sequence.load(std::memory_order_acquire);
+    return (sequence & 1) == 0;
+}
+
+bool SnapshotReader::validate(int slot, uint64_t sequence) const
+{
+    // Order the data reads before the second sequence read
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return snapshot::slotAt(base, capacity, slot)->sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+bool SnapshotReader::copy(snapshot::SlotHeader &header, std::vector<snapshot::Process> &processes, int maxAttempts) const
+{
+    return read([&](const View &view) {
+        header.generation = view.header->generation;
+        header.timestampMs = view.header->timestampMs;
+        header.cpuUsage = view.header->cpuUsage;
+        header.memoryUsage = view.header->memoryUsage;
+        header.diskUsage = view.header->diskUsage;
+        header.processCount = view.processCount;
+        header.truncated = view.header->truncated;
+        processes.resize(view.processCount);
+        std::memcpy(processes.data(), view.processes, view.processCount * sizeof(snapshot::Process));
+    }, maxAttempts);
+}
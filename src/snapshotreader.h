@@ -0,0 +1,72 @@
+#ifndef SNAPSHOTREADER_H
+#define SNAPSHOTREADER_H
+
+// Lock-free reader for snapshots published by ProcManager with
+// --publish-shm. Any number of readers can map the segment; reading never
+// takes a lock, makes a syscall or blocks the publisher.
+
+#include "snapshotlayout.h"
+#include <string>
+#include <vector>
+
+class SnapshotReader {
+public:
+    struct View {
+        const snapshot::SlotHeader *header;
+        const snapshot::Process *processes;
+        uint32_t processCount;
+    };
+
+    SnapshotReader() = default;
+    ~SnapshotReader();
+    SnapshotReader(const SnapshotReader &) = delete;
+    SnapshotReader &operator=(const SnapshotReader &) = delete;
+
+    bool open(const std::string &name = snapshot::DEFAULT_NAME);
+    void close();
+    bool isOpen() const { return base != nullptr; }
+
+    uint64_t generation() const;
+
+    // Calls visit(view) on the current snapshot in place, retrying until
+    // the snapshot was not overwritten while being visited. visit must only
+    // read from the view and may be called more than once. Returns false
+    // if no consistent snapshot could be read within maxAttempts.
+    template <typename Visitor>
+    bool read(Visitor visit, int maxAttempts = 64) const;
+
+    // Copies the current snapshot; convenient when the data must outlive the read
+    bool copy(snapshot::SlotHeader &header, std::vector<snapshot::Process> &processes, int maxAttempts = 64) const;
+
+private:
+    bool begin(int &slot, uint64_t &sequence) const;
+    bool validate(int slot, uint64_t sequence) const;
+
+    void *base = nullptr;
+    size_t mappedBytes = 0;
+    uint32_t capacity = 0;
+};
+
+template <typename Visitor>
+bool SnapshotReader::read(Visitor visit, int maxAttempts) const
+{
+    for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+        int slot = 0;
+        uint64_t sequence = 0;
+        if (!begin(slot, sequence)) {
+            continue;
+        }
+        snapshot::SlotHeader *header = snapshot::slotAt(base, capacity, slot);
+        uint32_t count = header->processCount;
+        if (count > capacity) {
+            continue;
+        }
+        visit(View{header, snapshot::processesOf(header), count});
+        if (validate(slot, sequence)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // SNAPSHOTREADER_H
@@ -0,0 +1,119 @@
+#include "snapshotwriter.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+void setError(std::string *error, const char *step)
+{
+    if (error) {
+        *error = std::string(step) + ": " + std::strerror(errno);
+    }
+}
+
+} // namespace
+
+SnapshotWriter::~SnapshotWriter()
+{
+    close();
+}
+
+bool SnapshotWriter::open(const std::string &name, uint32_t processCapacity, std::string *error)
+{
+    close();
+    if (processCapacity == 0) {
+        if (error) {
+            *error = "capacity must be positive";
+        }
+        return false;
+    }
+    std::string encoded = name;
+    if (encoded.empty() || encoded[0] != '/') {
+        encoded.insert(0, 1, '/');
+    }
+    int fd = shm_open(encoded.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        setError(error, "shm_open");
+        return false;
+    }
+    size_t bytes = snapshot::segmentSize(processCapacity);
+    if (ftruncate(fd, off_t(bytes)) != 0) {
+        setError(error, "ftruncate");
+        ::close(fd);
+        shm_unlink(encoded.c_str());
+        return false;
+    }
+    void *mapped = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        setError(error, "mmap");
+        shm_unlink(encoded.c_str());
+        return false;
+    }
+
+    // Readers check the magic last, so a half-initialized segment is rejected
+    std::memset(mapped, 0, bytes);
+    snapshot::Header *header = new (mapped) snapshot::Header;
+    header->capacity = processCapacity;
+    header->slotBytes = uint32_t(snapshot::slotSize(processCapacity));
+    header->generation.store(0, std::memory_order_relaxed);
+    for (int slot = 0; slot < 2; ++slot) {
+        new (snapshot::slotAt(mapped, processCapacity, slot)) snapshot::SlotHeader;
+        snapshot::slotAt(mapped, processCapacity, slot)->sequence.store(0, std::memory_order_relaxed);
+    }
+    header->version = snapshot::VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = snapshot::MAGIC;
+
+    segmentName = encoded;
+    base = mapped;
+    mappedBytes = bytes;
+    slotCapacity = processCapacity;
+    generation = 0;
+    writing = nullptr;
+    return true;
+}
+
+void SnapshotWriter::close()
+{
+    if (!base) {
+        return;
+    }
+    munmap(base, mappedBytes);
+    shm_unlink(segmentName.c_str());
+    base = nullptr;
+    mappedBytes = 0;
+    slotCapacity = 0;
+    writing = nullptr;
+    segmentName.clear();
+}
+
+snapshot::SlotHeader *SnapshotWriter::beginWrite()
+{
+    if (!base) {
+        return nullptr;
+    }
+    // Write the slot readers are not directed to; the header generation
+    // only moves once the slot is complete
+    writing = snapshot::slotAt(base, slotCapacity, int((generation + 1) & 1));
+    writingSequence = writing->sequence.load(std::memory_order_relaxed);
+    writing->sequence.store(writingSequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    writing->generation = generation + 1;
+    return writing;
+}
+
+void SnapshotWriter::publish()
+{
+    if (!writing) {
+        return;
+    }
+    writing->sequence.store(writingSequence + 2, std::memory_order_release);
+    writing = nullptr;
+    generation++;
+    static_cast<snapshot::Header *>(base)->generation.store(generation, std::memory_order_release);
+}
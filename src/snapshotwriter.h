@@ -0,0 +1,40 @@
+#ifndef SNAPSHOTWRITER_H
+#define SNAPSHOTWRITER_H
+
+// Writer side of the shared-memory snapshot protocol (see snapshotlayout.h).
+// Plain C++ like SnapshotReader, so the protocol can be exercised without Qt.
+// There must be a single writer per segment.
+
+#include "snapshotlayout.h"
+#include <string>
+
+class SnapshotWriter {
+public:
+    SnapshotWriter() = default;
+    ~SnapshotWriter();
+    SnapshotWriter(const SnapshotWriter &) = delete;
+    SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+    // Creates (or replaces) the segment; on failure error says which step failed
+    bool open(const std::string &name, uint32_t capacity, std::string *error = nullptr);
+    // Unmaps and unlinks the segment
+    void close();
+    bool isOpen() const { return base != nullptr; }
+    uint32_t capacity() const { return slotCapacity; }
+
+    // Slot for the next snapshot, with generation set; readers are not
+    // directed to it until publish(). Fill in everything else.
+    snapshot::SlotHeader *beginWrite();
+    void publish();
+
+private:
+    std::string segmentName;
+    void *base = nullptr;
+    size_t mappedBytes = 0;
+    uint32_t slotCapacity = 0;
+    uint64_t generation = 0;
+    snapshot::SlotHeader *writing = nullptr;
+    uint64_t writingSequence = 0;
+};
+
+#endif // SNAPSHOTWRITER_H
@@ -0,0 +1,210 @@
+#include "storagepanel.h"
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QChart>
+#include <QChartView>
+#include <QLineSeries>
+#include <QValueAxis>
+#include <QPainter>
+#include <algorithm>
+
+namespace {
+
+const int HISTORY_SAMPLES = 60;        // One minute at the default update interval
+const int MAX_CHARTED_DEVICES = 8;     // Hosts can have hundreds of namespaces and dm devices
+
+QString formatRate(double bytesPerSec)
+{
+    const char* units[] = {"B/s", "KB/s", "MB/s", "GB/s"};
+    int unit = 0;
+    while (bytesPerSec >= 1024.0 && unit < 3) {
+        bytesPerSec /= 1024.0;
+        unit++;
+    }
+    return QString("%1 %2").arg(bytesPerSec, 0, 'f', unit == 0 ? 0 : 1).arg(units[unit]);
+}
+
+void setCellText(QTableWidget *table, int row, int column, const QString &text)
+{
+    QTableWidgetItem *item = table->item(row, column);
+    if (!item) {
+        item = new QTableWidgetItem(text);
+        table->setItem(row, column, item);
+    } else if (item->text() != text) {
+        item->setText(text);
+    }
+}
+
+} // namespace
+
+StoragePanel::StoragePanel(QWidget *parent) : QWidget(parent),
+    summaryLabel(nullptr),
+    deviceTable(nullptr),
+    chart(nullptr),
+    chartView(nullptr),
+    axisX(nullptr),
+    axisY(nullptr)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->setSpacing(12);
+
+    QLabel *title = new QLabel("Storage Devices");
+    summaryLabel = new QLabel("Busiest device: -");
+    summaryLabel->setStyleSheet("color:#b0b0b0;font-weight:bold;");
+
+    deviceTable = new QTableWidget();
+    deviceTable->setColumnCount(8);
+    deviceTable->setHorizontalHeaderLabels({"Device", "Read", "Write", "Read IOPS", "Write IOPS",
+                                            "Avg service time", "In flight", "Utilization"});
+    deviceTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    deviceTable->setSelectionMode(QAbstractItemView::NoSelection);
+    deviceTable->verticalHeader()->setVisible(false);
+    deviceTable->horizontalHeader()->setStretchLastSection(true);
+    deviceTable->setMinimumHeight(160);
+    deviceTable->setStyleSheet(R"(
+        QTableWidget {
+            background-color: #232323;
+            color: #ffffff;
+            border: 1px solid #3a3a3a;
+            border-radius: 4px;
+            gridline-color: #3a3a3a;
+        }
+    )");
+
+    chart = new QChart();
+    chart->setTheme(QChart::ChartThemeDark);
+    chart->setBackgroundBrush(QColor("#232323"));
+    chart->setTitle("Device utilization (%)");
+    chart->legend()->setAlignment(Qt::AlignRight);
+    axisX = new QValueAxis();
+    axisX->setLabelFormat("%d");
+    axisX->setTitleText("Seconds ago");
+    axisX->setRange(-HISTORY_SAMPLES + 1, 0);
+    axisY = new QValueAxis();
+    axisY->setRange(0, 100);
+    chart->addAxis(axisX, Qt::AlignBottom);
+    chart->addAxis(axisY, Qt::AlignLeft);
+    for (int i = 0; i < MAX_CHARTED_DEVICES; ++i) {
+        QLineSeries *s = new QLineSeries();
+        chart->addSeries(s);
+        s->attachAxis(axisX);
+        s->attachAxis(axisY);
+        s->setVisible(false);
+        series.append(s);
+    }
+
+    chartView = new QChartView(chart);
+    chartView->setRenderHint(QPainter::Antialiasing);
+    chartView->setMinimumHeight(220);
+
+    layout->addWidget(title);
+    layout->addWidget(summaryLabel);
+    layout->addWidget(chartView);
+    layout->addWidget(deviceTable);
+}
+
+void StoragePanel::updateDevices(const QVector<BlockDeviceStats> &devices, int busiestIndex)
+{
+    updateSummary(devices, busiestIndex);
+    updateTable(devices);
+    updateChart(devices);
+}
+
+void StoragePanel::updateSummary(const QVector<BlockDeviceStats> &devices, int busiestIndex)
+{
+    if (busiestIndex < 0 || busiestIndex >= devices.size()) {
+        summaryLabel->setText("Busiest device: no block device statistics available");
+        return;
+    }
+    const BlockDeviceStats &dev = devices[busiestIndex];
+    summaryLabel->setText(QString("Busiest device: %1 - %2% busy, read %3, write %4, %5 ms avg, %6 in flight")
+        .arg(dev.name)
+        .arg(dev.utilization, 0, 'f', 1)
+        .arg(formatRate(dev.readBytesPerSec))
+        .arg(formatRate(dev.writeBytesPerSec))
+        .arg(dev.avgServiceTimeMs, 0, 'f', 2)
+        .arg(dev.inFlight));
+}
+
+void StoragePanel::updateTable(const QVector<BlockDeviceStats> &devices)
+{
+    if (!isVisible()) {
+        return;
+    }
+    if (deviceTable->rowCount() != devices.size()) {
+        deviceTable->setRowCount(devices.size());
+    }
+    for (int row = 0; row < devices.size(); ++row) {
+        const BlockDeviceStats &dev = devices[row];
+        setCellText(deviceTable, row, 0, dev.name);
+        setCellText(deviceTable, row, 1, formatRate(dev.readBytesPerSec));
+        setCellText(deviceTable, row, 2, formatRate(dev.writeBytesPerSec));
+        setCellText(deviceTable, row, 3, QString::number(dev.readIops, 'f', 0));
+        setCellText(deviceTable, row, 4, QString::number(dev.writeIops, 'f', 0));
+        setCellText(deviceTable, row, 5, QString("%1 ms").arg(dev.avgServiceTimeMs, 0, 'f', 2));
+        setCellText(deviceTable, row, 6, QString::number(dev.inFlight));
+        setCellText(deviceTable, row, 7, QString("%1%").arg(dev.utilization, 0, 'f', 1));
+
+        QTableWidgetItem *utilItem = deviceTable->item(row, 7);
+        if (dev.utilization >= 80.0) {
+            utilItem->setForeground(QColor("#FF4444"));
+        } else if (dev.utilization >= 50.0) {
+            utilItem->setForeground(QColor("#FFA500"));
+        } else {
+            utilItem->setForeground(QColor("#4CAF50"));
+        }
+    }
+}
+
+void StoragePanel::updateChart(const QVector<BlockDeviceStats> &devices)
+{
+    // History is kept even while hidden so the chart is populated when shown
+    QHash<QString, QVector<double>> nextHistory;
+    nextHistory.reserve(devices.size());
+    for (const BlockDeviceStats &dev : devices) {
+        QVector<double> history = utilizationHistory.value(dev.name);
+        history.append(dev.utilization);
+        if (history.size() > HISTORY_SAMPLES) history.removeFirst();
+        nextHistory.insert(dev.name, history);
+    }
+    utilizationHistory.swap(nextHistory);
+
+    if (!isVisible()) {
+        return;
+    }
+
+    // Chart only the most active devices
+    QVector<int> order(devices.size());
+    for (int i = 0; i < order.size(); ++i) order[i] = i;
+    int charted = qMin(MAX_CHARTED_DEVICES, static_cast<int>(order.size()));
+    std::partial_sort(order.begin(), order.begin() + charted, order.end(), [&devices](int a, int b) {
+        double ta = devices[a].utilization + (devices[a].readBytesPerSec + devices[a].writeBytesPerSec) / 1e9;
+        double tb = devices[b].utilization + (devices[b].readBytesPerSec + devices[b].writeBytesPerSec) / 1e9;
+        return ta > tb;
+    });
+    std::sort(order.begin(), order.begin() + charted, [&devices](int a, int b) {
+        return devices[a].name < devices[b].name;  // Keep series colors stable
+    });
+
+    for (int i = 0; i < series.size(); ++i) {
+        QLineSeries *s = series[i];
+        if (i >= charted) {
+            s->setVisible(false);
+            continue;
+        }
+        const BlockDeviceStats &dev = devices[order[i]];
+        const QVector<double> &history = utilizationHistory[dev.name];
+        QList<QPointF> points;
+        points.reserve(history.size());
+        int offset = history.size() - 1;
+        for (int j = 0; j < history.size(); ++j) {
+            points.append(QPointF(j - offset, history[j]));
+        }
+        s->setName(dev.name);
+        s->replace(points);
+        s->setVisible(true);
+    }
+}
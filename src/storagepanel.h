@@ -0,0 +1,42 @@
+#ifndef STORAGEPANEL_H
+#define STORAGEPANEL_H
+
+#include <QWidget>
+#include <QHash>
+#include <QVector>
+#include "diskstatscollector.h"
+
+QT_BEGIN_NAMESPACE
+class QLabel;
+class QTableWidget;
+class QChart;
+class QChartView;
+class QLineSeries;
+class QValueAxis;
+QT_END_NAMESPACE
+
+// Performance view section showing per-block-device I/O statistics
+class StoragePanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit StoragePanel(QWidget *parent = nullptr);
+
+    void updateDevices(const QVector<BlockDeviceStats> &devices, int busiestIndex);
+
+private:
+    QLabel *summaryLabel;
+    QTableWidget *deviceTable;
+    QChart *chart;
+    QChartView *chartView;
+    QValueAxis *axisX;
+    QValueAxis *axisY;
+    QVector<QLineSeries*> series;        // Fixed pool, reused every tick
+    QHash<QString, QVector<double>> utilizationHistory;
+
+    void updateSummary(const QVector<BlockDeviceStats> &devices, int busiestIndex);
+    void updateTable(const QVector<BlockDeviceStats> &devices);
+    void updateChart(const QVector<BlockDeviceStats> &devices);
+};
+
+#endif // STORAGEPANEL_H
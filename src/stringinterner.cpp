@@ -0,0 +1,99 @@
+#include "stringinterner.h"
+#include <QHash>
+#include <cstring>
+
+namespace {
+
+const int CHUNK_CHARS = 32 * 1024;
+
+} // namespace
+
+StringInterner::StringInterner() :
+    chunkUsed(CHUNK_CHARS)
+{
+    strings.append(QString());
+    hashes.append(0);
+    rehash(1024);
+}
+
+StringInterner::~StringInterner()
+{
+    for (QChar *chunk : chunks) {
+        delete[] chunk;
+    }
+}
+
+const QChar *StringInterner::store(QStringView text)
+{
+    const qsizetype length = text.size();
+    if (length > CHUNK_CHARS / 4) {
+        // Long strings get a chunk of their own instead of wasting the tail of one
+        QChar *chunk = new QChar[length];
+        std::memcpy(chunk, text.data(), length * sizeof(QChar));
+        chunks.prepend(chunk);
+        return chunk;
+    }
+    if (chunkUsed + length > CHUNK_CHARS) {
+        chunks.append(new QChar[CHUNK_CHARS]);
+        chunkUsed = 0;
+    }
+    QChar *target = chunks.last() + chunkUsed;
+    std::memcpy(target, text.data(), length * sizeof(QChar));
+    chunkUsed += int(length);
+    return target;
+}
+
+StringInterner::Id StringInterner::intern(QStringView text)
+{
+    if (text.isEmpty()) {
+        return 0;
+    }
+    const size_t hash = qHash(text);
+    const int mask = table.size() - 1;
+    for (int bucket = int(hash) & mask;; bucket = (bucket + 1) & mask) {
+        Id id = table[bucket];
+        if (id == 0) {
+            break;
+        }
+        if (hashes[int(id)] == hash && strings[int(id)] == text) {
+            return id;
+        }
+    }
+
+    Id id = Id(strings.size());
+    strings.append(QString::fromRawData(store(text), text.size()));
+    hashes.append(hash);
+    // Keep the load factor under one half
+    if (strings.size() * 2 > table.size()) {
+        rehash(table.size() * 2);
+    } else {
+        int bucket = int(hash) & mask;
+        while (table[bucket] != 0) {
+            bucket = (bucket + 1) & mask;
+        }
+        table[bucket] = id;
+    }
+    return id;
+}
+
+void StringInterner::rehash(int buckets)
+{
+    table.fill(0, buckets);
+    const int mask = buckets - 1;
+    for (int id = 1; id < strings.size(); ++id) {
+        int bucket = int(hashes[id]) & mask;
+        while (table[bucket] != 0) {
+            bucket = (bucket + 1) & mask;
+        }
+        table[bucket] = Id(id);
+    }
+}
+
+qint64 StringInterner::memoryBytes() const
+{
+    qint64 bytes = qint64(table.size()) * sizeof(Id) + qint64(strings.size()) * (sizeof(QString) + sizeof(size_t));
+    for (const QString &text : strings) {
+        bytes += text.size() * qint64(sizeof(QChar));
+    }
+    return bytes;
+}
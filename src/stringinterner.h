@@ -0,0 +1,41 @@
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+// Append-only table of distinct strings. Characters are copied once into
+// fixed-size chunks that never move, and each string is handed out as a
+// QString over that storage, so copies made from it share the characters
+// without allocating. Equal strings get equal ids, so comparing ids is
+// comparing text. Ids stay valid for the interner's lifetime; id 0 is the
+// empty string.
+class StringInterner {
+public:
+    using Id = quint32;
+
+    StringInterner();
+    ~StringInterner();
+    StringInterner(const StringInterner &) = delete;
+    StringInterner &operator=(const StringInterner &) = delete;
+
+    // Allocates only the first time a string is seen
+    Id intern(QStringView text);
+    const QString& string(Id id) const { return strings[int(id)]; }
+    int size() const { return strings.size(); }
+    qint64 memoryBytes() const;
+
+private:
+    const QChar *store(QStringView text);
+    void rehash(int buckets);
+
+    QVector<QChar *> chunks;
+    int chunkUsed;
+    QVector<QString> strings;
+    QVector<size_t> hashes;
+    // Open addressing over ids; 0 marks an empty bucket
+    QVector<Id> table;
+};
+
+#endif // STRINGINTERNER_H
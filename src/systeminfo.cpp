@@ -1,16 +1,87 @@
 #include "systeminfo.h"
 #include "processcategorizer.h"
+#include "processaffinity.h"
+#include "columnkernels.h"
+#include "processownership.h"
 #include <QDebug>
 #include <QDateTime>
 #include <QTimer>
+#include <QStandardPaths>
+#include <QCoreApplication>
+#ifdef Q_OS_WIN
 #include <tlhelp32.h>
 #include <psapi.h>
 #include <pdh.h>
 #pragma comment(lib, "pdh.lib")
-
+#else
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_WIN
 static PDH_HQUERY g_hQuery = NULL;
 static PDH_HCOUNTER g_hCounter = NULL;
 
+// Priority classes, see setProcessPriority
+static const int BACKGROUND_PRIORITY = BELOW_NORMAL_PRIORITY_CLASS;
+static const int DEFAULT_PRIORITY = NORMAL_PRIORITY_CLASS;
+#else
+// Nice values, see setProcessPriority
+static const int BACKGROUND_PRIORITY = 10;
+static const int DEFAULT_PRIORITY = 0;
+
+// Reads a small /proc file into buffer, NUL-terminated; the length or -1
+static ssize_t readProcFile(const char *path, char *buffer, size_t size)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t length = read(fd, buffer, size - 1);
+    close(fd);
+    if (length < 0) {
+        return -1;
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+// Interns UTF-8 from /proc; the usual all-ASCII text is widened on the stack
+static StringInterner::Id internUtf8(StringInterner &strings, const char *text, int length)
+{
+    QChar wide[1024];
+    if (length <= int(sizeof(wide) / sizeof(wide[0]))) {
+        int index = 0;
+        while (index < length && static_cast<unsigned char>(text[index]) < 0x80) {
+            wide[index] = QLatin1Char(text[index]);
+            ++index;
+        }
+        if (index == length) {
+            return strings.intern(QStringView(wide, length));
+        }
+    }
+    return strings.intern(QString::fromUtf8(text, length));
+}
+#endif
+
+QString processStatusText(ProcessStatus status)
+{
+    // Literals are stored statically, so this does not allocate
+    switch (status) {
+    case ProcessStatus::Running: return QStringLiteral("Running");
+    case ProcessStatus::NotResponding: return QStringLiteral("Not Responding");
+    case ProcessStatus::Unknown: break;
+    }
+    return QString();
+}
+
 SystemInfo::SystemInfo(QObject *parent) : QObject(parent),
     cpuUsage(0.0),
     memoryUsage(0.0),
@@ -18,20 +89,30 @@ SystemInfo::SystemInfo(QObject *parent) : QObject(parent),
     networkUsage(0.0),
     numProcessors(1),
     lastSystemTime(0),
+    snapshotVersion(0),
+    processGrouping(strings),
+    selectedPid(-1),
+    totalMemoryKb(0),
+    availableMemoryKb(0),
     lastBytesReceived(0.0),
     lastBytesSent(0.0),
     lastNetworkUpdateTime(0),
+#ifdef Q_OS_WIN
     cpuQuery(NULL),
     cpuCounter(NULL),
     networkQuery(NULL),
     bytesReceivedCounter(NULL),
     bytesSentCounter(NULL),
+#else
+    ticksPerSecond(100.0),
+#endif
     efficiencyModeEnabled(false)
 {
     updateTimer = new QTimer(this);
     connect(updateTimer, &QTimer::timeout, this, &SystemInfo::updateSystemInfo);
     updateTimer->start(1000);
 
+#ifdef Q_OS_WIN
     SYSTEM_INFO sysInfo;
     GetSystemInfo(&sysInfo);
     numProcessors = sysInfo.dwNumberOfProcessors;
@@ -47,13 +128,47 @@ SystemInfo::SystemInfo(QObject *parent) : QObject(parent),
     } else {
         qWarning() << "Failed to get initial system times";
     }
-
+#else
+    numProcessors = qMax(1, int(sysconf(_SC_NPROCESSORS_ONLN)));
+    ticksPerSecond = static_cast<double>(sysconf(_SC_CLK_TCK));
+#endif
+
+    // PSI triggers catch stalls shorter than the update interval. Windows of
+    // 2 s are the smallest unprivileged users may arm.
+    pressure = new PressureCollector(this);
+    connect(pressure, &PressureCollector::stallDetected, this, &SystemInfo::pressureStallDetected);
+    pressure->addTrigger(PressureResource::Memory, false, 150000, 2000000);
+    pressure->addTrigger(PressureResource::Io, false, 300000, 2000000);
+    pressure->addTrigger(PressureResource::Cpu, false, 1000000, 2000000);
+    efficiencyController.setActuators([this](qint64 pid) { return throttleProcess(pid); },
+                                      [this](qint64 pid) { return releaseProcess(pid); });
+
+    // Stalls go to the alert stream as system-wide alerts
+    connect(pressure, &PressureCollector::stallDetected, this, [this](PressureResource resource, const QString &description) {
+        HealthAlert alert;
+        alert.timestamp = QDateTime::currentMSecsSinceEpoch();
+        alert.rule = QString("%1 pressure stall").arg(PressureCollector::resourceName(resource));
+        alert.severity = resource == PressureResource::Cpu ? "Medium" : "High";
+        alert.processName = "System";
+        alert.detail = description;
+        alert.recommendation = "Tasks were stalled waiting for this resource. See the Performance view.";
+        healthRules.addAlert(alert);
+    });
+
+    // Rules can be overridden with a JSON file next to the other settings
+    healthRules.loadRules(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/healthrules.json");
+
+#ifdef Q_OS_WIN
     initCpuCounter();
     initNetworkCounter();
+#endif
     updateSystemInfo();
 }
 
 SystemInfo::~SystemInfo() {
+    // Never leave processes confined after we exit
+    budgetManager.releaseAll();
+#ifdef Q_OS_WIN
     if (g_hQuery != NULL) {
         PdhCloseQuery(g_hQuery);
         g_hQuery = NULL;
@@ -61,6 +176,7 @@ SystemInfo::~SystemInfo() {
     }
     PdhCloseQuery(cpuQuery);
     PdhCloseQuery(networkQuery);
+#endif
 }
 
 
@@ -85,15 +201,56 @@ double SystemInfo::getProcessCpuUsage(qint64 pid) const {
 
 void SystemInfo::updateSystemInfo() {
     updateProcessList();
+    memoryDetail.update(processList);
+    pressure->update();
     updateProcessCpuUsage();
     updateCpuUsage();
     updateMemoryUsage();
     updateDiskUsage();
+    updateProcessAffinity();
+    updateProcessScheduling();
+    updateProcessOwnership();
+    processColumns.assign(processList);
     updateNetworkUsage();
+    processHistory.update(processColumns, QDateTime::currentMSecsSinceEpoch());
+    processSparklines.update(processColumns);
+    processGrouping.update(processColumns);
+    memoryTrend.update(processColumns, processList, double(availableMemoryKb));
+    cpuAnomaly.update(processColumns, processList);
+    if (efficiencyController.isEnabled()) {
+        const qint64 ownPid = QCoreApplication::applicationPid();
+        efficiencyEligible.resize(processList.size());
+        for (int row = 0; row < processList.size(); ++row) {
+            const ProcessInfo &process = processList[row];
+            efficiencyEligible[row] = process.pid != ownPid && !isProcessEssential(process);
+        }
+    }
+    efficiencyController.update(processColumns, efficiencyEligible);
+    for (int row : memoryTrend.newlySuspected()) {
+        const ProcessInfo &process = processList[row];
+        HealthAlert alert;
+        alert.timestamp = QDateTime::currentMSecsSinceEpoch();
+        alert.rule = "Steady Memory Growth";
+        alert.severity = "High";
+        alert.pid = process.pid;
+        alert.processName = process.name;
+        alert.value = process.memoryGrowthMBPerHour;
+        alert.detail = QString("+%1 MB/h").arg(process.memoryGrowthMBPerHour, 0, 'f', 0);
+        alert.recommendation = "Memory has grown steadily for the last half hour. Check for a leak.";
+        healthRules.addAlert(alert);
+    }
+    healthRules.evaluate(processColumns);
+    ++snapshotVersion;
     emit dataUpdated();
 }
 
+PressureStats SystemInfo::getProcessPressure(qint64 pid, PressureResource resource) const
+{
+    return PressureCollector::cgroupPressure(PressureCollector::cgroupOfProcess(pid), resource);
+}
+
 void SystemInfo::updateProcessCpuUsage() {
+#ifdef Q_OS_WIN
     FILETIME idleTime, kernelTime, userTime;
     if (!GetSystemTimes(&idleTime, &kernelTime, &userTime)) return;
     ULARGE_INTEGER k, u;
@@ -148,33 +305,70 @@ void SystemInfo::updateProcessCpuUsage() {
         CloseHandle(hProcess);
     }
     lastSystemTime = currentSystemTime;
+#else
+    // Computed in updateProcessList from the same read of /proc/[pid]/stat
+#endif
 }
 
 void SystemInfo::updateCpuUsage() {
+    if (cpuStats.update()) {
+        // Per-core counters from /proc/stat, the aggregate line gives system CPU
+        cpuUsage = cpuStats.totalBusy();
+        return;
+    }
+    cpuUsage = 0.0;
+#ifdef Q_OS_WIN
     if (g_hQuery && g_hCounter) {
         PDH_FMT_COUNTERVALUE counterVal;
         PdhCollectQueryData(g_hQuery);
         PdhGetFormattedCounterValue(g_hCounter, PDH_FMT_DOUBLE, nullptr, &counterVal);
         cpuUsage = counterVal.doubleValue;
         qDebug() << "System CPU usage (PDH):" << cpuUsage;
-    } else {
-        cpuUsage = 0.0;
     }
+#endif
 }
 
 void SystemInfo::updateMemoryUsage() {
+#ifdef Q_OS_WIN
     MEMORYSTATUSEX memInfo;
     memInfo.dwLength = sizeof(MEMORYSTATUSEX);
     GlobalMemoryStatusEx(&memInfo);
     memoryUsage = memInfo.dwMemoryLoad;
+    totalMemoryKb = memInfo.ullTotalPhys / 1024;
+    availableMemoryKb = memInfo.ullAvailPhys / 1024;
+#else
+    char buffer[4096];
+    if (readProcFile("/proc/meminfo", buffer, sizeof(buffer)) <= 0) {
+        return;
+    }
+    // "MemTotal:  16314372 kB" and so on, MemAvailable counts reclaimable cache
+    for (char *line = buffer; line && *line; ) {
+        char *next = std::strchr(line, '\n');
+        if (std::strncmp(line, "MemTotal:", 9) == 0) {
+            totalMemoryKb = std::strtoll(line + 9, nullptr, 10);
+        } else if (std::strncmp(line, "MemAvailable:", 13) == 0) {
+            availableMemoryKb = std::strtoll(line + 13, nullptr, 10);
+        }
+        line = next ? next + 1 : nullptr;
+    }
+    memoryUsage = totalMemoryKb > 0 ? 100.0 * (totalMemoryKb - availableMemoryKb) / totalMemoryKb : 0.0;
+#endif
 }
 
 void SystemInfo::updateDiskUsage() {
-    ULARGE_INTEGER freeBytesAvailable, totalBytes, totalFreeBytes;
-    if (GetDiskFreeSpaceExW(L"C:\\", &freeBytesAvailable, &totalBytes, &totalFreeBytes)) {
-        double totalSpace = static_cast<double>(totalBytes.QuadPart);
-        double freeSpace = static_cast<double>(totalFreeBytes.QuadPart);
-        diskUsage = ((totalSpace - freeSpace) / totalSpace) * 100.0;
+    if (diskStats.update()) {
+        // Report how busy the most saturated device is rather than free space
+        int busiest = diskStats.busiestDeviceIndex();
+        diskUsage = busiest >= 0 ? diskStats.devices()[busiest].utilization : 0.0;
+    } else {
+#ifdef Q_OS_WIN
+        ULARGE_INTEGER freeBytesAvailable, totalBytes, totalFreeBytes;
+        if (GetDiskFreeSpaceExW(L"C:\\", &freeBytesAvailable, &totalBytes, &totalFreeBytes)) {
+            double totalSpace = static_cast<double>(totalBytes.QuadPart);
+            double freeSpace = static_cast<double>(totalFreeBytes.QuadPart);
+            diskUsage = ((totalSpace - freeSpace) / totalSpace) * 100.0;
+        }
+#endif
     }
 
     // Rolling average for Disk usage
@@ -190,6 +384,7 @@ void SystemInfo::updateDiskUsage() {
 
 void SystemInfo::updateNetworkUsage()
 {
+#ifdef Q_OS_WIN
     if (networkQuery && bytesReceivedCounter && bytesSentCounter) {
         PDH_FMT_COUNTERVALUE receivedVal, sentVal;
         PDH_STATUS status = PdhCollectQueryData(networkQuery);
@@ -232,15 +427,18 @@ void SystemInfo::updateNetworkUsage()
     } else {
         networkUsage = 0.0;
     }
-
-    // Sum per-process network usage for total
-    double totalProcessNetwork = 0.0;
-    for (const ProcessInfo &proc : processList) {
-        totalProcessNetwork += proc.networkUsage;
-    }
-    networkUsage = totalProcessNetwork;
+#endif
+
+    // Sum per-process network usage for total, as one group over the column
+    const int rows = processColumns.rows;
+    totalGroup.fill(0, rows);
+    columnkernels::GroupTotals total;
+    columnkernels::groupTotals(processColumns.column(ProcessColumns::NetworkMBps), totalGroup.constData(),
+                               nullptr, rows, 1, &total);
+    networkUsage = total.sum;
 }
 
+#ifdef Q_OS_WIN
 bool SystemInfo::enableDebugPrivilege()
 {
     HANDLE hToken;
@@ -632,6 +830,64 @@ bool SystemInfo::killProcessTree(qint64 pid)
     CloseHandle(hProcess);
     return terminated;
 }
+#else
+QVector<qint64> SystemInfo::getChildProcesses(qint64 parentPid) const
+{
+    QVector<qint64> childPids;
+    for (const ProcessInfo &proc : processList) {
+        if (proc.parentPid == parentPid) {
+            childPids.append(proc.pid);
+        }
+    }
+    return childPids;
+}
+
+bool SystemInfo::isProcessRunning(qint64 pid) const
+{
+    // EPERM: it exists but belongs to someone else
+    return ::kill(pid_t(pid), 0) == 0 || errno == EPERM;
+}
+
+bool SystemInfo::hasProcessAccess(qint64 pid) const
+{
+    return ::kill(pid_t(pid), 0) == 0;
+}
+
+bool SystemInfo::terminateProcess(qint64 pid)
+{
+    const qint64 startTime = getProcessStartTime(pid);
+    if (::kill(pid_t(pid), SIGTERM) != 0) {
+        qWarning() << "Failed to terminate process" << pid << ":" << std::strerror(errno);
+        return false;
+    }
+    // Give it a second to clean up before it is killed outright, without
+    // blocking the event loop meanwhile; the next snapshot drops it either way
+    QTimer::singleShot(1000, this, [this, pid, startTime]() {
+        if (startTime != 0 && isSameProcess(pid, startTime)) {
+            forceTerminateProcess(pid);
+        }
+    });
+    return true;
+}
+
+bool SystemInfo::forceTerminateProcess(qint64 pid)
+{
+    if (::kill(pid_t(pid), SIGKILL) != 0) {
+        qWarning() << "Failed to kill process" << pid << ":" << std::strerror(errno);
+        return false;
+    }
+    removeProcessFromList(pid);
+    return true;
+}
+
+bool SystemInfo::killProcessTree(qint64 pid)
+{
+    for (qint64 childPid : getChildProcesses(pid)) {
+        killProcessTree(childPid);
+    }
+    return ::kill(pid_t(pid), SIGKILL) == 0;
+}
+#endif
 
 void SystemInfo::setUpdateInterval(int milliseconds)
 {
@@ -640,6 +896,7 @@ void SystemInfo::setUpdateInterval(int milliseconds)
     }
 }
 
+#ifdef Q_OS_WIN
 void SystemInfo::initCpuCounter() {
     if (g_hQuery == NULL) {
         PDH_STATUS status = PdhOpenQuery(NULL, 0, &g_hQuery);
@@ -665,6 +922,136 @@ bool SystemInfo::setProcessPriority(qint64 pid, int priority)
     CloseHandle(hProcess);
     return success;
 }
+#else
+bool SystemInfo::setProcessPriority(qint64 pid, int priority)
+{
+    // The nice value is part of the cached scheduling
+    schedulingCache.remove(pid);
+    return setpriority(PRIO_PROCESS, id_t(pid), priority) == 0;
+}
+#endif
+
+bool SystemInfo::setProcessAffinity(qint64 pid, const QVector<int> &cpus, bool includeDescendants, QString *error)
+{
+    bool success = ProcessAffinity::set(pid, cpus, includeDescendants, error);
+    // Descendants may have changed too
+    affinityCache.clear();
+    updateProcessAffinity();
+    return success;
+}
+
+bool SystemInfo::setProcessScheduling(const QVector<qint64> &pids, const SchedulingInfo &info)
+{
+    bool success = true;
+    for (qint64 pid : pids) {
+        if (!ProcessScheduling::apply(pid, info)) {
+            qWarning() << "Failed to change scheduling of process" << pid;
+            success = false;
+        }
+        schedulingCache.remove(pid);
+    }
+    updateProcessScheduling();
+    return success;
+}
+
+void SystemInfo::updateProcessScheduling()
+{
+    if (!ProcessScheduling::isSupported()) {
+        return;
+    }
+    // Three syscalls per process add up on every tick, so like affinity
+    // scheduling is read once per process; our own changes drop the entry
+    // and the selected process is always read
+    QHash<qint64, CachedScheduling> cache;
+    cache.reserve(processList.size());
+    for (ProcessInfo &proc : processList) {
+        auto cached = schedulingCache.constFind(proc.pid);
+        if (cached != schedulingCache.constEnd() && cached->startTime == proc.startTime && proc.pid != selectedPid) {
+            proc.scheduling = cached->scheduling;
+        } else {
+            proc.scheduling = ProcessScheduling::get(proc.pid);
+        }
+        cache.insert(proc.pid, CachedScheduling{proc.startTime, proc.scheduling});
+    }
+    schedulingCache.swap(cache);
+}
+
+void SystemInfo::updateProcessOwnership()
+{
+    // Read once per process: owner, cgroup and type rarely change after
+    // start, and reading them for every process on every tick would not scale
+    QHash<qint64, ProcessOwner> owners;
+    owners.reserve(processList.size());
+    for (ProcessInfo &proc : processList) {
+        ProcessOwner owner;
+        auto cached = ownerCache.constFind(proc.pid);
+        if (cached != ownerCache.constEnd() && cached->startTime == proc.startTime) {
+            owner = *cached;
+        } else {
+            owner.startTime = proc.startTime;
+            if (ProcessOwnership::hasUsers()) {
+#ifdef Q_OS_WIN
+                // Looking a SID up may ask a domain controller: once per account
+                const QByteArray sid = ProcessOwnership::userSidOf(proc.pid);
+                auto name = sidNames.constFind(sid);
+                if (name == sidNames.constEnd()) {
+                    name = sidNames.insert(sid, strings.intern(ProcessOwnership::userNameOfSid(sid)));
+                }
+#else
+                const qint64 uid = ProcessOwnership::userOf(proc.pid);
+                auto name = userNames.constFind(uid);
+                if (name == userNames.constEnd()) {
+                    name = userNames.insert(uid, strings.intern(ProcessOwnership::userName(uid)));
+                }
+#endif
+                owner.userId = *name;
+            }
+            // One read of the cgroup serves the container and the type
+            const QString cgroup = ProcessOwnership::hasContainers() ? PressureCollector::cgroupOfProcess(proc.pid) : QString();
+            if (ProcessOwnership::hasContainers()) {
+                owner.containerId = strings.intern(ProcessOwnership::containerOf(cgroup));
+            }
+            owner.type = ProcessCategorizer::getInstance().categorizeProcess(proc.name, proc.path, proc.pid, cgroup).type;
+#ifdef Q_OS_LINUX
+            if (proc.pid == 2 || proc.parentPid == 2) {
+                owner.type = ProcessType::System;    // kthreadd and the kernel threads it starts
+            }
+#endif
+        }
+        proc.type = owner.type;
+        proc.userId = owner.userId;
+        proc.user = strings.string(owner.userId);
+        proc.containerId = owner.containerId;
+        proc.container = strings.string(owner.containerId);
+        owners.insert(proc.pid, owner);
+    }
+    ownerCache.swap(owners);
+}
+
+void SystemInfo::updateProcessAffinity()
+{
+    if (!ProcessAffinity::isSupported() || !cpuTopology.isAvailable()) {
+        return;
+    }
+    const int onlineCpus = cpuTopology.cpus().size();
+    // Affinity rarely changes after start, so it is read once per process;
+    // our own changes clear the cache and the selected process is always
+    // read, which picks up changes made by other tools where they matter
+    QHash<qint64, CachedAffinity> cache;
+    cache.reserve(processList.size());
+    for (ProcessInfo &proc : processList) {
+        auto cached = affinityCache.constFind(proc.pid);
+        if (cached != affinityCache.constEnd() && cached->startTime == proc.startTime && proc.pid != selectedPid) {
+            proc.affinity = cached->affinity;
+        } else {
+            QVector<int> cpus = ProcessAffinity::get(proc.pid);
+            // Only restricted processes get a formatted list
+            proc.affinity = (cpus.isEmpty() || cpus.size() >= onlineCpus) ? QString() : CpuTopology::formatCpuList(cpus);
+        }
+        cache.insert(proc.pid, CachedAffinity{proc.startTime, proc.affinity});
+    }
+    affinityCache.swap(cache);
+}
 
 bool SystemInfo::optimizeBackgroundProcesses()
 {
@@ -673,10 +1060,10 @@ bool SystemInfo::optimizeBackgroundProcesses()
         if (proc.type == ProcessType::Background && !isProcessEssential(proc)) {
             // Store original priority if not already stored
             if (!originalPriorities.contains(proc.pid)) {
-                originalPriorities[proc.pid] = getProcessPriorityClass(proc.pid);
+                originalPriorities[proc.pid] = OriginalPriority{getProcessPriorityClass(proc.pid), proc.startTime};
             }
             // Set background processes to below normal priority
-            if (!setProcessPriority(proc.pid, BELOW_NORMAL_PRIORITY_CLASS)) {
+            if (!setProcessPriority(proc.pid, BACKGROUND_PRIORITY)) {
                 success = false;
             }
         }
@@ -686,6 +1073,10 @@ bool SystemInfo::optimizeBackgroundProcesses()
 
 bool SystemInfo::optimizeMemoryUsage()
 {
+#ifndef Q_OS_WIN
+    // There are no working set limits without a cgroup; see CgroupBudgetManager
+    return false;
+#else
     bool success = true;
     for (const ProcessInfo &proc : processList) {
         if (!isProcessEssential(proc) && proc.memoryUsage > 100 * 1024) { // More than 100MB
@@ -702,6 +1093,7 @@ bool SystemInfo::optimizeMemoryUsage()
         }
     }
     return success;
+#endif
 }
 
 bool SystemInfo::throttleNonEssentialProcesses()
@@ -711,13 +1103,13 @@ bool SystemInfo::throttleNonEssentialProcesses()
         if (!isProcessEssential(proc) && proc.cpuUsage > 5.0) { // CPU usage > 5%
             // Store original priority if not already stored
             if (!originalPriorities.contains(proc.pid)) {
-                originalPriorities[proc.pid] = getProcessPriorityClass(proc.pid);
+                originalPriorities[proc.pid] = OriginalPriority{getProcessPriorityClass(proc.pid), proc.startTime};
             }
             // Throttle CPU usage by setting to below normal priority
-            if (!setProcessPriority(proc.pid, BELOW_NORMAL_PRIORITY_CLASS)) {
+            if (!setProcessPriority(proc.pid, BACKGROUND_PRIORITY)) {
                 success = false;
             } else {
-                throttledProcesses.append(proc.pid);
+                throttledProcesses.insert(proc.pid);
             }
         }
     }
@@ -726,11 +1118,22 @@ bool SystemInfo::throttleNonEssentialProcesses()
 
 QVector<ProcessInfo> SystemInfo::getHighResourceProcesses() const
 {
+    // CPU > 10% or Memory > 200MB, heaviest CPU first. Rows of processColumns
+    // follow processList, so only the selected processes are copied.
+    const int rows = qMin(processColumns.rows, int(processList.size()));
+    const double *cpu = processColumns.column(ProcessColumns::Cpu);
+    const double *memory = processColumns.column(ProcessColumns::MemoryKb);
+    QVector<quint8> selected(rows);
+    for (int row = 0; row < rows; ++row) {
+        selected[row] = cpu[row] > 10.0 || memory[row] > 200.0 * 1024.0;
+    }
+    QVector<int> order(rows);
+    order.resize(columnkernels::topK(cpu, selected.constData(), rows, rows, order.data()));
+
     QVector<ProcessInfo> highResourceProcesses;
-    for (const ProcessInfo &proc : processList) {
-        if (proc.cpuUsage > 10.0 || proc.memoryUsage > 200 * 1024) { // CPU > 10% or Memory > 200MB
-            highResourceProcesses.append(proc);
-        }
+    highResourceProcesses.reserve(order.size());
+    for (int row : order) {
+        highResourceProcesses.append(processList[row]);
     }
     return highResourceProcesses;
 }
@@ -743,12 +1146,6 @@ void SystemInfo::setEfficiencyMode(bool enabled)
 
     efficiencyModeEnabled = enabled;
     if (enabled) {
-        // Store original priorities before applying changes
-        for (const ProcessInfo &proc : processList) {
-            if (!originalPriorities.contains(proc.pid)) {
-                originalPriorities[proc.pid] = getProcessPriorityClass(proc.pid);
-            }
-        }
         applyEfficiencyModeSettings();
     } else {
         removeEfficiencyModeSettings();
@@ -758,32 +1155,128 @@ void SystemInfo::setEfficiencyMode(bool enabled)
 
 void SystemInfo::applyEfficiencyModeSettings()
 {
-    optimizeBackgroundProcesses();
-    optimizeMemoryUsage();
-    throttleNonEssentialProcesses();
+    // The controller throttles and releases processes on every update
+    efficiencyController.setEnabled(true);
 }
 
 void SystemInfo::removeEfficiencyModeSettings()
 {
+    efficiencyController.setEnabled(false);
+    budgetManager.releaseAll();
     restoreOriginalPriorities();
     throttledProcesses.clear();
+    schedulingCache.clear();
+}
+
+bool SystemInfo::throttleProcess(qint64 pid)
+{
+    schedulingCache.remove(pid);
+    bool success = false;
+    if (budgetManager.isSupported()) {
+        // Real CPU and memory budgets where the platform supports them
+        success = budgetManager.confine(pid);
+    } else {
+        if (!originalPriorities.contains(pid)) {
+            originalPriorities[pid] = OriginalPriority{getProcessPriorityClass(pid), getProcessStartTime(pid)};
+        }
+        success = setProcessPriority(pid, BACKGROUND_PRIORITY);
+        if (!success) {
+            originalPriorities.remove(pid);
+        }
+    }
+    if (success) {
+        throttledProcesses.insert(pid);
+    }
+    return success;
+}
+
+bool SystemInfo::releaseProcess(qint64 pid)
+{
+    throttledProcesses.remove(pid);
+    schedulingCache.remove(pid);
+    if (budgetManager.isSupported()) {
+        return budgetManager.release(pid);
+    }
+    auto it = originalPriorities.find(pid);
+    if (it == originalPriorities.end()) {
+        return false;
+    }
+    bool success = restorePriority(pid, it.value());
+    originalPriorities.erase(it);
+    return success;
+}
+
+bool SystemInfo::restorePriority(qint64 pid, const OriginalPriority &original)
+{
+    if (getProcessStartTime(pid) != original.startTime) {
+        // Exited; the pid may already belong to another process
+        return true;
+    }
+    return setProcessPriority(pid, original.priority);
 }
 
 void SystemInfo::restoreOriginalPriorities()
 {
     for (auto it = originalPriorities.begin(); it != originalPriorities.end(); ++it) {
-        setProcessPriority(it.key(), it.value());
+        restorePriority(it.key(), it.value());
     }
     originalPriorities.clear();
 }
 
+qint64 SystemInfo::getProcessStartTime(qint64 pid) const
+{
+    // In the units of ProcessInfo::startTime
+#ifdef Q_OS_WIN
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (hProcess == NULL) {
+        return 0;
+    }
+    qint64 startTime = 0;
+    FILETIME createTime, exitTime, kernelTime, userTime;
+    if (GetProcessTimes(hProcess, &createTime, &exitTime, &kernelTime, &userTime)) {
+        ULARGE_INTEGER createTimeUL;
+        createTimeUL.LowPart = createTime.dwLowDateTime;
+        createTimeUL.HighPart = createTime.dwHighDateTime;
+        startTime = createTimeUL.QuadPart;
+    }
+    CloseHandle(hProcess);
+    return startTime;
+#else
+    char path[64];
+    char buffer[1024];
+    std::snprintf(path, sizeof(path), "/proc/%lld/stat", static_cast<long long>(pid));
+    if (readProcFile(path, buffer, sizeof(buffer)) <= 0) {
+        return 0;
+    }
+    // starttime is field 22; fields resume after the last ')' of the name
+    const char *p = std::strrchr(buffer, ')');
+    if (!p) {
+        return 0;
+    }
+    p += 2;
+    for (int field = 3; field < 22 && *p; ++field) {
+        p = std::strchr(p, ' ');
+        if (!p) {
+            return 0;
+        }
+        ++p;
+    }
+    return std::strtoll(p, nullptr, 10);
+#endif
+}
+
 bool SystemInfo::isProcessEssential(const ProcessInfo& process) const
 {
     // List of essential system processes that should not be modified
     static const QStringList essentialProcesses = {
+#ifdef Q_OS_WIN
         "System", "Registry", "smss.exe", "csrss.exe", "wininit.exe",
         "services.exe", "lsass.exe", "svchost.exe", "explorer.exe",
         "Taskmgr.exe", "ProcManager.exe"  // Our own process
+#else
+        "systemd", "init", "dbus-daemon", "dbus-broker", "Xorg", "Xwayland",
+        "gnome-shell", "kwin_wayland", "kwin_x11", "TaskManager"  // Our own process
+#endif
     };
 
     return process.type == ProcessType::System ||
@@ -792,14 +1285,21 @@ bool SystemInfo::isProcessEssential(const ProcessInfo& process) const
 
 int SystemInfo::getProcessPriorityClass(qint64 pid) const
 {
+#ifdef Q_OS_WIN
     HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, static_cast<DWORD>(pid));
     if (hProcess == NULL) {
-        return NORMAL_PRIORITY_CLASS;
+        return DEFAULT_PRIORITY;
     }
 
     DWORD priority = GetPriorityClass(hProcess);
     CloseHandle(hProcess);
-    return priority ? priority : NORMAL_PRIORITY_CLASS;
+    return priority ? priority : DEFAULT_PRIORITY;
+#else
+    // -1 is a valid nice value, so errors show only in errno
+    errno = 0;
+    int nice = getpriority(PRIO_PROCESS, id_t(pid));
+    return errno == 0 ? nice : DEFAULT_PRIORITY;
+#endif
 }
 
 void SystemInfo::removeProcessFromList(qint64 pid)
@@ -815,12 +1315,14 @@ void SystemInfo::removeProcessFromList(qint64 pid)
     // Clean up associated data
     processCpuTimesMap.remove(pid);
     originalPriorities.remove(pid);
-    throttledProcesses.removeAll(pid);
+    budgetManager.release(pid);
+    throttledProcesses.remove(pid);
     
     // Force an immediate update
     QMetaObject::invokeMethod(this, "updateSystemInfo", Qt::QueuedConnection);
 }
 
+#ifdef Q_OS_WIN
 void SystemInfo::updateProcessList()
 {
     HANDLE hSnap = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
@@ -839,7 +1341,10 @@ void SystemInfo::updateProcessList()
         do {
             ProcessInfo proc;
             proc.pid = pe32.th32ProcessID;
-            proc.name = QString::fromWCharArray(pe32.szExeFile);
+            proc.parentPid = pe32.th32ParentProcessID;
+            // Interned: after the first tick, names cost a hash lookup and no allocation
+            proc.nameId = strings.intern(QStringView(pe32.szExeFile, qsizetype(wcslen(pe32.szExeFile))));
+            proc.name = strings.string(proc.nameId);
             
             // Get process handle for additional information
             HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, FALSE, pe32.th32ProcessID);
@@ -847,7 +1352,8 @@ void SystemInfo::updateProcessList()
                 // Get process path
                 WCHAR path[MAX_PATH];
                 if (GetModuleFileNameExW(hProcess, NULL, path, MAX_PATH)) {
-                    proc.path = QString::fromWCharArray(path);
+                    proc.pathId = strings.intern(QStringView(path, qsizetype(wcslen(path))));
+                    proc.path = strings.string(proc.pathId);
                 }
 
                 // Get process memory usage
@@ -868,7 +1374,7 @@ void SystemInfo::updateProcessList()
                 // Determine process status
                 DWORD exitCode;
                 if (GetExitCodeProcess(hProcess, &exitCode)) {
-                    proc.status = (exitCode == STILL_ACTIVE) ? "Running" : "Not Responding";
+                    proc.status = (exitCode == STILL_ACTIVE) ? ProcessStatus::Running : ProcessStatus::NotResponding;
                 }
 
                 // Get disk I/O information
@@ -924,12 +1430,6 @@ void SystemInfo::updateProcessList()
                 for (double v : proc.networkUsageHistory) netSum += v;
                 proc.networkUsage = netSum / proc.networkUsageHistory.size();
 
-                // Categorize process type
-                ProcessCategory category = ProcessCategorizer::getInstance().categorizeProcess(proc.name, static_cast<DWORD>(proc.pid));
-                proc.type = category.type;
-                proc.typeDescription = ProcessCategorizer::getInstance().getProcessDescription(category.type);
-                proc.style = ProcessCategorizer::getInstance().getProcessStyle(category.type);
-
                 CloseHandle(hProcess);
             }
 
@@ -941,7 +1441,138 @@ void SystemInfo::updateProcessList()
 
     CloseHandle(hSnap);
 }
+#else
+void SystemInfo::updateProcessList()
+{
+    DIR *dir = opendir("/proc");
+    if (!dir) {
+        qWarning() << "Failed to read /proc";
+        return;
+    }
+    const int procFd = dirfd(dir);
+    const qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
+    const long pageKb = sysconf(_SC_PAGESIZE) / 1024;
+    // Rebuilt every tick, so exited processes drop out
+    QMap<qint64, ProcessCpuTimes> cpuTimes;
+    std::map<qint64, ProcessDiskIo> diskIo;
+
+    processList.clear();
+
+    char buffer[4096];
+    char path[64];
+    char exe[4096];
+    while (struct dirent *entry = readdir(dir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+            continue;
+        }
+        std::snprintf(path, sizeof(path), "%s/stat", entry->d_name);
+        int fd = openat(procFd, path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue;  // Exited between readdir and open
+        }
+        ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (length <= 0) {
+            continue;
+        }
+        buffer[length] = '\0';
+
+        // "pid (comm) state ..." - comm may contain spaces and parentheses
+        char *nameBegin = std::strchr(buffer, '(');
+        char *nameEnd = std::strrchr(buffer, ')');
+        if (!nameBegin || !nameEnd || nameEnd < nameBegin || nameEnd + 2 >= buffer + length) {
+            continue;
+        }
+
+        ProcessInfo proc;
+        proc.pid = std::strtoll(buffer, nullptr, 10);
+        const char state = nameEnd[2];
+        // Zombies have exited and wait for their parent to reap them
+        proc.status = state == 'Z' ? ProcessStatus::NotResponding : ProcessStatus::Running;
+
+        // Fields after the state: ppid is field 4, utime and stime 14 and
+        // 15, starttime 22 (ticks since boot) and rss 24 (pages)
+        char *p = nameEnd + 3;
+        quint64 utime = 0;
+        quint64 stime = 0;
+        for (int field = 4; field <= 24 && *p; ++field) {
+            char *next = nullptr;
+            long long value = std::strtoll(p, &next, 10);
+            if (next == p) break;
+            if (field == 4) proc.parentPid = value;
+            else if (field == 14) utime = quint64(value);
+            else if (field == 15) stime = quint64(value);
+            else if (field == 22) proc.startTime = value;
+            else if (field == 24) proc.memoryUsage = value * pageKb;
+            p = next;
+        }
+
+        // Kernel threads have no executable; they go by their comm
+        std::snprintf(path, sizeof(path), "%s/exe", entry->d_name);
+        ssize_t exeLength = readlinkat(procFd, path, exe, sizeof(exe));
+        if (exeLength > 0 && exeLength < ssize_t(sizeof(exe))) {
+            proc.pathId = internUtf8(strings, exe, int(exeLength));
+            proc.path = strings.string(proc.pathId);
+            const char *base = static_cast<const char *>(memrchr(exe, '/', size_t(exeLength)));
+            base = base ? base + 1 : exe;
+            proc.nameId = internUtf8(strings, base, int(exe + exeLength - base));
+        } else {
+            proc.nameId = internUtf8(strings, nameBegin + 1, int(nameEnd - nameBegin - 1));
+        }
+        proc.name = strings.string(proc.nameId);
+
+        // CPU over wall time since the last sample, as a share of all CPUs
+        const quint64 ticks = utime + stime;
+        ProcessCpuTimes &times = cpuTimes[proc.pid];
+        auto previous = processCpuTimesMap.constFind(proc.pid);
+        if (previous != processCpuTimesMap.constEnd() && currentTime > previous->lastSystemTime &&
+            ticks >= quint64(previous->lastUserTime + previous->lastKernelTime)) {
+            const double seconds = (ticks - quint64(previous->lastUserTime + previous->lastKernelTime)) / ticksPerSecond;
+            proc.cpuUsage = seconds / ((currentTime - previous->lastSystemTime) / 1000.0) / numProcessors * 100.0;
+        }
+        times.lastUserTime = qint64(utime);
+        times.lastKernelTime = qint64(stime);
+        times.lastSystemTime = currentTime;
+
+        // Storage I/O; readable for our own processes, or all of them as root
+        std::snprintf(path, sizeof(path), "%s/io", entry->d_name);
+        fd = openat(procFd, path, O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            char io[512];
+            ssize_t ioLength = read(fd, io, sizeof(io) - 1);
+            close(fd);
+            if (ioLength > 0) {
+                io[ioLength] = '\0';
+                const char *readField = std::strstr(io, "read_bytes:");
+                const char *writeField = std::strstr(io, "\nwrite_bytes:");
+                if (readField && writeField) {
+                    const quint64 readBytes = std::strtoull(readField + 11, nullptr, 10);
+                    const quint64 writeBytes = std::strtoull(writeField + 13, nullptr, 10);
+                    auto last = diskIoMap.find(proc.pid);
+                    if (last != diskIoMap.end() && currentTime > last->second.lastUpdateTime &&
+                        readBytes >= last->second.lastReadBytes && writeBytes >= last->second.lastWriteBytes) {
+                        const quint64 bytesDelta = (readBytes - last->second.lastReadBytes) + (writeBytes - last->second.lastWriteBytes);
+                        proc.diskUsage = (bytesDelta / 1048576.0) / ((currentTime - last->second.lastUpdateTime) / 1000.0);
+                    }
+                    ProcessDiskIo &current = diskIo[proc.pid];
+                    current.lastReadBytes = readBytes;
+                    current.lastWriteBytes = writeBytes;
+                    current.lastUpdateTime = currentTime;
+                }
+            }
+        }
+
+        // The type comes with the owner, read once per process
+        processList.append(proc);
+    }
+    closedir(dir);
+
+    processCpuTimesMap.swap(cpuTimes);
+    diskIoMap.swap(diskIo);
+}
+#endif
 
+#ifdef Q_OS_WIN
 void SystemInfo::initNetworkCounter()
 {
     PDH_STATUS status = PdhOpenQuery(NULL, 0, &networkQuery);
@@ -966,4 +1597,5 @@ void SystemInfo::initNetworkCounter()
     // Collect initial data
     PdhCollectQueryData(networkQuery);
     lastNetworkUpdateTime = QDateTime::currentMSecsSinceEpoch();
-} 
\ No newline at end of file
+} 
+#endif
@@ -5,11 +5,30 @@
 #include <QTimer>
 #include <QVector>
 #include <QMap>
+#include <QSet>
 #include <QDateTime>
+#ifdef Q_OS_WIN
 #include <windows.h>
 #include <psapi.h>
 #include <pdh.h>
+#endif
 #include "processcategorizer.h"
+#include "diskstatscollector.h"
+#include "cpustatscollector.h"
+#include "memorydetailengine.h"
+#include "pressurecollector.h"
+#include "processcolumns.h"
+#include "healthruleengine.h"
+#include "memorytrendestimator.h"
+#include "cpuanomalydetector.h"
+#include "processhistory.h"
+#include "processsparklines.h"
+#include "processgrouping.h"
+#include "cgroupbudgetmanager.h"
+#include "efficiencycontroller.h"
+#include "cputopology.h"
+#include "processscheduling.h"
+#include "stringinterner.h"
 #include <map>
 
 struct ProcessCpuTimes {
@@ -18,19 +37,50 @@ struct ProcessCpuTimes {
     qint64 lastUserTime = 0;
 };
 
+enum class ProcessStatus {
+    Unknown,        // No access to the process
+    Running,
+    NotResponding
+};
+
+QString processStatusText(ProcessStatus status);
+
 struct ProcessInfo {
+    // Name and path share the characters of SystemInfo's string table;
+    // the ids compare equal exactly when the strings do
     QString name;
-    qint64 pid;
-    double cpuUsage;  // CPU usage percentage for this process
-    qint64 memoryUsage;
-    double diskUsage;  // Disk I/O in MB/s
-    double networkUsage;  // Network I/O in MB/s
-    QString status;
+    StringInterner::Id nameId = 0;
+    qint64 pid = 0;
+    qint64 parentPid = 0;
+    // Owner and container, see ProcessOwnership; interned like name and path
+    QString user;
+    StringInterner::Id userId = 0;
+    QString container;
+    StringInterner::Id containerId = 0;
+    double cpuUsage = 0.0;  // CPU usage percentage for this process
+    double cpuBaseline = 0.0;  // Usual CPU usage, see CpuAnomalyDetector
+    double cpuZScore = 0.0;    // Standard deviations above the baseline
+    qint64 memoryUsage = 0;
+    // Memory breakdown in KB, see MemoryDetailEngine
+    qint64 pssKb = 0;         // Proportional set size (shared pages split between users)
+    qint64 ussKb = 0;         // Unique set size (private pages only)
+    qint64 swapKb = 0;        // -1 when not known (estimated rows)
+    qint64 anonHugeKb = 0;    // Anonymous transparent huge pages, -1 when not known
+    bool memoryDetailApproximate = true;  // Estimated from statm, not smaps_rollup
+    // Memory trend, see MemoryTrendEstimator
+    double memoryGrowthMBPerHour = 0.0;
+    double memoryTrendFit = 0.0;          // r^2 of the growth line, 1.0 = perfectly steady
+    bool memoryLeakSuspected = false;
+    qint64 memoryExhaustionSeconds = -1;  // Until available memory runs out at this rate
+    double diskUsage = 0.0;  // Disk I/O in MB/s
+    double networkUsage = 0.0;  // Network I/O in MB/s
+    ProcessStatus status = ProcessStatus::Unknown;
     QString path;     // Process executable path
-    qint64 startTime; // Process start time
-    ProcessType type;        // Process type (System, Background, Application)
-    QString typeDescription; // Human-readable type description
-    QString style;          // CSS style for visual differentiation
+    StringInterner::Id pathId = 0;
+    QString affinity; // Allowed CPUs as a cpulist, empty when all CPUs are allowed
+    SchedulingInfo scheduling;  // Nice, policy and I/O priority (Linux)
+    qint64 startTime = 0; // Process start time
+    ProcessType type = ProcessType::Unknown;        // Process type (System, Background, Application)
     // Rolling average buffers
     QVector<double> cpuUsageHistory;
     QVector<double> diskUsageHistory;
@@ -40,9 +90,35 @@ struct ProcessInfo {
     double networkUsageAvg = 0.0;
 };
 
+// Owner, container and type of a process, read once when it is first seen
+struct ProcessOwner {
+    qint64 startTime = 0;
+    ProcessType type = ProcessType::Unknown;
+    StringInterner::Id userId = 0;
+    StringInterner::Id containerId = 0;
+};
+
+// Priority to restore, and the process it belongs to
+struct OriginalPriority {
+    int priority = 0;
+    qint64 startTime = 0;
+};
+
+// Affinity as last read, see SystemInfo::updateProcessAffinity()
+struct CachedAffinity {
+    qint64 startTime = 0;
+    QString affinity;
+};
+
+// Scheduling as last read, see SystemInfo::updateProcessScheduling()
+struct CachedScheduling {
+    qint64 startTime = 0;
+    SchedulingInfo scheduling;
+};
+
 struct ProcessDiskIo {
-    ULONGLONG lastReadBytes = 0;
-    ULONGLONG lastWriteBytes = 0;
+    quint64 lastReadBytes = 0;
+    quint64 lastWriteBytes = 0;
     qint64 lastUpdateTime = 0;
 };
 
@@ -54,25 +130,60 @@ public:
     ~SystemInfo();
 
     QVector<ProcessInfo> getProcessList() const;
+    // Increases with every dataUpdated()
+    quint64 getSnapshotVersion() const { return snapshotVersion; }
     double getCpuUsage() const;
     double getMemoryUsage() const;
     double getDiskUsage() const;
     double getNetworkUsage() const;
+    qint64 getTotalMemoryKb() const { return totalMemoryKb; }
+    qint64 getAvailableMemoryKb() const { return availableMemoryKb; }
+    bool hasBlockDeviceStats() const { return diskStats.isAvailable(); }
+    QVector<BlockDeviceStats> getBlockDevices() const { return diskStats.devices(); }
+    int getBusiestBlockDevice() const { return diskStats.busiestDeviceIndex(); }
+    bool hasPerCoreStats() const { return cpuStats.isAvailable(); }
+    QVector<CpuCoreStats> getCpuCores() const { return cpuStats.cores(); }
+    double getCpuStealTime() const { return cpuStats.totalSteal(); }
+    bool hasMemoryDetail() const { return memoryDetail.isAvailable(); }
+    // The selected process is read in full every tick: exact memory
+    // detail and uncached affinity and scheduling
+    void setSelectedPid(qint64 pid) { selectedPid = pid; memoryDetail.setSelectedPid(pid); }
+    bool hasPressureStats() const { return pressure->isAvailable(); }
+    PressureStats getPressure(PressureResource resource) const { return pressure->systemPressure(resource); }
+    PressureStats getProcessPressure(qint64 pid, PressureResource resource) const;
+    const ProcessColumns& getProcessColumns() const { return processColumns; }
+    const HealthRuleEngine& getHealthRules() const { return healthRules; }
+    // CPU and memory history per row of getProcessColumns()
+    const ProcessHistory& getProcessHistory() const { return processHistory; }
+    // Last minute of samples per row of getProcessColumns(), for trend columns
+    const ProcessSparklines& getProcessSparklines() const { return processSparklines; }
+    // Groups by the chosen key, with totals kept per snapshot
+    const ProcessGrouping& getProcessGrouping() const { return processGrouping; }
+    void setGroupingKey(ProcessGrouping::Key key) { processGrouping.setKey(key, processColumns); }
     double getProcessCpuUsage(qint64 pid) const;
     bool terminateProcess(qint64 pid);
     bool forceTerminateProcess(qint64 pid);
     bool killProcessTree(qint64 pid);
     bool isProcessRunning(qint64 pid) const;
+    // pid still belongs to the process that started at startTime
+    bool isSameProcess(qint64 pid, qint64 startTime) const { return getProcessStartTime(pid) == startTime; }
     bool hasProcessAccess(qint64 pid) const;
 
     // Performance optimization
     void setUpdateInterval(int milliseconds);
 
     // Efficiency mode methods
+    // priority is a priority class on Windows and a nice value on Linux
     bool setProcessPriority(qint64 pid, int priority);
+    const CpuTopology& getCpuTopology() const { return cpuTopology; }
+    bool setProcessScheduling(const QVector<qint64> &pids, const SchedulingInfo &info);
+    bool setProcessAffinity(qint64 pid, const QVector<int> &cpus, bool includeDescendants, QString *error = nullptr);
     bool optimizeBackgroundProcesses();
     bool optimizeMemoryUsage();
     bool throttleNonEssentialProcesses();
+    QVector<EfficiencyController::Throttle> getEfficiencyThrottles() const { return efficiencyController.activeThrottles(); }
+    const CgroupBudgetManager& getBudgetManager() const { return budgetManager; }
+    void setEfficiencyBudget(const EfficiencyBudget &budget) { budgetManager.setBudget(budget); }
     QVector<ProcessInfo> getHighResourceProcesses() const;
     bool isEfficiencyModeEnabled() const { return efficiencyModeEnabled; }
     void setEfficiencyMode(bool enabled);
@@ -80,6 +191,7 @@ public:
 signals:
     void dataUpdated();
     void efficiencyModeChanged(bool enabled);
+    void pressureStallDetected(PressureResource resource, const QString &description);
 
 private slots:
     void updateSystemInfo();
@@ -93,9 +205,33 @@ private:
     double networkUsage;
     int numProcessors;
     qint64 lastSystemTime;
+    quint64 snapshotVersion;
     QMap<qint64, ProcessCpuTimes> processCpuTimesMap;
     std::map<qint64, ProcessDiskIo> diskIoMap;
+    DiskStatsCollector diskStats;
+    CpuStatsCollector cpuStats;
+    MemoryDetailEngine memoryDetail;
+    PressureCollector *pressure;
+    ProcessColumns processColumns;
+    QVector<qint32> totalGroup;  // Every row in group 0, for whole-column totals
+    HealthRuleEngine healthRules;
+    MemoryTrendEstimator memoryTrend;
+    CpuAnomalyDetector cpuAnomaly;
+    ProcessHistory processHistory;
+    ProcessSparklines processSparklines;
+    StringInterner strings;
+    ProcessGrouping processGrouping;
+    QHash<qint64, ProcessOwner> ownerCache;         // By pid
+    QHash<qint64, StringInterner::Id> userNames;    // By uid
+    QHash<QByteArray, StringInterner::Id> sidNames; // By SID, Windows
+    QHash<qint64, CachedAffinity> affinityCache;    // By pid
+    QHash<qint64, CachedScheduling> schedulingCache;    // By pid
+    qint64 selectedPid;
+    CpuTopology cpuTopology;
+    qint64 totalMemoryKb;
+    qint64 availableMemoryKb;
 
+#ifdef Q_OS_WIN
     // CPU monitoring
     PDH_HQUERY cpuQuery;
     PDH_HCOUNTER cpuCounter;
@@ -104,14 +240,20 @@ private:
     PDH_HQUERY networkQuery;
     PDH_HCOUNTER bytesReceivedCounter;
     PDH_HCOUNTER bytesSentCounter;
+#else
+    double ticksPerSecond;     // Of utime and stime in /proc/[pid]/stat
+#endif
     double lastBytesReceived;
     double lastBytesSent;
     qint64 lastNetworkUpdateTime;
     
     // Efficiency mode members
     bool efficiencyModeEnabled;
-    QVector<qint64> throttledProcesses;
-    QMap<qint64, int> originalPriorities;
+    QSet<qint64> throttledProcesses;
+    EfficiencyController efficiencyController;
+    QVector<quint8> efficiencyEligible;
+    QMap<qint64, OriginalPriority> originalPriorities;
+    CgroupBudgetManager budgetManager;
     
     void initializeCpuCounter();
     void updateProcessList();
@@ -119,24 +261,35 @@ private:
     void updateMemoryUsage();
     void updateDiskUsage();
     void updateNetworkUsage();
+    void updateProcessAffinity();
+    void updateProcessScheduling();
+    void updateProcessOwnership();
     void updateProcessCpuUsage();
     void initializeProcessCpuCounter(qint64 pid);
+#ifdef Q_OS_WIN
     void initCpuCounter();
     void initNetworkCounter();
+#endif
     void removeProcessFromList(qint64 pid);
 
     // Efficiency mode helper methods
     void restoreOriginalPriorities();
+    bool restorePriority(qint64 pid, const OriginalPriority &original);
+    qint64 getProcessStartTime(qint64 pid) const;
     bool isProcessEssential(const ProcessInfo& process) const;
     int getProcessPriorityClass(qint64 pid) const;
     void applyEfficiencyModeSettings();
     void removeEfficiencyModeSettings();
+    bool throttleProcess(qint64 pid);
+    bool releaseProcess(qint64 pid);
 
     // Helper methods for process termination
+    QVector<qint64> getChildProcesses(qint64 parentPid) const;
+#ifdef Q_OS_WIN
     bool enableDebugPrivilege();
     bool terminateProcessWithPrivilege(qint64 pid);
-    QVector<qint64> getChildProcesses(qint64 parentPid) const;
     bool killProcessWithHandle(HANDLE hProcess);
+#endif
 };
 
 #endif // SYSTEMINFO_H 
\ No newline at end of file
@@ -0,0 +1,273 @@
+#include "threadpanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QComboBox>
+#include <QTableView>
+#include <QHeaderView>
+#include <QColor>
+#include <QHash>
+#include <algorithm>
+
+namespace {
+
+enum ThreadColumn {
+    TidColumn,
+    NameColumn,
+    StateColumn,
+    CpuColumn,
+    ProcessorColumn,
+    ThreadColumnCount
+};
+
+QString stateText(char state)
+{
+    switch (state) {
+    case 'R': return "Running";
+    case 'S': return "Sleeping";
+    case 'D': return "Disk wait";
+    case 'Z': return "Zombie";
+    case 'T': return "Stopped";
+    case 't': return "Traced";
+    case 'I': return "Idle";
+    default: return QString(QChar(state));
+    }
+}
+
+} // namespace
+
+ThreadTableModel::ThreadTableModel(QObject *parent) : QAbstractTableModel(parent),
+    sortColumn(CpuColumn),
+    sortOrder(Qt::DescendingOrder)
+{
+}
+
+void ThreadTableModel::setThreads(const QVector<ThreadSample> &threads)
+{
+    // Rows are updated in place, matched by tid, so the selection and the
+    // current row stay on their thread. A reset on every sample would drop
+    // them and relayout every row.
+    QHash<qint64, int> sampleOfTid;
+    sampleOfTid.reserve(threads.size());
+    for (int index = 0; index < threads.size(); ++index) {
+        sampleOfTid.insert(threads[index].tid, index);
+    }
+
+    // Exited threads, a contiguous run at a time from the bottom up
+    for (int last = rows.size() - 1; last >= 0; ) {
+        if (sampleOfTid.contains(rows[last].tid)) {
+            --last;
+            continue;
+        }
+        int first = last;
+        while (first > 0 && !sampleOfTid.contains(rows[first - 1].tid)) {
+            --first;
+        }
+        beginRemoveRows(QModelIndex(), first, last);
+        rows.remove(first, last - first + 1);
+        endRemoveRows();
+        last = first - 1;
+    }
+
+    // Continuing threads take their new values; the rest are new
+    QVector<quint8> continuing(threads.size(), 0);
+    for (ThreadSample &thread : rows) {
+        const int index = sampleOfTid.value(thread.tid);
+        thread = threads[index];
+        continuing[index] = 1;
+    }
+    const int added = int(std::count(continuing.cbegin(), continuing.cend(), quint8(0)));
+    if (added > 0) {
+        beginInsertRows(QModelIndex(), rows.size(), rows.size() + added - 1);
+        for (int index = 0; index < threads.size(); ++index) {
+            if (!continuing[index]) {
+                rows.append(threads[index]);
+            }
+        }
+        endInsertRows();
+    }
+
+    reorder();
+    if (!rows.isEmpty()) {
+        emit dataChanged(index(0, 0), index(rows.size() - 1, ThreadColumnCount - 1));
+    }
+}
+
+int ThreadTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int ThreadTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ThreadColumnCount;
+}
+
+QVariant ThreadTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows.size()) {
+        return QVariant();
+    }
+    const ThreadSample &thread = rows[index.row()];
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case TidColumn: return thread.tid;
+        case NameColumn: return thread.name;
+        case StateColumn: return stateText(thread.state);
+        case CpuColumn: return QString::number(thread.cpuUsage, 'f', 1) + "%";
+        case ProcessorColumn: return thread.processor >= 0 ? QVariant(thread.processor) : QVariant("-");
+        }
+    } else if (role == Qt::ForegroundRole && index.column() == CpuColumn) {
+        // Same bands as the process table, relative to one core
+        if (thread.cpuUsage >= 80.0) return QColor("#FF4444");
+        if (thread.cpuUsage >= 50.0) return QColor("#FFA500");
+        if (thread.cpuUsage >= 20.0) return QColor("#FFD700");
+        return QColor("#4CAF50");
+    } else if (role == Qt::TextAlignmentRole && index.column() != NameColumn) {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    return QVariant();
+}
+
+QVariant ThreadTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (section) {
+    case TidColumn: return "TID";
+    case NameColumn: return "Name";
+    case StateColumn: return "State";
+    case CpuColumn: return "CPU (% of core)";
+    case ProcessorColumn: return "Last CPU";
+    }
+    return QVariant();
+}
+
+void ThreadTableModel::sort(int column, Qt::SortOrder order)
+{
+    sortColumn = column;
+    sortOrder = order;
+    reorder();
+}
+
+void ThreadTableModel::reorder()
+{
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+    // Selection and current index are persistent; move them with their thread
+    const QModelIndexList before = persistentIndexList();
+    QVector<qint64> tids;
+    tids.reserve(before.size());
+    for (const QModelIndex &index : before) {
+        tids.append(rows[index.row()].tid);
+    }
+    sortRows();
+    if (!before.isEmpty()) {
+        QHash<qint64, int> rowOfTid;
+        rowOfTid.reserve(rows.size());
+        for (int row = 0; row < rows.size(); ++row) {
+            rowOfTid.insert(rows[row].tid, row);
+        }
+        QModelIndexList after;
+        after.reserve(before.size());
+        for (int i = 0; i < before.size(); ++i) {
+            after.append(index(rowOfTid.value(tids[i]), before[i].column()));
+        }
+        changePersistentIndexList(before, after);
+    }
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+}
+
+void ThreadTableModel::sortRows()
+{
+    int column = sortColumn;
+    auto less = [column](const ThreadSample &a, const ThreadSample &b) {
+        switch (column) {
+        case NameColumn: return a.name < b.name;
+        case StateColumn: return a.state < b.state;
+        case CpuColumn: return a.cpuUsage < b.cpuUsage;
+        case ProcessorColumn: return a.processor < b.processor;
+        default: return a.tid < b.tid;
+        }
+    };
+    if (sortOrder == Qt::AscendingOrder) {
+        std::stable_sort(rows.begin(), rows.end(), less);
+    } else {
+        std::stable_sort(rows.begin(), rows.end(), [&less](const ThreadSample &a, const ThreadSample &b) {
+            return less(b, a);
+        });
+    }
+}
+
+ThreadPanel::ThreadPanel(QWidget *parent) : QWidget(parent),
+    sampler(new ThreadSampler(this)),
+    model(new ThreadTableModel(this)),
+    titleLabel(nullptr),
+    intervalSelect(nullptr),
+    view(nullptr)
+{
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(16, 8, 16, 8);
+
+    QHBoxLayout *headerLayout = new QHBoxLayout();
+    titleLabel = new QLabel("Threads: select a process");
+    titleLabel->setStyleSheet("color:#b0b0b0;font-weight:bold;font-size:14px;");
+    intervalSelect = new QComboBox();
+    intervalSelect->addItem("Sample every 1 s", 1000);
+    intervalSelect->addItem("Sample every 500 ms", 500);
+    intervalSelect->addItem("Sample every 250 ms", 250);
+    intervalSelect->addItem("Sample every 100 ms", 100);
+    headerLayout->addWidget(titleLabel);
+    headerLayout->addStretch();
+    headerLayout->addWidget(intervalSelect);
+    layout->addLayout(headerLayout);
+
+    view = new QTableView();
+    view->setModel(model);
+    view->setSortingEnabled(true);
+    view->sortByColumn(CpuColumn, Qt::DescendingOrder);
+    view->setSelectionBehavior(QAbstractItemView::SelectRows);
+    view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    view->verticalHeader()->setVisible(false);
+    // Fixed row height keeps layout O(visible rows) with thousands of threads
+    view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    view->verticalHeader()->setDefaultSectionSize(22);
+    view->horizontalHeader()->setStretchLastSection(true);
+    view->setStyleSheet("QTableView { background: #181818; color: #fff; border: none; }");
+    layout->addWidget(view);
+
+    connect(intervalSelect, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+        sampler->setInterval(intervalSelect->itemData(index).toInt());
+    });
+    connect(sampler, &ThreadSampler::sampled, this, &ThreadPanel::onSampled);
+}
+
+void ThreadPanel::setProcess(qint64 pid, const QString &name)
+{
+    processName = name;
+    sampler->setPid(pid);
+    titleLabel->setText(QString("Threads: %1 (PID %2)").arg(name).arg(pid));
+}
+
+void ThreadPanel::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    sampler->start();
+}
+
+void ThreadPanel::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    sampler->stop();
+    model->setThreads(QVector<ThreadSample>());
+}
+
+void ThreadPanel::onSampled()
+{
+    const QVector<ThreadSample> &threads = sampler->threads();
+    model->setThreads(threads);
+    if (sampler->pid() > 0) {
+        titleLabel->setText(QString("Threads: %1 (PID %2) - %3 threads")
+            .arg(processName).arg(sampler->pid()).arg(threads.size()));
+    }
+}
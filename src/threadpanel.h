@@ -0,0 +1,66 @@
+#ifndef THREADPANEL_H
+#define THREADPANEL_H
+
+#include <QWidget>
+#include <QAbstractTableModel>
+#include "threadsampler.h"
+
+QT_BEGIN_NAMESPACE
+class QLabel;
+class QComboBox;
+class QTableView;
+QT_END_NAMESPACE
+
+// Table model over the latest thread sample. Sorting is done on the sample
+// vector itself so processes with thousands of threads need no proxy model.
+// Samples are merged by tid rather than reset, see setThreads().
+class ThreadTableModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    explicit ThreadTableModel(QObject *parent = nullptr);
+
+    void setThreads(const QVector<ThreadSample> &threads);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+private:
+    QVector<ThreadSample> rows;
+    int sortColumn;
+    Qt::SortOrder sortOrder;
+
+    void sortRows();
+    // Sorts rows with a layout change that keeps persistent indexes
+    void reorder();
+};
+
+// Per-process thread drilldown shown below the process table
+class ThreadPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit ThreadPanel(QWidget *parent = nullptr);
+
+    void setProcess(qint64 pid, const QString &name);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void onSampled();
+
+private:
+    ThreadSampler *sampler;
+    ThreadTableModel *model;
+    QLabel *titleLabel;
+    QComboBox *intervalSelect;
+    QTableView *view;
+    QString processName;
+};
+
+#endif // THREADPANEL_H
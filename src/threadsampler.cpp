@@ -0,0 +1,162 @@
+#include "threadsampler.h"
+#include <QTimer>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifdef Q_OS_UNIX
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+ThreadSampler::ThreadSampler(QObject *parent) : QObject(parent),
+    timer(new QTimer(this)),
+    targetPid(-1),
+    ticksPerSecond(100.0),
+    lastSampleMs(0)
+{
+#ifdef Q_OS_UNIX
+    ticksPerSecond = static_cast<double>(sysconf(_SC_CLK_TCK));
+#endif
+    timer->setInterval(1000);
+    connect(timer, &QTimer::timeout, this, &ThreadSampler::sample);
+    clock.start();
+}
+
+void ThreadSampler::setPid(qint64 pid)
+{
+    if (pid == targetPid) {
+        return;
+    }
+    targetPid = pid;
+    previous.clear();
+    samples.clear();
+    if (isRunning()) {
+        sample();
+    }
+}
+
+void ThreadSampler::setInterval(int milliseconds)
+{
+    timer->setInterval(milliseconds);
+}
+
+void ThreadSampler::start()
+{
+    if (!timer->isActive()) {
+        previous.clear();
+        timer->start();
+        sample();
+    }
+}
+
+void ThreadSampler::stop()
+{
+    timer->stop();
+    // Drop per-thread state; a process with thousands of threads should not
+    // keep memory around while nobody is looking
+    previous = QHash<qint64, PreviousTicks>();
+    current = QHash<qint64, PreviousTicks>();
+    samples = QVector<ThreadSample>();
+}
+
+bool ThreadSampler::isRunning() const
+{
+    return timer->isActive();
+}
+
+void ThreadSampler::sample()
+{
+    samples.resize(0);
+    current.clear();
+    if (targetPid <= 0) {
+        emit sampled();
+        return;
+    }
+
+    qint64 nowMs = clock.elapsed();
+    double elapsedSec = (nowMs - lastSampleMs) / 1000.0;
+    lastSampleMs = nowMs;
+
+#ifdef Q_OS_UNIX
+    char taskPath[64];
+    std::snprintf(taskPath, sizeof(taskPath), "/proc/%lld/task", static_cast<long long>(targetPid));
+    DIR *dir = opendir(taskPath);
+    if (!dir) {
+        emit sampled();
+        return;
+    }
+    int dirFd = dirfd(dir);
+    current.reserve(previous.size());
+    samples.reserve(previous.size());
+
+    char buffer[1024];
+    char statPath[64];
+    while (struct dirent *entry = readdir(dir)) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+            continue;
+        }
+        std::snprintf(statPath, sizeof(statPath), "%s/stat", entry->d_name);
+        int fd = openat(dirFd, statPath, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue;  // Thread exited between readdir and open
+        }
+        ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (length <= 0) {
+            continue;
+        }
+        buffer[length] = '\0';
+
+        // "tid (comm) state ..." - comm may contain spaces and parentheses
+        char *nameBegin = std::strchr(buffer, '(');
+        char *nameEnd = std::strrchr(buffer, ')');
+        if (!nameBegin || !nameEnd || nameEnd < nameBegin || nameEnd + 2 >= buffer + length) {
+            continue;
+        }
+
+        ThreadSample thread;
+        thread.tid = std::strtoll(buffer, nullptr, 10);
+        thread.state = nameEnd[2];
+
+        // Fields after the state: ppid pgrp session tty tpgid flags minflt
+        // cminflt majflt cmajflt utime stime ... processor is field 39
+        char *p = nameEnd + 3;
+        quint64 utime = 0;
+        quint64 stime = 0;
+        for (int field = 4; field <= 39 && *p; ++field) {
+            char *next = nullptr;
+            unsigned long long value = std::strtoull(p, &next, 10);
+            if (next == p) break;
+            if (field == 14) utime = value;
+            else if (field == 15) stime = value;
+            else if (field == 39) thread.processor = static_cast<int>(value);
+            p = next;
+        }
+
+        PreviousTicks &state = current[thread.tid];
+        state.ticks = utime + stime;
+        QByteArray rawName = QByteArray::fromRawData(nameBegin + 1, static_cast<int>(nameEnd - nameBegin - 1));
+        auto prev = previous.constFind(thread.tid);
+        if (prev != previous.constEnd()) {
+            if (elapsedSec > 0.0 && state.ticks >= prev->ticks) {
+                thread.cpuUsage = (state.ticks - prev->ticks) / ticksPerSecond / elapsedSec * 100.0;
+            }
+            if (prev->rawName == rawName) {
+                state.rawName = prev->rawName;
+                state.name = prev->name;
+            }
+        }
+        if (state.name.isNull()) {
+            state.rawName = QByteArray(rawName.constData(), rawName.size());
+            state.name = QString::fromUtf8(state.rawName);
+        }
+        thread.name = state.name;
+        samples.append(thread);
+    }
+    closedir(dir);
+#endif
+
+    previous.swap(current);
+    emit sampled();
+}
@@ -0,0 +1,60 @@
+#ifndef THREADSAMPLER_H
+#define THREADSAMPLER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class QTimer;
+
+struct ThreadSample {
+    qint64 tid = 0;
+    QString name;
+    char state = '?';        // R, S, D, Z, T, ... as in /proc/[pid]/task/[tid]/stat
+    int processor = -1;      // CPU the thread last ran on
+    double cpuUsage = 0.0;   // Percent of one core over the last interval
+};
+
+// Samples /proc/[pid]/task/*/stat for a single process. It does no work
+// unless started, so the owning panel only pays while it is visible.
+class ThreadSampler : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ThreadSampler(QObject *parent = nullptr);
+
+    void setPid(qint64 pid);
+    qint64 pid() const { return targetPid; }
+    void setInterval(int milliseconds);
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    const QVector<ThreadSample>& threads() const { return samples; }
+
+signals:
+    void sampled();
+
+private slots:
+    void sample();
+
+private:
+    struct PreviousTicks {
+        quint64 ticks = 0;
+        QString name;   // Thread names rarely change, reuse the decoded string
+        QByteArray rawName;
+    };
+
+    QTimer *timer;
+    qint64 targetPid;
+    double ticksPerSecond;
+    QElapsedTimer clock;
+    qint64 lastSampleMs;
+    QHash<qint64, PreviousTicks> previous;
+    QHash<qint64, PreviousTicks> current;
+    QVector<ThreadSample> samples;
+};
+
+#endif // THREADSAMPLER_H
@@ -0,0 +1,204 @@
+// Round trips and windowed reads of CompressedSeries, and the size of the
+// tiers ProcessHistory keeps per process.
+
+#include "compressedseries.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const char *what)
+{
+    if (!condition) {
+        std::fprintf(stderr, "FAIL: %s\n", what);
+        ++failures;
+    }
+}
+
+bool sameBits(double a, double b)
+{
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+struct Sample {
+    qint64 time;
+    double values[2];
+};
+
+// A day at about 1 s with jitter, occasional gaps and awkward values
+std::vector<Sample> makeDay(std::mt19937 &rng)
+{
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<Sample> samples;
+    qint64 time = 1700000000000;
+    double cpu = 5.0;
+    double memory = 200000.0;
+    for (int i = 0; i < 86400; ++i) {
+        time += 1000 + qint64(rng() % 21) - 10;
+        if (rng() % 5000 == 0) {
+            time += 3600000;    // Suspend: a large delta of delta
+        }
+        cpu = std::max(0.0, cpu + noise(rng));
+        memory += double(rng() % 64);
+        Sample sample{time, {std::round(cpu * 64.0) / 64.0, memory}};
+        switch (i % 10007) {
+        case 1: sample.values[0] = std::numeric_limits<double>::quiet_NaN(); break;
+        case 2: sample.values[0] = -0.0; break;
+        case 3: sample.values[1] = std::numeric_limits<double>::infinity(); break;
+        case 4: sample.values[1] = std::numeric_limits<double>::denorm_min(); break;
+        default: break;
+        }
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+void testRoundTrip(const std::vector<Sample> &samples, const CompressedSeries &series)
+{
+    check(series.sampleCount() == int(samples.size()), "every sample is kept");
+    CompressedSeries::Cursor cursor = series.cursor();
+    qint64 time = 0;
+    double values[2];
+    size_t index = 0;
+    bool exact = true;
+    while (cursor.next(time, values)) {
+        if (index >= samples.size() || time != samples[index].time
+            || !sameBits(values[0], samples[index].values[0]) || !sameBits(values[1], samples[index].values[1])) {
+            exact = false;
+            break;
+        }
+        ++index;
+    }
+    check(exact && index == samples.size(), "sequential decode returns every sample bit for bit");
+}
+
+void testWindows(const std::vector<Sample> &samples, const CompressedSeries &series, std::mt19937 &rng)
+{
+    const qint64 first = samples.front().time;
+    const qint64 span = samples.back().time - first;
+    bool exact = true;
+    for (int window = 0; window < 200 && exact; ++window) {
+        qint64 from = first - 5000 + qint64(rng() % quint64(span + 10000));
+        qint64 to = from + qint64(rng() % 7200000);
+        if (window == 0) {
+            from = first;
+            to = samples.back().time;
+        }
+        QVector<qint64> timestamps;
+        QVector<double> values;
+        const int column = window % 2;
+        series.decode(from, to, timestamps, values, column);
+        int index = 0;
+        for (const Sample &sample : samples) {
+            if (sample.time < from || sample.time > to) {
+                continue;
+            }
+            if (index >= timestamps.size() || timestamps[index] != sample.time
+                || !sameBits(values[index], sample.values[column])) {
+                exact = false;
+                break;
+            }
+            ++index;
+        }
+        exact = exact && index == timestamps.size();
+    }
+    check(exact, "windowed decode returns exactly the samples in the window");
+
+    QVector<qint64> timestamps;
+    QVector<double> values;
+    series.decode(first, samples.back().time, timestamps, values, 2);
+    check(timestamps.isEmpty(), "a column the series does not have decodes to nothing");
+}
+
+void testOrderAndRetention(std::mt19937 &rng)
+{
+    CompressedSeries series(2);
+    double values[2] = {1.0, 2.0};
+    check(series.append(1000, values), "first sample is accepted");
+    check(series.append(1000, values), "a repeated timestamp is accepted");
+    check(!series.append(999, values), "a timestamp going backwards is rejected");
+    check(series.sampleCount() == 2, "a rejected sample is not counted");
+
+    series.clear();
+    std::vector<qint64> times;
+    for (qint64 time = 0; time < 3600000; time += 1000) {
+        values[0] = double(rng() % 1000);
+        series.append(time, values);
+        times.push_back(time);
+    }
+    const qint64 cutoff = 1800000;
+    series.dropBefore(cutoff);
+    check(series.firstTimestamp() <= cutoff, "only blocks that end before the cutoff are dropped");
+    QVector<qint64> timestamps;
+    QVector<double> decoded;
+    series.decode(cutoff, times.back(), timestamps, decoded);
+    check(timestamps.size() == int((times.back() - cutoff) / 1000 + 1), "every sample after the cutoff survives");
+    series.dropBefore(times.back() + 1);
+    check(series.isEmpty() && series.sampleCount() == 0, "dropping past the end empties the series");
+}
+
+// ProcessHistory keeps an hour at 1 s and the rest of a day per minute;
+// its documented per-process cost must hold
+void testTierSize(std::mt19937 &rng)
+{
+    std::normal_distribution<double> noise(0.0, 1.0);
+    for (int busy = 0; busy < 2; ++busy) {
+        CompressedSeries hour(2);
+        CompressedSeries minutes(2);
+        double cpu = 5.0;
+        double memory = 200000.0;
+        qint64 time = 0;
+        for (int i = 0; i < 86400; ++i) {
+            time += 1000 + qint64(rng() % 21) - 10;
+            if (busy) {
+                cpu = std::max(0.0, cpu + noise(rng));
+                memory += double(rng() % 64);
+            } else {
+                cpu = rng() % 50 == 0 ? 0.5 : 0.0;
+            }
+            double values[2] = {std::round(cpu * 64.0) / 64.0, memory};
+            hour.append(time, values);
+            hour.dropBefore(time - 3600000);
+            if (i % 60 == 0) {
+                minutes.append(time, values);
+            }
+        }
+        const qint64 bytes = hour.memoryBytes() + minutes.memoryBytes();
+        std::printf("%s process, one day: %lld bytes\n", busy ? "Busy" : "Idle", (long long)bytes);
+        check(bytes < (busy ? 64 * 1024 : 16 * 1024), "a day of history stays within its budget");
+    }
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 rng(12345);
+    const std::vector<Sample> samples = makeDay(rng);
+    CompressedSeries series(2);
+    for (const Sample &sample : samples) {
+        if (!series.append(sample.time, sample.values)) {
+            check(false, "in-order samples are accepted");
+            break;
+        }
+    }
+    std::printf("%d samples in %lld bytes\n", series.sampleCount(), (long long)series.memoryBytes());
+
+    testRoundTrip(samples, series);
+    testWindows(samples, series, rng);
+    testOrderAndRetention(rng);
+    testTierSize(rng);
+
+    if (failures > 0) {
+        std::fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}
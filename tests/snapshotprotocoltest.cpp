@@ -0,0 +1,127 @@
+// Races SnapshotWriter against reader threads: every snapshot a reader
+// accepts must be exactly one published snapshot, never a mix of two.
+
+#include "snapshotreader.h"
+#include "snapshotwriter.h"
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+const uint32_t CAPACITY = 256;
+const int READERS = 4;
+const uint64_t SNAPSHOTS = 20000;
+
+// FNV-1a over the process records
+int64_t checksum(const snapshot::Process *processes, uint32_t count)
+{
+    uint64_t hash = 14695981039346656037ull;
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(processes);
+    for (size_t i = 0; i < count * sizeof(snapshot::Process); ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return int64_t(hash);
+}
+
+struct ReaderResult {
+    uint64_t consistent = 0;
+    uint64_t failures = 0;
+};
+
+void readUntilDone(const std::string &name, const std::atomic<bool> &done, ReaderResult &result)
+{
+    SnapshotReader reader;
+    if (!reader.open(name)) {
+        ++result.failures;
+        return;
+    }
+    uint64_t lastGeneration = 0;
+    while (!done.load(std::memory_order_acquire)) {
+        uint64_t generation = 0;
+        uint32_t count = 0;
+        bool headerMatches = false;
+        bool payloadMatches = false;
+        // Only the last, validated visit counts
+        bool ok = reader.read([&](const SnapshotReader::View &view) {
+            generation = view.header->generation;
+            count = view.processCount;
+            headerMatches = view.header->timestampMs == checksum(view.processes, count)
+                && count == uint32_t(generation % CAPACITY) + 1;
+            payloadMatches = true;
+            for (uint32_t row = 0; row < count; ++row) {
+                if (view.processes[row].pid != int64_t(generation) || view.processes[row].startTime != int64_t(row)) {
+                    payloadMatches = false;
+                }
+            }
+        }, 1 << 20);
+        if (!ok) {
+            continue;   // Nothing published yet, or the writer kept lapping us
+        }
+        if (!headerMatches || !payloadMatches || generation < lastGeneration) {
+            std::fprintf(stderr, "Torn snapshot: generation %llu after %llu, %u processes, header %s, payload %s\n",
+                         (unsigned long long)generation, (unsigned long long)lastGeneration, count,
+                         headerMatches ? "ok" : "mismatch", payloadMatches ? "ok" : "mismatch");
+            ++result.failures;
+        } else {
+            ++result.consistent;
+        }
+        lastGeneration = generation;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    const std::string name = "/procmanager-test-" + std::to_string(getpid());
+    SnapshotWriter writer;
+    std::string error;
+    if (!writer.open(name, CAPACITY, &error)) {
+        std::fprintf(stderr, "Failed to open segment: %s\n", error.c_str());
+        return 1;
+    }
+
+    std::atomic<bool> done(false);
+    std::vector<ReaderResult> results(READERS);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < READERS; ++i) {
+        readers.emplace_back(readUntilDone, name, std::cref(done), std::ref(results[i]));
+    }
+
+    for (uint64_t n = 0; n < SNAPSHOTS; ++n) {
+        snapshot::SlotHeader *slot = writer.beginWrite();
+        const uint64_t generation = slot->generation;
+        const uint32_t count = uint32_t(generation % CAPACITY) + 1;
+        snapshot::Process *processes = snapshot::processesOf(slot);
+        for (uint32_t row = 0; row < count; ++row) {
+            processes[row] = snapshot::Process{};
+            processes[row].pid = int64_t(generation);
+            processes[row].startTime = int64_t(row);
+            processes[row].cpuUsage = double(row);
+        }
+        slot->processCount = count;
+        slot->truncated = 0;
+        slot->timestampMs = checksum(processes, count);
+        writer.publish();
+    }
+    // Let every reader see the final snapshot at least once more
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    done.store(true, std::memory_order_release);
+    for (std::thread &reader : readers) {
+        reader.join();
+    }
+
+    int status = 0;
+    for (int i = 0; i < READERS; ++i) {
+        std::printf("Reader %d: %llu consistent snapshots, %llu failures\n", i,
+                    (unsigned long long)results[i].consistent, (unsigned long long)results[i].failures);
+        if (results[i].failures > 0 || results[i].consistent == 0) {
+            status = 1;
+        }
+    }
+    return status;
+}